@@ -0,0 +1,25 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tests/mock/src/mock-callback.c" "CMakeFiles/obs-mock.dir/mock/src/mock-callback.c.o" "gcc" "CMakeFiles/obs-mock.dir/mock/src/mock-callback.c.o.d"
+  "/root/repo/tests/mock/src/mock-data.c" "CMakeFiles/obs-mock.dir/mock/src/mock-data.c.o" "gcc" "CMakeFiles/obs-mock.dir/mock/src/mock-data.c.o.d"
+  "/root/repo/tests/mock/src/mock-graphics.c" "CMakeFiles/obs-mock.dir/mock/src/mock-graphics.c.o" "gcc" "CMakeFiles/obs-mock.dir/mock/src/mock-graphics.c.o.d"
+  "/root/repo/tests/mock/src/mock-media.c" "CMakeFiles/obs-mock.dir/mock/src/mock-media.c.o" "gcc" "CMakeFiles/obs-mock.dir/mock/src/mock-media.c.o.d"
+  "/root/repo/tests/mock/src/mock-properties.c" "CMakeFiles/obs-mock.dir/mock/src/mock-properties.c.o" "gcc" "CMakeFiles/obs-mock.dir/mock/src/mock-properties.c.o.d"
+  "/root/repo/tests/mock/src/mock-source.c" "CMakeFiles/obs-mock.dir/mock/src/mock-source.c.o" "gcc" "CMakeFiles/obs-mock.dir/mock/src/mock-source.c.o.d"
+  "/root/repo/tests/mock/src/mock-util.c" "CMakeFiles/obs-mock.dir/mock/src/mock-util.c.o" "gcc" "CMakeFiles/obs-mock.dir/mock/src/mock-util.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
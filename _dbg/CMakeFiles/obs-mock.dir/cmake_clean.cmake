@@ -0,0 +1,23 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/obs-mock.dir/mock/src/mock-callback.c.o"
+  "CMakeFiles/obs-mock.dir/mock/src/mock-callback.c.o.d"
+  "CMakeFiles/obs-mock.dir/mock/src/mock-data.c.o"
+  "CMakeFiles/obs-mock.dir/mock/src/mock-data.c.o.d"
+  "CMakeFiles/obs-mock.dir/mock/src/mock-graphics.c.o"
+  "CMakeFiles/obs-mock.dir/mock/src/mock-graphics.c.o.d"
+  "CMakeFiles/obs-mock.dir/mock/src/mock-media.c.o"
+  "CMakeFiles/obs-mock.dir/mock/src/mock-media.c.o.d"
+  "CMakeFiles/obs-mock.dir/mock/src/mock-properties.c.o"
+  "CMakeFiles/obs-mock.dir/mock/src/mock-properties.c.o.d"
+  "CMakeFiles/obs-mock.dir/mock/src/mock-source.c.o"
+  "CMakeFiles/obs-mock.dir/mock/src/mock-source.c.o.d"
+  "CMakeFiles/obs-mock.dir/mock/src/mock-util.c.o"
+  "CMakeFiles/obs-mock.dir/mock/src/mock-util.c.o.d"
+  "libobs-mock.a"
+  "libobs-mock.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/obs-mock.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
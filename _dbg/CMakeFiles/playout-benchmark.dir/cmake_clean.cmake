@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/playout-benchmark.dir/benchmark.c.o"
+  "CMakeFiles/playout-benchmark.dir/benchmark.c.o.d"
+  "playout-benchmark"
+  "playout-benchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/playout-benchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
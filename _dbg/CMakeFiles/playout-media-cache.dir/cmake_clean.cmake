@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/playout-media-cache.dir/media-cache.c.o"
+  "CMakeFiles/playout-media-cache.dir/media-cache.c.o.d"
+  "playout-media-cache"
+  "playout-media-cache.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/playout-media-cache.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,35 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/as-run.c" "CMakeFiles/playout-plugin.dir/root/repo/as-run.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/as-run.c.o.d"
+  "/root/repo/audio-wrapper.c" "CMakeFiles/playout-plugin.dir/root/repo/audio-wrapper.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/audio-wrapper.c.o.d"
+  "/root/repo/filler.c" "CMakeFiles/playout-plugin.dir/root/repo/filler.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/filler.c.o.d"
+  "/root/repo/integrity-scan.c" "CMakeFiles/playout-plugin.dir/root/repo/integrity-scan.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/integrity-scan.c.o.d"
+  "/root/repo/journal.c" "CMakeFiles/playout-plugin.dir/root/repo/journal.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/journal.c.o.d"
+  "/root/repo/media-cache.c" "CMakeFiles/playout-plugin.dir/root/repo/media-cache.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/media-cache.c.o.d"
+  "/root/repo/metrics.c" "CMakeFiles/playout-plugin.dir/root/repo/metrics.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/metrics.c.o.d"
+  "/root/repo/module-config.c" "CMakeFiles/playout-plugin.dir/root/repo/module-config.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/module-config.c.o.d"
+  "/root/repo/next-up-source.c" "CMakeFiles/playout-plugin.dir/root/repo/next-up-source.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/next-up-source.c.o.d"
+  "/root/repo/process.c" "CMakeFiles/playout-plugin.dir/root/repo/process.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/process.c.o.d"
+  "/root/repo/proxy-cache.c" "CMakeFiles/playout-plugin.dir/root/repo/proxy-cache.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/proxy-cache.c.o.d"
+  "/root/repo/shuffle-bag.c" "CMakeFiles/playout-plugin.dir/root/repo/shuffle-bag.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/shuffle-bag.c.o.d"
+  "/root/repo/source-registry.c" "CMakeFiles/playout-plugin.dir/root/repo/source-registry.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/source-registry.c.o.d"
+  "/root/repo/sync-group.c" "CMakeFiles/playout-plugin.dir/root/repo/sync-group.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/sync-group.c.o.d"
+  "/root/repo/timer-wheel.c" "CMakeFiles/playout-plugin.dir/root/repo/timer-wheel.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/timer-wheel.c.o.d"
+  "/root/repo/trace.c" "CMakeFiles/playout-plugin.dir/root/repo/trace.c.o" "gcc" "CMakeFiles/playout-plugin.dir/root/repo/trace.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_dbg/CMakeFiles/obs-mock.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
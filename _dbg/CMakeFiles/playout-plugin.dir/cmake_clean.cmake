@@ -0,0 +1,41 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/playout-plugin.dir/root/repo/as-run.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/as-run.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/audio-wrapper.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/audio-wrapper.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/filler.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/filler.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/integrity-scan.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/integrity-scan.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/journal.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/journal.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/media-cache.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/media-cache.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/metrics.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/metrics.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/module-config.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/module-config.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/next-up-source.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/next-up-source.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/process.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/process.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/proxy-cache.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/proxy-cache.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/shuffle-bag.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/shuffle-bag.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/source-registry.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/source-registry.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/sync-group.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/sync-group.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/timer-wheel.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/timer-wheel.c.o.d"
+  "CMakeFiles/playout-plugin.dir/root/repo/trace.c.o"
+  "CMakeFiles/playout-plugin.dir/root/repo/trace.c.o.d"
+  "libplayout-plugin.a"
+  "libplayout-plugin.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/playout-plugin.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/playout-soak.dir/soak.c.o"
+  "CMakeFiles/playout-soak.dir/soak.c.o.d"
+  "playout-soak"
+  "playout-soak.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/playout-soak.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
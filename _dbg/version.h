@@ -0,0 +1,6 @@
+#pragma once
+
+#define PROJECT_VERSION "0.0.4"
+#define PROJECT_VERSION_MAJOR 0
+#define PROJECT_VERSION_MINOR 0
+#define PROJECT_VERSION_PATCH 4
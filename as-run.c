@@ -0,0 +1,289 @@
+#include "as-run.h"
+#include <obs-module.h>
+#include <time.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#define AS_RUN_QUEUE_SIZE 1024
+
+struct as_run_slot {
+	volatile long sequence;
+	struct as_run_entry *entry;
+};
+
+struct as_run_file {
+	char *path;
+	FILE *file;
+	uint64_t last_write;
+};
+
+static struct {
+	struct as_run_slot slots[AS_RUN_QUEUE_SIZE];
+	volatile long enqueue_pos;
+	long dequeue_pos;
+	volatile long dropped;
+	long dropped_logged;
+	pthread_t thread;
+	bool thread_created;
+	volatile bool stopping;
+	char *default_dir;
+	DARRAY(struct as_run_file) files;
+} as_run;
+
+int64_t as_run_now_ms(void)
+{
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* bounded multi-producer queue, producers never wait and drop the entry when it is full */
+bool as_run_push(struct as_run_entry *entry)
+{
+	long pos = os_atomic_load_long(&as_run.enqueue_pos);
+	struct as_run_slot *slot;
+	for (;;) {
+		slot = &as_run.slots[pos & (AS_RUN_QUEUE_SIZE - 1)];
+		long diff = os_atomic_load_long(&slot->sequence) - pos;
+		if (diff == 0) {
+			if (os_atomic_compare_exchange_long(&as_run.enqueue_pos, &pos, pos + 1))
+				break;
+		} else if (diff < 0) {
+			os_atomic_inc_long(&as_run.dropped);
+			bfree(entry->dir);
+			bfree(entry->channel);
+			bfree(entry->path);
+			bfree(entry->section);
+			bfree(entry);
+			return false;
+		} else {
+			pos = os_atomic_load_long(&as_run.enqueue_pos);
+		}
+	}
+	slot->entry = entry;
+	os_atomic_set_long(&slot->sequence, pos + 1);
+	return true;
+}
+
+static struct as_run_entry *as_run_pop(void)
+{
+	struct as_run_slot *slot = &as_run.slots[as_run.dequeue_pos & (AS_RUN_QUEUE_SIZE - 1)];
+	if (os_atomic_load_long(&slot->sequence) - (as_run.dequeue_pos + 1) < 0)
+		return NULL;
+	struct as_run_entry *entry = slot->entry;
+	slot->entry = NULL;
+	os_atomic_set_long(&slot->sequence, as_run.dequeue_pos + AS_RUN_QUEUE_SIZE);
+	as_run.dequeue_pos++;
+	return entry;
+}
+
+static void as_run_cat_time(struct dstr *line, int64_t ms)
+{
+	time_t seconds = (time_t)(ms / 1000);
+	struct tm tm;
+#ifdef _WIN32
+	gmtime_s(&tm, &seconds);
+#else
+	gmtime_r(&seconds, &tm);
+#endif
+	char buffer[32];
+	strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &tm);
+	dstr_catf(line, "%s.%03dZ", buffer, (int)(ms % 1000));
+}
+
+static void as_run_cat_json(struct dstr *line, const char *str)
+{
+	dstr_cat_ch(line, '"');
+	for (const char *c = str ? str : ""; *c; c++) {
+		if (*c == '"' || *c == '\\') {
+			dstr_cat_ch(line, '\\');
+			dstr_cat_ch(line, *c);
+		} else if ((unsigned char)*c < 0x20) {
+			dstr_catf(line, "\\u%04x", (unsigned char)*c);
+		} else {
+			dstr_cat_ch(line, *c);
+		}
+	}
+	dstr_cat_ch(line, '"');
+}
+
+static void as_run_cat_csv(struct dstr *line, const char *str)
+{
+	dstr_cat_ch(line, '"');
+	for (const char *c = str ? str : ""; *c; c++) {
+		if (*c == '"')
+			dstr_cat_ch(line, '"');
+		dstr_cat_ch(line, *c);
+	}
+	dstr_cat_ch(line, '"');
+}
+
+static void as_run_format(struct as_run_entry *entry, struct dstr *line)
+{
+	if (entry->csv) {
+		as_run_cat_time(line, entry->start_ms);
+		dstr_cat_ch(line, ',');
+		as_run_cat_time(line, entry->end_ms);
+		dstr_cat_ch(line, ',');
+		as_run_cat_csv(line, entry->channel);
+		dstr_catf(line, ",%d,%ld,", entry->index + 1, entry->id);
+		as_run_cat_csv(line, entry->path);
+		dstr_catf(line, ",%lld,%lld,", (long long)entry->in_ms, (long long)entry->out_ms);
+		as_run_cat_csv(line, entry->section);
+		dstr_catf(line, ",%s\n", entry->ended);
+		return;
+	}
+	dstr_cat(line, "{\"start\":\"");
+	as_run_cat_time(line, entry->start_ms);
+	dstr_cat(line, "\",\"end\":\"");
+	as_run_cat_time(line, entry->end_ms);
+	dstr_cat(line, "\",\"channel\":");
+	as_run_cat_json(line, entry->channel);
+	dstr_catf(line, ",\"index\":%d,\"id\":%ld,\"path\":", entry->index + 1, entry->id);
+	as_run_cat_json(line, entry->path);
+	dstr_catf(line, ",\"in\":%lld,\"out\":%lld,\"section\":", (long long)entry->in_ms, (long long)entry->out_ms);
+	as_run_cat_json(line, entry->section);
+	dstr_catf(line, ",\"ended\":\"%s\"}\n", entry->ended);
+}
+
+static FILE *as_run_get_file(struct as_run_entry *entry, uint64_t now)
+{
+	const char *dir = entry->dir && strlen(entry->dir) ? entry->dir : as_run.default_dir;
+	char *name = os_generate_formatted_filename(entry->csv ? "csv" : "jsonl", false, "as-run-%CCYY-%MM-%DD");
+	struct dstr path;
+	dstr_init(&path);
+	dstr_printf(&path, "%s/%s", dir, name);
+	bfree(name);
+
+	FILE *file = NULL;
+	for (size_t i = 0; i < as_run.files.num; i++) {
+		if (strcmp(as_run.files.array[i].path, path.array) == 0) {
+			as_run.files.array[i].last_write = now;
+			file = as_run.files.array[i].file;
+			break;
+		}
+	}
+	if (!file) {
+		os_mkdirs(dir);
+		bool exists = os_file_exists(path.array);
+		file = os_fopen(path.array, "ab");
+		if (file) {
+			if (!exists && entry->csv)
+				fputs("start,end,channel,index,id,path,in_ms,out_ms,section,ended\n", file);
+			struct as_run_file *af = da_push_back_new(as_run.files);
+			af->path = path.array;
+			af->file = file;
+			af->last_write = now;
+			dstr_init(&path);
+		} else {
+			blog(LOG_WARNING, "[Playout Source] failed to open as-run log '%s'", path.array);
+		}
+	}
+	dstr_free(&path);
+	return file;
+}
+
+static void as_run_sync(struct as_run_file *af)
+{
+	fflush(af->file);
+#ifdef _WIN32
+	_commit(_fileno(af->file));
+#else
+	fsync(fileno(af->file));
+#endif
+}
+
+static void as_run_close_files(uint64_t now, bool all)
+{
+	for (size_t i = as_run.files.num; i > 0; i--) {
+		struct as_run_file *af = &as_run.files.array[i - 1];
+		if (!all && now - af->last_write < 60000000000ULL)
+			continue;
+		as_run_sync(af);
+		fclose(af->file);
+		bfree(af->path);
+		da_erase(as_run.files, i - 1);
+	}
+}
+
+static void as_run_drain(void)
+{
+	uint64_t now = os_gettime_ns();
+	bool written = false;
+	struct dstr line;
+	dstr_init(&line);
+	struct as_run_entry *entry;
+	while ((entry = as_run_pop()) != NULL) {
+		FILE *file = as_run_get_file(entry, now);
+		if (file) {
+			dstr_copy(&line, "");
+			as_run_format(entry, &line);
+			fwrite(line.array, 1, line.len, file);
+			written = true;
+		}
+		bfree(entry->dir);
+		bfree(entry->channel);
+		bfree(entry->path);
+		bfree(entry->section);
+		bfree(entry);
+	}
+	dstr_free(&line);
+	if (written) {
+		for (size_t i = 0; i < as_run.files.num; i++) {
+			if (as_run.files.array[i].last_write == now)
+				as_run_sync(&as_run.files.array[i]);
+		}
+	}
+	long dropped = os_atomic_load_long(&as_run.dropped);
+	if (dropped != as_run.dropped_logged) {
+		blog(LOG_WARNING, "[Playout Source] as-run queue full, %ld entries dropped", dropped - as_run.dropped_logged);
+		as_run.dropped_logged = dropped;
+	}
+}
+
+static void *as_run_thread(void *param)
+{
+	UNUSED_PARAMETER(param);
+	os_set_thread_name("playout_as_run");
+	while (!os_atomic_load_bool(&as_run.stopping)) {
+		as_run_drain();
+		as_run_close_files(os_gettime_ns(), false);
+		os_sleep_ms(500);
+	}
+	as_run_drain();
+	as_run_close_files(0, true);
+	return NULL;
+}
+
+void as_run_init(void)
+{
+	for (long i = 0; i < AS_RUN_QUEUE_SIZE; i++)
+		as_run.slots[i].sequence = i;
+	as_run.enqueue_pos = 0;
+	as_run.dequeue_pos = 0;
+	as_run.stopping = false;
+	as_run.default_dir = obs_module_config_path("as-run");
+	as_run.thread_created = pthread_create(&as_run.thread, NULL, as_run_thread, NULL) == 0;
+}
+
+void as_run_free(void)
+{
+	os_atomic_set_bool(&as_run.stopping, true);
+	if (as_run.thread_created) {
+		pthread_join(as_run.thread, NULL);
+		as_run.thread_created = false;
+	}
+	/* entries pushed while the thread was finishing are still written */
+	as_run_drain();
+	as_run_close_files(0, true);
+	da_free(as_run.files);
+	bfree(as_run.default_dir);
+	as_run.default_dir = NULL;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <obs.h>
+
+struct as_run_entry {
+	char *dir;
+	bool csv;
+	char *channel;
+	char *path;
+	char *section;
+	const char *ended;
+	int index;
+	long id;
+	int64_t start_ms;
+	int64_t end_ms;
+	int64_t in_ms;
+	int64_t out_ms;
+};
+
+void as_run_init(void);
+void as_run_free(void);
+
+int64_t as_run_now_ms(void);
+bool as_run_push(struct as_run_entry *entry);
@@ -1,6 +1,8 @@
 #include "audio-wrapper.h"
 #include "playout-source.h"
+#include "trace.h"
 #include <obs-module.h>
+#include <util/platform.h>
 
 const char *audio_wrapper_get_name(void *type_data)
 {
@@ -48,6 +50,8 @@ bool audio_wrapper_render(void *data, uint64_t *ts_out, struct obs_source_audio_
 		obs_source_release(source);
 		return false;
 	}
+	uint64_t start = os_gettime_ns();
+	uint64_t trace_start = trace_begin();
 	if (!mixers) {
 		audio_output_disconnect(obs_get_audio(), 1, audio_wrapper_audio_output_callback, aw);
 		audio_output_connect(obs_get_audio(), 1, NULL, audio_wrapper_audio_output_callback, aw);
@@ -74,6 +78,8 @@ bool audio_wrapper_render(void *data, uint64_t *ts_out, struct obs_source_audio_
 		break;
 	}
 	obs_source_release(source);
+	metrics_histogram_add(&aw->playout->metrics.audio_render_us, (long)((os_gettime_ns() - start) / 1000));
+	trace_end("audio_wrapper_render", trace_start);
 
 	return false;
 }
@@ -0,0 +1,294 @@
+#include "filler.h"
+#include "process.h"
+#include <obs-module.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+/* durations are rounded down to this unit for the subset sum, the exact
+ * remainder is trimmed from one filler */
+#define FILLER_UNIT_MS 40
+#define FILLER_MAX_GAP_MS 3600000
+/* a failed probe is retried after 30 seconds, doubling up to an hour */
+#define FILLER_RETRY_MS 30000
+#define FILLER_RETRY_MAX_MS 3600000
+
+struct filler_job {
+	char *path;
+	int64_t size;
+	int64_t duration;
+	int attempts;
+	uint64_t retry_ns;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	pthread_t thread;
+	bool thread_created;
+	os_event_t *event;
+	volatile bool stopping;
+	char *ffmpeg_path;
+	DARRAY(struct filler_job) jobs;
+} filler;
+
+static struct filler_job *filler_find_job(const char *path)
+{
+	for (size_t i = 0; i < filler.jobs.num; i++) {
+		if (strcmp(filler.jobs.array[i].path, path) == 0)
+			return &filler.jobs.array[i];
+	}
+	return NULL;
+}
+
+/* ffmpeg prints the container duration as "Duration: hh:mm:ss.cc" before it
+ * complains about the missing output, which saves depending on ffprobe */
+static int64_t filler_probe(const char *path, const char *ffmpeg_path)
+{
+	struct process_args args;
+	process_args_init(&args, ffmpeg_path);
+	process_args_add_list(&args, "-nostdin", "-hide_banner", "-i", path, NULL);
+	struct dstr output;
+	dstr_init(&output);
+	int result = process_run(&args, false, &output, 16384, &filler.stopping);
+	process_args_free(&args);
+	if (result == PROCESS_NOT_FOUND || result == PROCESS_NOT_EXECUTABLE) {
+		blog(LOG_WARNING, "[Playout Source] failed to start '%s'", ffmpeg_path);
+		dstr_free(&output);
+		return FILLER_DURATION_ERROR;
+	}
+
+	int64_t duration = FILLER_DURATION_ERROR;
+	const char *found = output.array ? strstr(output.array, "Duration: ") : NULL;
+	int hours, minutes;
+	double seconds;
+	if (found && sscanf(found + 10, "%d:%d:%lf", &hours, &minutes, &seconds) == 3)
+		duration = ((int64_t)hours * 3600 + minutes * 60) * 1000 + (int64_t)(seconds * 1000.0 + 0.5);
+	else
+		blog(LOG_WARNING, "[Playout Source] no duration found for filler '%s'", path);
+	dstr_free(&output);
+	return duration;
+}
+
+static void *filler_thread(void *param)
+{
+	UNUSED_PARAMETER(param);
+	os_set_thread_name("playout_filler");
+	while (!os_atomic_load_bool(&filler.stopping)) {
+		char *path = NULL;
+		char *ffmpeg_path = NULL;
+		uint64_t now = os_gettime_ns();
+		uint64_t retry_ns = 0;
+		pthread_mutex_lock(&filler.mutex);
+		for (size_t i = 0; i < filler.jobs.num; i++) {
+			struct filler_job *job = &filler.jobs.array[i];
+			if (job->duration == FILLER_DURATION_PENDING ||
+			    (job->duration == FILLER_DURATION_ERROR && job->retry_ns <= now)) {
+				path = bstrdup(job->path);
+				ffmpeg_path = bstrdup(filler.ffmpeg_path);
+				break;
+			}
+			if (job->duration == FILLER_DURATION_ERROR && (!retry_ns || job->retry_ns < retry_ns))
+				retry_ns = job->retry_ns;
+		}
+		pthread_mutex_unlock(&filler.mutex);
+		if (!path) {
+			if (retry_ns)
+				os_event_timedwait(filler.event, (unsigned long)((retry_ns - now) / 1000000) + 1);
+			else
+				os_event_wait(filler.event);
+			continue;
+		}
+
+		int64_t duration = filler_probe(path, ffmpeg_path);
+
+		pthread_mutex_lock(&filler.mutex);
+		struct filler_job *job = filler_find_job(path);
+		if (job && !os_atomic_load_bool(&filler.stopping)) {
+			job->duration = duration;
+			if (duration == FILLER_DURATION_ERROR) {
+				uint64_t delay = (uint64_t)FILLER_RETRY_MS << (job->attempts < 7 ? job->attempts : 7);
+				if (delay > FILLER_RETRY_MAX_MS)
+					delay = FILLER_RETRY_MAX_MS;
+				job->attempts++;
+				job->retry_ns = os_gettime_ns() + delay * 1000000ULL;
+			} else {
+				job->attempts = 0;
+			}
+		}
+		pthread_mutex_unlock(&filler.mutex);
+		bfree(ffmpeg_path);
+		bfree(path);
+	}
+	return NULL;
+}
+
+void filler_init(void)
+{
+	pthread_mutex_init(&filler.mutex, NULL);
+	os_event_init(&filler.event, OS_EVENT_TYPE_AUTO);
+	filler.ffmpeg_path = bstrdup("ffmpeg");
+	filler.thread_created = pthread_create(&filler.thread, NULL, filler_thread, NULL) == 0;
+}
+
+void filler_free(void)
+{
+	os_atomic_set_bool(&filler.stopping, true);
+	if (filler.thread_created) {
+		os_event_signal(filler.event);
+		pthread_join(filler.thread, NULL);
+		filler.thread_created = false;
+	}
+	for (size_t i = 0; i < filler.jobs.num; i++)
+		bfree(filler.jobs.array[i].path);
+	da_free(filler.jobs);
+	bfree(filler.ffmpeg_path);
+	filler.ffmpeg_path = NULL;
+	os_event_destroy(filler.event);
+	pthread_mutex_destroy(&filler.mutex);
+}
+
+void filler_set_options(const char *ffmpeg_path)
+{
+	pthread_mutex_lock(&filler.mutex);
+	if (ffmpeg_path && strlen(ffmpeg_path) && strcmp(filler.ffmpeg_path, ffmpeg_path) != 0) {
+		bfree(filler.ffmpeg_path);
+		filler.ffmpeg_path = bstrdup(ffmpeg_path);
+		for (size_t i = 0; i < filler.jobs.num; i++) {
+			if (filler.jobs.array[i].duration == FILLER_DURATION_ERROR) {
+				filler.jobs.array[i].duration = FILLER_DURATION_PENDING;
+				filler.jobs.array[i].attempts = 0;
+			}
+		}
+	}
+	pthread_mutex_unlock(&filler.mutex);
+	os_event_signal(filler.event);
+}
+
+/* returns the cached duration in ms, FILLER_DURATION_PENDING while the file is
+ * being probed, or FILLER_DURATION_ERROR while the probe failed and waits for a
+ * retry, which leaves the filler out of the plan */
+int64_t filler_get_duration(const char *path)
+{
+	if (!path || !strlen(path))
+		return 0;
+	int64_t size = os_get_file_size(path);
+	bool signal = false;
+	pthread_mutex_lock(&filler.mutex);
+	struct filler_job *job = filler_find_job(path);
+	if (!job) {
+		job = da_push_back_new(filler.jobs);
+		job->path = bstrdup(path);
+		job->size = size;
+		job->duration = FILLER_DURATION_PENDING;
+		signal = true;
+	} else if (job->size != size) {
+		job->size = size;
+		job->duration = FILLER_DURATION_PENDING;
+		job->attempts = 0;
+		signal = true;
+	}
+	int64_t duration = job->duration;
+	pthread_mutex_unlock(&filler.mutex);
+	if (signal)
+		os_event_signal(filler.event);
+	return duration;
+}
+
+/* Picks the subset of fillers with the smallest total that still covers the
+ * gap, a 0/1 subset sum over durations in FILLER_UNIT_MS steps. from[s] holds
+ * the filler that first reached sum s, so the subset is found by walking back.
+ * No filler can be left out of the smallest covering subset, so the overshoot
+ * is shorter than the picked fillers and is trimmed from the longest one, which
+ * is placed last. The whole pool is repeated while the gap is longer
+ * than all fillers together. */
+bool filler_plan(const int64_t *durations, size_t count, int64_t gap_ms, struct filler_plan *plan)
+{
+	da_init(plan->picks);
+	plan->trim_pick = 0;
+	plan->trim_ms = 0;
+	int64_t total = 0;
+	int64_t longest = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (durations[i] >= FILLER_UNIT_MS) {
+			total += durations[i];
+			if (durations[i] > longest)
+				longest = durations[i];
+		}
+	}
+	if (gap_ms <= 0 || gap_ms > FILLER_MAX_GAP_MS || !total)
+		return false;
+	while (gap_ms > total) {
+		for (size_t i = 0; i < count; i++) {
+			if (durations[i] >= FILLER_UNIT_MS)
+				da_push_back(plan->picks, &i);
+		}
+		gap_ms -= total;
+	}
+
+	size_t target = (size_t)((gap_ms + FILLER_UNIT_MS - 1) / FILLER_UNIT_MS);
+	size_t limit = target + (size_t)(longest / FILLER_UNIT_MS);
+	long *from = bmalloc((limit + 1) * sizeof(long));
+	for (size_t s = 0; s <= limit; s++)
+		from[s] = -1;
+	from[0] = (long)count;
+	for (size_t i = 0; i < count; i++) {
+		if (durations[i] < FILLER_UNIT_MS)
+			continue;
+		size_t weight = (size_t)(durations[i] / FILLER_UNIT_MS);
+		for (size_t s = limit; s >= weight; s--) {
+			if (from[s] < 0 && from[s - weight] >= 0)
+				from[s] = (long)i;
+		}
+	}
+	/* a sum up to count units below the target can still cover the gap once
+	 * the remainders lost to rounding are added back */
+	size_t sum = target > count ? target - count : 1;
+	for (; sum <= limit; sum++) {
+		if (from[sum] < 0)
+			continue;
+		int64_t ms = 0;
+		for (size_t s = sum; s > 0; s -= (size_t)(durations[from[s]] / FILLER_UNIT_MS))
+			ms += durations[from[s]];
+		if (ms >= gap_ms)
+			break;
+	}
+
+	size_t first = plan->picks.num;
+	int64_t picked_ms = 0;
+	if (sum <= limit) {
+		while (sum > 0) {
+			size_t i = (size_t)from[sum];
+			da_push_back(plan->picks, &i);
+			picked_ms += durations[i];
+			sum -= (size_t)(durations[i] / FILLER_UNIT_MS);
+		}
+	} else {
+		/* rounding down lost the cover, only possible when every filler is needed */
+		for (size_t i = 0; i < count; i++) {
+			if (durations[i] >= FILLER_UNIT_MS) {
+				da_push_back(plan->picks, &i);
+				picked_ms += durations[i];
+			}
+		}
+	}
+	bfree(from);
+
+	size_t trim = first;
+	for (size_t p = first + 1; p < plan->picks.num; p++) {
+		if (durations[plan->picks.array[p]] > durations[plan->picks.array[trim]])
+			trim = p;
+	}
+	plan->trim_ms = picked_ms - gap_ms;
+	if (plan->picks.num <= first || plan->trim_ms >= durations[plan->picks.array[trim]]) {
+		da_free(plan->picks);
+		return false;
+	}
+	da_move_item(plan->picks, trim, plan->picks.num - 1);
+	plan->trim_pick = plan->picks.num - 1;
+	return true;
+}
+
+void filler_plan_free(struct filler_plan *plan)
+{
+	da_free(plan->picks);
+}
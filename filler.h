@@ -0,0 +1,21 @@
+#pragma once
+#include <obs.h>
+#include <util/darray.h>
+
+#define FILLER_DURATION_PENDING -1
+#define FILLER_DURATION_ERROR -2
+
+struct filler_plan {
+	DARRAY(size_t) picks;
+	size_t trim_pick;
+	int64_t trim_ms;
+};
+
+void filler_init(void);
+void filler_free(void);
+void filler_set_options(const char *ffmpeg_path);
+
+int64_t filler_get_duration(const char *path);
+
+bool filler_plan(const int64_t *durations, size_t count, int64_t gap_ms, struct filler_plan *plan);
+void filler_plan_free(struct filler_plan *plan);
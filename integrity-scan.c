@@ -0,0 +1,332 @@
+#include "integrity-scan.h"
+#include "process.h"
+#include <obs-module.h>
+#include <sys/stat.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+#define INTEGRITY_SCAN_MAX_THREADS 4
+#define INTEGRITY_SCAN_REASON_SIZE 512
+/* how often an idle worker looks for scanned files that changed on disk */
+#define INTEGRITY_SCAN_CHECK_MS 10000
+
+struct integrity_scan_job {
+	char *path;
+	int64_t size;
+	int64_t mtime;
+	int status;
+	bool running;
+	char *reason;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	pthread_t workers[INTEGRITY_SCAN_MAX_THREADS];
+	bool worker_created[INTEGRITY_SCAN_MAX_THREADS];
+	os_event_t *event;
+	volatile bool stopping;
+	char *ffmpeg_path;
+	int threads;
+	int running;
+	bool decode;
+	double rate;
+	bool readrate_supported;
+	uint64_t check_ns;
+	volatile long generation;
+	DARRAY(struct integrity_scan_job) jobs;
+} scan;
+
+static struct integrity_scan_job *integrity_scan_find_job(const char *path)
+{
+	for (size_t i = 0; i < scan.jobs.num; i++) {
+		if (strcmp(scan.jobs.array[i].path, path) == 0)
+			return &scan.jobs.array[i];
+	}
+	return NULL;
+}
+
+static struct integrity_scan_job *integrity_scan_next_job(void)
+{
+	if (scan.running >= scan.threads)
+		return NULL;
+	for (size_t i = 0; i < scan.jobs.num; i++) {
+		if (scan.jobs.array[i].status == INTEGRITY_SCAN_PENDING && !scan.jobs.array[i].running)
+			return &scan.jobs.array[i];
+	}
+	return NULL;
+}
+
+static void integrity_scan_file_info(const char *path, int64_t *size, int64_t *mtime)
+{
+	struct stat st;
+	if (os_stat(path, &st) == 0) {
+		*size = (int64_t)st.st_size;
+		*mtime = (int64_t)st.st_mtime;
+	} else {
+		*size = -1;
+		*mtime = 0;
+	}
+}
+
+/* Marks scanned files that changed on disk for a new scan, so looking up a
+ * status from the graphics thread never has to touch the disk. */
+static void integrity_scan_check_files(void)
+{
+	DARRAY(char *) paths;
+	da_init(paths);
+	pthread_mutex_lock(&scan.mutex);
+	uint64_t now = os_gettime_ns();
+	if (now >= scan.check_ns) {
+		scan.check_ns = now + INTEGRITY_SCAN_CHECK_MS * 1000000ULL;
+		for (size_t i = 0; i < scan.jobs.num; i++) {
+			if (scan.jobs.array[i].status != INTEGRITY_SCAN_PENDING && !scan.jobs.array[i].running) {
+				char *path = bstrdup(scan.jobs.array[i].path);
+				da_push_back(paths, &path);
+			}
+		}
+	}
+	pthread_mutex_unlock(&scan.mutex);
+	for (size_t i = 0; i < paths.num; i++) {
+		int64_t size, mtime;
+		integrity_scan_file_info(paths.array[i], &size, &mtime);
+		pthread_mutex_lock(&scan.mutex);
+		struct integrity_scan_job *job = integrity_scan_find_job(paths.array[i]);
+		if (job && !job->running && job->status != INTEGRITY_SCAN_PENDING && (job->size != size || job->mtime != mtime)) {
+			job->status = INTEGRITY_SCAN_PENDING;
+			os_atomic_inc_long(&scan.generation);
+		}
+		pthread_mutex_unlock(&scan.mutex);
+		bfree(paths.array[i]);
+	}
+	da_free(paths);
+}
+
+/* runs ffmpeg on a single thread at the lowest priority, optionally limited to a
+ * multiple of realtime, so a scan can not take cpu or disk time from playout */
+static int integrity_scan_run(const char *path, const char *ffmpeg_path, bool decode, double rate, struct dstr *error)
+{
+	struct process_args args;
+	process_args_init(&args, ffmpeg_path);
+	process_args_add_list(&args, "-nostdin", "-v", "error", "-threads", "1", NULL);
+	if (rate > 0.0) {
+		process_args_add(&args, "-readrate");
+		process_args_addf(&args, "%.2f", rate);
+	}
+	process_args_add_list(&args, "-i", path, "-map", "0", NULL);
+	if (!decode)
+		process_args_add_list(&args, "-c", "copy", NULL);
+	process_args_add_list(&args, "-f", "null", "-", NULL);
+	int result = process_run(&args, true, error, INTEGRITY_SCAN_REASON_SIZE, &scan.stopping);
+	if (result == PROCESS_NOT_FOUND || result == PROCESS_NOT_EXECUTABLE)
+		dstr_printf(error, "failed to start '%s'", ffmpeg_path);
+	process_args_free(&args);
+	return result;
+}
+
+static void *integrity_scan_thread(void *param)
+{
+	UNUSED_PARAMETER(param);
+	os_set_thread_name("playout_integrity_scan");
+	while (!os_atomic_load_bool(&scan.stopping)) {
+		pthread_mutex_lock(&scan.mutex);
+		struct integrity_scan_job *job = integrity_scan_next_job();
+		char *path = NULL;
+		char *ffmpeg_path = NULL;
+		bool decode = false;
+		double rate = 0.0;
+		if (job) {
+			job->running = true;
+			scan.running++;
+			path = bstrdup(job->path);
+			ffmpeg_path = bstrdup(scan.ffmpeg_path);
+			decode = scan.decode;
+			rate = scan.readrate_supported ? scan.rate : 0.0;
+		}
+		pthread_mutex_unlock(&scan.mutex);
+		if (!path) {
+			integrity_scan_check_files();
+			os_event_timedwait(scan.event, INTEGRITY_SCAN_CHECK_MS);
+			continue;
+		}
+		os_event_signal(scan.event);
+
+		struct dstr error;
+		dstr_init(&error);
+		int64_t size, mtime;
+		integrity_scan_file_info(path, &size, &mtime);
+		int result = integrity_scan_run(path, ffmpeg_path, decode, rate, &error);
+		bool retry = result != 0 && rate > 0.0 && error.array && strstr(error.array, "readrate");
+		if (error.array) {
+			dstr_replace(&error, "\r", "");
+			dstr_depad(&error);
+			if (error.len > INTEGRITY_SCAN_REASON_SIZE)
+				dstr_resize(&error, INTEGRITY_SCAN_REASON_SIZE);
+		}
+
+		pthread_mutex_lock(&scan.mutex);
+		scan.running--;
+		if (retry && scan.readrate_supported) {
+			scan.readrate_supported = false;
+			blog(LOG_WARNING, "[Playout Source] '%s' does not support -readrate, scanning without a read limit",
+			     ffmpeg_path);
+		}
+		job = integrity_scan_find_job(path);
+		if (job) {
+			job->running = false;
+			if (!retry && !os_atomic_load_bool(&scan.stopping)) {
+				job->size = size;
+				job->mtime = mtime;
+				if (result == PROCESS_NOT_FOUND || result == PROCESS_NOT_EXECUTABLE)
+					job->status = INTEGRITY_SCAN_UNKNOWN;
+				else if (result != 0)
+					job->status = INTEGRITY_SCAN_FAILED;
+				else
+					job->status = error.len ? INTEGRITY_SCAN_WARNING : INTEGRITY_SCAN_OK;
+				bfree(job->reason);
+				job->reason = error.len ? bstrdup(error.array) : NULL;
+				os_atomic_inc_long(&scan.generation);
+				if (job->status != INTEGRITY_SCAN_OK)
+					blog(LOG_WARNING, "[Playout Source] integrity scan of '%s' %s: %s", path,
+					     integrity_scan_status_name(job->status), job->reason ? job->reason : "");
+			}
+		}
+		pthread_mutex_unlock(&scan.mutex);
+		os_event_signal(scan.event);
+		dstr_free(&error);
+		bfree(ffmpeg_path);
+		bfree(path);
+	}
+	/* the auto reset event wakes a single worker, pass the stop on to the next */
+	os_event_signal(scan.event);
+	return NULL;
+}
+
+/* workers start with the first scan that is requested, up to the thread option */
+static void integrity_scan_start_workers(void)
+{
+	for (int i = 0; i < scan.threads; i++) {
+		if (!scan.worker_created[i])
+			scan.worker_created[i] = pthread_create(&scan.workers[i], NULL, integrity_scan_thread, NULL) == 0;
+	}
+}
+
+void integrity_scan_init(void)
+{
+	pthread_mutex_init(&scan.mutex, NULL);
+	os_event_init(&scan.event, OS_EVENT_TYPE_AUTO);
+	scan.ffmpeg_path = bstrdup("ffmpeg");
+	scan.threads = 1;
+	scan.readrate_supported = true;
+}
+
+void integrity_scan_free(void)
+{
+	os_atomic_set_bool(&scan.stopping, true);
+	for (int i = 0; i < INTEGRITY_SCAN_MAX_THREADS; i++) {
+		if (!scan.worker_created[i])
+			continue;
+		os_event_signal(scan.event);
+		pthread_join(scan.workers[i], NULL);
+		scan.worker_created[i] = false;
+	}
+	for (size_t i = 0; i < scan.jobs.num; i++) {
+		bfree(scan.jobs.array[i].path);
+		bfree(scan.jobs.array[i].reason);
+	}
+	da_free(scan.jobs);
+	bfree(scan.ffmpeg_path);
+	scan.ffmpeg_path = NULL;
+	os_event_destroy(scan.event);
+	pthread_mutex_destroy(&scan.mutex);
+}
+
+void integrity_scan_set_options(const char *ffmpeg_path, int threads, bool decode, double rate)
+{
+	pthread_mutex_lock(&scan.mutex);
+	if (ffmpeg_path && strlen(ffmpeg_path) && strcmp(scan.ffmpeg_path, ffmpeg_path) != 0) {
+		bfree(scan.ffmpeg_path);
+		scan.ffmpeg_path = bstrdup(ffmpeg_path);
+		scan.readrate_supported = true;
+		for (size_t i = 0; i < scan.jobs.num; i++) {
+			if (scan.jobs.array[i].status == INTEGRITY_SCAN_UNKNOWN) {
+				scan.jobs.array[i].status = INTEGRITY_SCAN_PENDING;
+				os_atomic_inc_long(&scan.generation);
+			}
+		}
+	}
+	scan.threads = threads < 1 ? 1 : (threads > INTEGRITY_SCAN_MAX_THREADS ? INTEGRITY_SCAN_MAX_THREADS : threads);
+	scan.decode = decode;
+	scan.rate = rate;
+	if (scan.jobs.num)
+		integrity_scan_start_workers();
+	pthread_mutex_unlock(&scan.mutex);
+	os_event_signal(scan.event);
+}
+
+void integrity_scan_request(const char *path, bool force)
+{
+	if (!path || !strlen(path))
+		return;
+	/* only a job that became pending wakes a worker */
+	bool pending = false;
+	pthread_mutex_lock(&scan.mutex);
+	struct integrity_scan_job *job = integrity_scan_find_job(path);
+	if (!job) {
+		job = da_push_back_new(scan.jobs);
+		job->path = bstrdup(path);
+		job->status = INTEGRITY_SCAN_PENDING;
+		pending = true;
+	} else if (force && !job->running && job->status != INTEGRITY_SCAN_PENDING) {
+		job->status = INTEGRITY_SCAN_PENDING;
+		pending = true;
+	}
+	if (pending) {
+		os_atomic_inc_long(&scan.generation);
+		integrity_scan_start_workers();
+	}
+	pthread_mutex_unlock(&scan.mutex);
+	if (pending)
+		os_event_signal(scan.event);
+}
+
+/* changes whenever the status of a file changes, so callers can keep the
+ * status they looked up until then */
+long integrity_scan_generation(void)
+{
+	return os_atomic_load_long(&scan.generation);
+}
+
+int integrity_scan_get(const char *path, char **reason)
+{
+	if (!path)
+		return INTEGRITY_SCAN_NONE;
+	pthread_mutex_lock(&scan.mutex);
+	struct integrity_scan_job *job = integrity_scan_find_job(path);
+	int status = INTEGRITY_SCAN_NONE;
+	if (job) {
+		status = job->status;
+		if (reason)
+			*reason = job->reason ? bstrdup(job->reason) : NULL;
+	}
+	pthread_mutex_unlock(&scan.mutex);
+	return status;
+}
+
+const char *integrity_scan_status_name(int status)
+{
+	switch (status) {
+	case INTEGRITY_SCAN_PENDING:
+		return "pending";
+	case INTEGRITY_SCAN_OK:
+		return "ok";
+	case INTEGRITY_SCAN_WARNING:
+		return "warning";
+	case INTEGRITY_SCAN_FAILED:
+		return "failed";
+	case INTEGRITY_SCAN_UNKNOWN:
+		return "unknown";
+	}
+	return "none";
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <obs.h>
+
+#define INTEGRITY_SCAN_NONE 0
+#define INTEGRITY_SCAN_PENDING 1
+#define INTEGRITY_SCAN_OK 2
+#define INTEGRITY_SCAN_WARNING 3
+#define INTEGRITY_SCAN_FAILED 4
+/* ffmpeg could not be started, so nothing is known about the file */
+#define INTEGRITY_SCAN_UNKNOWN 5
+
+void integrity_scan_init(void);
+void integrity_scan_free(void);
+void integrity_scan_set_options(const char *ffmpeg_path, int threads, bool decode, double rate);
+
+void integrity_scan_request(const char *path, bool force);
+int integrity_scan_get(const char *path, char **reason);
+long integrity_scan_generation(void);
+const char *integrity_scan_status_name(int status);
@@ -0,0 +1,199 @@
+#include "journal.h"
+#include <obs-module.h>
+#include <stdio.h>
+#include <util/crc32.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#define JOURNAL_COMPACT_SIZE 65536
+
+struct journal_record {
+	char *journal_id;
+	char *line;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	pthread_t thread;
+	bool thread_created;
+	os_event_t *event;
+	volatile bool stopping;
+	char *dir;
+	DARRAY(struct journal_record) pending;
+	DARRAY(char *) open;
+} journal;
+
+static void journal_file(const char *journal_id, struct dstr *file)
+{
+	dstr_printf(file, "%s/%s.log", journal.dir, journal_id);
+}
+
+static bool journal_is_open(const char *journal_id)
+{
+	for (size_t i = 0; i < journal.open.num; i++) {
+		if (strcmp(journal.open.array[i], journal_id) == 0)
+			return true;
+	}
+	return false;
+}
+
+static void journal_write(struct journal_record *record)
+{
+	struct dstr file;
+	dstr_init(&file);
+	journal_file(record->journal_id, &file);
+	FILE *f = os_fopen(file.array, "ab");
+	if (f) {
+		fputs(record->line, f);
+		fflush(f);
+#ifdef _WIN32
+		_commit(_fileno(f));
+#else
+		fsync(fileno(f));
+#endif
+		fclose(f);
+	}
+	if (os_get_file_size(file.array) > JOURNAL_COMPACT_SIZE)
+		os_quick_write_utf8_file_safe(file.array, record->line, strlen(record->line), false, "tmp", NULL);
+	dstr_free(&file);
+}
+
+static void *journal_thread(void *param)
+{
+	UNUSED_PARAMETER(param);
+	os_set_thread_name("playout_journal");
+	while (true) {
+		os_event_wait(journal.event);
+		pthread_mutex_lock(&journal.mutex);
+		DARRAY(struct journal_record) pending;
+		da_init(pending);
+		da_move(pending, journal.pending);
+		pthread_mutex_unlock(&journal.mutex);
+
+		for (size_t i = 0; i < pending.num; i++) {
+			bool last = true;
+			for (size_t j = i + 1; j < pending.num && last; j++)
+				last = strcmp(pending.array[i].journal_id, pending.array[j].journal_id) != 0;
+			if (last)
+				journal_write(&pending.array[i]);
+			bfree(pending.array[i].journal_id);
+			bfree(pending.array[i].line);
+		}
+		da_free(pending);
+		if (os_atomic_load_bool(&journal.stopping))
+			break;
+	}
+	return NULL;
+}
+
+void journal_init(void)
+{
+	pthread_mutex_init(&journal.mutex, NULL);
+	os_event_init(&journal.event, OS_EVENT_TYPE_AUTO);
+	journal.dir = obs_module_config_path("journal");
+	os_mkdirs(journal.dir);
+	journal.thread_created = pthread_create(&journal.thread, NULL, journal_thread, NULL) == 0;
+}
+
+void journal_free(void)
+{
+	os_atomic_set_bool(&journal.stopping, true);
+	if (journal.thread_created) {
+		os_event_signal(journal.event);
+		pthread_join(journal.thread, NULL);
+		journal.thread_created = false;
+	}
+	for (size_t i = 0; i < journal.pending.num; i++) {
+		bfree(journal.pending.array[i].journal_id);
+		bfree(journal.pending.array[i].line);
+	}
+	da_free(journal.pending);
+	for (size_t i = 0; i < journal.open.num; i++)
+		bfree(journal.open.array[i]);
+	da_free(journal.open);
+	bfree(journal.dir);
+	journal.dir = NULL;
+	os_event_destroy(journal.event);
+	pthread_mutex_destroy(&journal.mutex);
+}
+
+char *journal_open(const char *journal_id, const char *name)
+{
+	struct dstr id;
+	dstr_init(&id);
+	if (journal_id && *journal_id)
+		dstr_copy(&id, journal_id);
+	else
+		dstr_printf(&id, "%08X", calc_crc32(0, name, strlen(name)));
+	pthread_mutex_lock(&journal.mutex);
+	for (uint64_t seed = os_gettime_ns(); journal_is_open(id.array); seed++)
+		dstr_printf(&id, "%016llX", (unsigned long long)seed);
+	char *copy = bstrdup(id.array);
+	da_push_back(journal.open, &copy);
+	pthread_mutex_unlock(&journal.mutex);
+	return id.array;
+}
+
+void journal_close(const char *journal_id)
+{
+	if (!journal_id)
+		return;
+	pthread_mutex_lock(&journal.mutex);
+	for (size_t i = 0; i < journal.open.num; i++) {
+		if (strcmp(journal.open.array[i], journal_id) == 0) {
+			bfree(journal.open.array[i]);
+			da_erase(journal.open, i);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&journal.mutex);
+}
+
+void journal_append(const char *journal_id, long id, int64_t media_ms, int64_t wall_ms)
+{
+	struct dstr line;
+	dstr_init(&line);
+	dstr_printf(&line, "%ld,%lld,%lld\n", id, (long long)media_ms, (long long)wall_ms);
+	pthread_mutex_lock(&journal.mutex);
+	struct journal_record *record = da_push_back_new(journal.pending);
+	record->journal_id = bstrdup(journal_id);
+	record->line = line.array;
+	pthread_mutex_unlock(&journal.mutex);
+	os_event_signal(journal.event);
+}
+
+bool journal_read_last(const char *journal_id, long *id, int64_t *media_ms, int64_t *wall_ms)
+{
+	struct dstr file;
+	dstr_init(&file);
+	journal_file(journal_id, &file);
+	char *content = os_quick_read_utf8_file(file.array);
+	dstr_free(&file);
+	if (!content)
+		return false;
+	bool found = false;
+	char *line = content;
+	char *newline;
+	while ((newline = strchr(line, '\n')) != NULL) {
+		*newline = 0;
+		long line_id;
+		long long line_media;
+		long long line_wall;
+		if (sscanf(line, "%ld,%lld,%lld", &line_id, &line_media, &line_wall) == 3 && line_id > 0) {
+			*id = line_id;
+			*media_ms = line_media;
+			*wall_ms = line_wall;
+			found = true;
+		}
+		line = newline + 1;
+	}
+	bfree(content);
+	return found;
+}
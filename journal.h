@@ -0,0 +1,15 @@
+#pragma once
+#include <obs.h>
+
+void journal_init(void);
+void journal_free(void);
+
+/* Returns the journal id a playout writes under, to be kept in its settings.
+ * Sources without one keep the journal named after the crc32 of their name.
+ * An id another playout has open, as after duplicating a source, is replaced
+ * by a new one. The id is closed again with journal_close and freed by the caller. */
+char *journal_open(const char *journal_id, const char *name);
+void journal_close(const char *journal_id);
+
+void journal_append(const char *journal_id, long id, int64_t media_ms, int64_t wall_ms);
+bool journal_read_last(const char *journal_id, long *id, int64_t *media_ms, int64_t *wall_ms);
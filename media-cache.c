@@ -0,0 +1,600 @@
+#include "media-cache.h"
+#include <obs-module.h>
+#include <time.h>
+#include <util/crc32.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#ifdef HAVE_CURL
+#include <curl/curl.h>
+#endif
+
+#define MEDIA_CACHE_RETRY_NS 30000000000ULL
+#define MEDIA_CACHE_BUFFER_SIZE (1024 * 1024)
+
+struct media_cache_entry {
+	char *url;
+	char *file;
+	uint32_t crc;
+	uint64_t size;
+	int64_t last_used;
+	long pins;
+	bool unlink_failed;
+	bool pending;
+	uint32_t pending_crc;
+	uint64_t pending_size;
+};
+
+struct media_cache_job {
+	char *url;
+	char *checksum;
+	uint64_t due_ns;
+	uint64_t retry_ns;
+	uint64_t requested_ns;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	pthread_t thread;
+	bool thread_created;
+	os_event_t *event;
+	volatile bool stopping;
+	char *dir;
+	uint64_t limit;
+	uint64_t total;
+	bool dirty;
+	DARRAY(struct media_cache_entry) entries;
+	DARRAY(struct media_cache_job) jobs;
+} cache;
+
+bool media_cache_is_remote(const char *path)
+{
+	if (!path || !*path)
+		return false;
+	if (strncmp(path, "\\\\", 2) == 0 || strncmp(path, "//", 2) == 0)
+		return true;
+	return strstr(path, "://") != NULL && strncmp(path, "file://", 7) != 0;
+}
+
+static bool media_cache_is_url(const char *path)
+{
+	return strstr(path, "://") != NULL;
+}
+
+static struct media_cache_entry *media_cache_find_entry(const char *url)
+{
+	for (size_t i = 0; i < cache.entries.num; i++) {
+		if (strcmp(cache.entries.array[i].url, url) == 0)
+			return &cache.entries.array[i];
+	}
+	return NULL;
+}
+
+static struct media_cache_job *media_cache_find_job(const char *url)
+{
+	for (size_t i = 0; i < cache.jobs.num; i++) {
+		if (strcmp(cache.jobs.array[i].url, url) == 0)
+			return &cache.jobs.array[i];
+	}
+	return NULL;
+}
+
+/* a download that finished while the file was pinned waits next to it */
+static void media_cache_pending_file(struct media_cache_entry *entry, struct dstr *file)
+{
+	dstr_copy(file, entry->file);
+	dstr_cat(file, ".new");
+}
+
+static void media_cache_unlink_pending(struct media_cache_entry *entry)
+{
+	if (!entry->pending)
+		return;
+	struct dstr file;
+	dstr_init(&file);
+	media_cache_pending_file(entry, &file);
+	os_unlink(file.array);
+	dstr_free(&file);
+	entry->pending = false;
+}
+
+static void media_cache_entry_free(struct media_cache_entry *entry)
+{
+	bfree(entry->url);
+	bfree(entry->file);
+}
+
+static void media_cache_job_free(struct media_cache_job *job)
+{
+	bfree(job->url);
+	bfree(job->checksum);
+}
+
+static bool media_cache_checksum_matches(const char *checksum, uint32_t crc)
+{
+	if (!checksum || !*checksum)
+		return true;
+	return (uint32_t)strtoul(checksum, NULL, 16) == crc;
+}
+
+static void media_cache_load_index(void)
+{
+	struct dstr path;
+	dstr_init_copy(&path, cache.dir);
+	dstr_cat(&path, "/cache.json");
+	obs_data_t *index = obs_data_create_from_json_file_safe(path.array, "bak");
+	dstr_free(&path);
+	if (!index)
+		return;
+	obs_data_array_t *entries = obs_data_get_array(index, "entries");
+	size_t count = obs_data_array_count(entries);
+	for (size_t i = 0; i < count; i++) {
+		obs_data_t *e = obs_data_array_item(entries, i);
+		const char *file = obs_data_get_string(e, "file");
+		struct dstr pending;
+		dstr_init_copy(&pending, file);
+		dstr_cat(&pending, ".new");
+		os_unlink(pending.array);
+		dstr_free(&pending);
+		if (os_file_exists(file)) {
+			struct media_cache_entry *entry = da_push_back_new(cache.entries);
+			entry->url = bstrdup(obs_data_get_string(e, "url"));
+			entry->file = bstrdup(file);
+			entry->crc = (uint32_t)obs_data_get_int(e, "crc");
+			entry->size = (uint64_t)obs_data_get_int(e, "size");
+			entry->last_used = (int64_t)obs_data_get_int(e, "last_used");
+			cache.total += entry->size;
+		}
+		obs_data_release(e);
+	}
+	obs_data_array_release(entries);
+	obs_data_release(index);
+}
+
+static void media_cache_save_index(void)
+{
+	obs_data_t *index = obs_data_create();
+	obs_data_array_t *entries = obs_data_array_create();
+	pthread_mutex_lock(&cache.mutex);
+	for (size_t i = 0; i < cache.entries.num; i++) {
+		struct media_cache_entry *entry = &cache.entries.array[i];
+		obs_data_t *e = obs_data_create();
+		obs_data_set_string(e, "url", entry->url);
+		obs_data_set_string(e, "file", entry->file);
+		obs_data_set_int(e, "crc", entry->crc);
+		obs_data_set_int(e, "size", (long long)entry->size);
+		obs_data_set_int(e, "last_used", entry->last_used);
+		obs_data_array_push_back(entries, e);
+		obs_data_release(e);
+	}
+	cache.dirty = false;
+	pthread_mutex_unlock(&cache.mutex);
+	obs_data_set_array(index, "entries", entries);
+	obs_data_array_release(entries);
+
+	struct dstr path;
+	dstr_init_copy(&path, cache.dir);
+	dstr_cat(&path, "/cache.json");
+	obs_data_save_json_safe(index, path.array, "tmp", "bak");
+	dstr_free(&path);
+	obs_data_release(index);
+}
+
+/* Files handed out by media_cache_get are pinned until media_cache_release, an
+ * item may be about to air them. A file that can not be deleted, still open in
+ * another program for example, is skipped and tried again on the next pass. */
+static void media_cache_evict(const char *keep)
+{
+	for (size_t i = 0; i < cache.entries.num; i++)
+		cache.entries.array[i].unlink_failed = false;
+	while (cache.total > cache.limit && cache.entries.num > 1) {
+		size_t oldest = DARRAY_INVALID;
+		for (size_t i = 0; i < cache.entries.num; i++) {
+			struct media_cache_entry *entry = &cache.entries.array[i];
+			if (entry->pins || entry->unlink_failed || strcmp(entry->url, keep) == 0)
+				continue;
+			if (oldest == DARRAY_INVALID || entry->last_used < cache.entries.array[oldest].last_used)
+				oldest = i;
+		}
+		if (oldest == DARRAY_INVALID)
+			break;
+		struct media_cache_entry *entry = &cache.entries.array[oldest];
+		if (os_unlink(entry->file) != 0 && os_file_exists(entry->file)) {
+			blog(LOG_WARNING, "[Playout Source] could not evict '%s' from media cache", entry->url);
+			entry->unlink_failed = true;
+			continue;
+		}
+		media_cache_unlink_pending(entry);
+		blog(LOG_INFO, "[Playout Source] evicted '%s' from media cache", entry->url);
+		cache.total -= entry->size;
+		media_cache_entry_free(entry);
+		da_erase(cache.entries, oldest);
+		cache.dirty = true;
+	}
+}
+
+struct media_cache_download {
+	FILE *file;
+	uint32_t crc;
+	uint64_t size;
+};
+
+static bool media_cache_write(struct media_cache_download *d, const void *data, size_t size)
+{
+	if (fwrite(data, 1, size, d->file) != size)
+		return false;
+	d->crc = calc_crc32(d->crc, data, size);
+	d->size += size;
+	return true;
+}
+
+#ifdef HAVE_CURL
+static size_t media_cache_curl_write(void *ptr, size_t size, size_t nmemb, void *param)
+{
+	if (os_atomic_load_bool(&cache.stopping))
+		return 0;
+	size_t bytes = size * nmemb;
+	return media_cache_write(param, ptr, bytes) ? bytes : 0;
+}
+#endif
+
+static bool media_cache_fetch(const char *url, struct media_cache_download *d)
+{
+	if (media_cache_is_url(url)) {
+#ifdef HAVE_CURL
+		char error[CURL_ERROR_SIZE] = {0};
+		CURL *curl = curl_easy_init();
+		if (!curl)
+			return false;
+		curl_easy_setopt(curl, CURLOPT_URL, url);
+		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, media_cache_curl_write);
+		curl_easy_setopt(curl, CURLOPT_WRITEDATA, d);
+		curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+		curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+		curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+		curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 30L);
+		curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1024L);
+		curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, 60L);
+		curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, error);
+		CURLcode code = curl_easy_perform(curl);
+		curl_easy_cleanup(curl);
+		if (code != CURLE_OK) {
+			blog(LOG_WARNING, "[Playout Source] download of '%s' failed: %s", url,
+			     *error ? error : curl_easy_strerror(code));
+			return false;
+		}
+		return true;
+#else
+		blog(LOG_WARNING, "[Playout Source] cannot download '%s', built without curl", url);
+		return false;
+#endif
+	}
+
+	FILE *in = os_fopen(url, "rb");
+	if (!in) {
+		blog(LOG_WARNING, "[Playout Source] cannot open '%s' for caching", url);
+		return false;
+	}
+	uint8_t *buffer = bmalloc(MEDIA_CACHE_BUFFER_SIZE);
+	bool success = true;
+	size_t read;
+	while ((read = fread(buffer, 1, MEDIA_CACHE_BUFFER_SIZE, in)) > 0) {
+		if (os_atomic_load_bool(&cache.stopping) || !media_cache_write(d, buffer, read)) {
+			success = false;
+			break;
+		}
+	}
+	if (ferror(in))
+		success = false;
+	bfree(buffer);
+	fclose(in);
+	return success;
+}
+
+static uint64_t media_cache_hash(const char *url)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (const unsigned char *c = (const unsigned char *)url; *c; c++) {
+		hash ^= *c;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+static bool media_cache_file_taken(const char *url, const char *file)
+{
+	for (size_t i = 0; i < cache.entries.num; i++) {
+		struct media_cache_entry *entry = &cache.entries.array[i];
+		if (strcmp(entry->file, file) == 0 && strcmp(entry->url, url) != 0)
+			return true;
+	}
+	return false;
+}
+
+/* Files are named by a 64 bit FNV-1a hash of the URL, a name another URL in the
+ * index already uses gets a counter appended. A cached URL keeps its file. */
+static void media_cache_local_file(const char *url, struct dstr *file)
+{
+	pthread_mutex_lock(&cache.mutex);
+	struct media_cache_entry *entry = media_cache_find_entry(url);
+	if (entry) {
+		dstr_copy(file, entry->file);
+		pthread_mutex_unlock(&cache.mutex);
+		return;
+	}
+	const char *ext = os_get_path_extension(url);
+	if (!ext || strlen(ext) > 8 || strpbrk(ext, "/\\?&#"))
+		ext = "";
+	unsigned long long hash = (unsigned long long)media_cache_hash(url);
+	dstr_printf(file, "%s/%016llX%s", cache.dir, hash, ext);
+	for (int n = 1; media_cache_file_taken(url, file->array); n++)
+		dstr_printf(file, "%s/%016llX-%d%s", cache.dir, hash, n, ext);
+	pthread_mutex_unlock(&cache.mutex);
+}
+
+/* moves the download in place of the file, false when the old one is still there */
+static bool media_cache_replace(const char *from, const char *file)
+{
+	if (os_unlink(file) != 0 && os_file_exists(file))
+		return false;
+	return os_rename(from, file) == 0;
+}
+
+static void media_cache_swap_pending(struct media_cache_entry *entry)
+{
+	struct dstr pending;
+	dstr_init(&pending);
+	media_cache_pending_file(entry, &pending);
+	if (media_cache_replace(pending.array, entry->file)) {
+		cache.total -= entry->size;
+		entry->crc = entry->pending_crc;
+		entry->size = entry->pending_size;
+		cache.total += entry->size;
+		entry->pending = false;
+		cache.dirty = true;
+		blog(LOG_INFO, "[Playout Source] replaced '%s' in media cache", entry->url);
+	}
+	dstr_free(&pending);
+}
+
+static bool media_cache_download(const char *url, const char *checksum)
+{
+	struct dstr file;
+	dstr_init(&file);
+	media_cache_local_file(url, &file);
+	struct dstr part;
+	dstr_init_copy(&part, file.array);
+	dstr_cat(&part, ".part");
+
+	struct media_cache_download d = {0};
+	d.file = os_fopen(part.array, "wb");
+	bool success = false;
+	if (d.file) {
+		success = media_cache_fetch(url, &d);
+		if (fclose(d.file) != 0)
+			success = false;
+	}
+	if (success && !media_cache_checksum_matches(checksum, d.crc)) {
+		blog(LOG_WARNING, "[Playout Source] checksum mismatch for '%s': expected %s, got %08X", url, checksum, d.crc);
+		success = false;
+	}
+	if (!success) {
+		os_unlink(part.array);
+		dstr_free(&part);
+		dstr_free(&file);
+		return false;
+	}
+
+	/* a pinned file may be open in a decoder, the new one replaces it once unpinned */
+	pthread_mutex_lock(&cache.mutex);
+	struct media_cache_entry *entry = media_cache_find_entry(url);
+	if (entry && entry->pins) {
+		struct dstr pending;
+		dstr_init(&pending);
+		media_cache_pending_file(entry, &pending);
+		success = media_cache_replace(part.array, pending.array);
+		dstr_free(&pending);
+		if (success) {
+			entry->pending = true;
+			entry->pending_crc = d.crc;
+			entry->pending_size = d.size;
+		}
+	} else {
+		success = media_cache_replace(part.array, file.array);
+	}
+	if (success && (!entry || !entry->pins)) {
+		if (entry) {
+			media_cache_unlink_pending(entry);
+			cache.total -= entry->size;
+		} else {
+			entry = da_push_back_new(cache.entries);
+			entry->url = bstrdup(url);
+			entry->file = bstrdup(file.array);
+		}
+		entry->crc = d.crc;
+		entry->size = d.size;
+		entry->pending = false;
+		cache.total += d.size;
+	}
+	if (success) {
+		entry->last_used = (int64_t)time(NULL);
+		cache.dirty = true;
+		media_cache_evict(url);
+	} else {
+		os_unlink(part.array);
+	}
+	pthread_mutex_unlock(&cache.mutex);
+	if (success)
+		blog(LOG_INFO, "[Playout Source] cached '%s' (%llu bytes)", url, (unsigned long long)d.size);
+	dstr_free(&part);
+	dstr_free(&file);
+	return success;
+}
+
+static bool media_cache_next_job(char **url, char **checksum)
+{
+	uint64_t now = os_gettime_ns();
+	struct media_cache_job *next = NULL;
+	pthread_mutex_lock(&cache.mutex);
+	for (size_t i = 0; i < cache.jobs.num; i++) {
+		struct media_cache_job *job = &cache.jobs.array[i];
+		if (job->retry_ns > now)
+			continue;
+		/* playlists request the files they still need on every prefetch, a
+		 * failed download nobody asked for again since is dropped */
+		if (job->retry_ns && job->requested_ns < job->retry_ns - MEDIA_CACHE_RETRY_NS) {
+			blog(LOG_INFO, "[Playout Source] dropped download of '%s', no longer requested", job->url);
+			media_cache_job_free(job);
+			da_erase(cache.jobs, i--);
+			continue;
+		}
+		if (!next || job->due_ns < next->due_ns)
+			next = job;
+	}
+	if (next) {
+		*url = bstrdup(next->url);
+		*checksum = bstrdup(next->checksum);
+	}
+	pthread_mutex_unlock(&cache.mutex);
+	return next != NULL;
+}
+
+static void *media_cache_thread(void *param)
+{
+	UNUSED_PARAMETER(param);
+	os_set_thread_name("playout_media_cache");
+	while (!os_atomic_load_bool(&cache.stopping)) {
+		char *url = NULL;
+		char *checksum = NULL;
+		if (!media_cache_next_job(&url, &checksum)) {
+			if (cache.dirty)
+				media_cache_save_index();
+			os_event_timedwait(cache.event, 1000);
+			continue;
+		}
+		bool success = media_cache_download(url, checksum);
+		pthread_mutex_lock(&cache.mutex);
+		struct media_cache_job *job = media_cache_find_job(url);
+		if (job && success) {
+			media_cache_job_free(job);
+			da_erase(cache.jobs, job - cache.jobs.array);
+		} else if (job) {
+			job->retry_ns = os_gettime_ns() + MEDIA_CACHE_RETRY_NS;
+		}
+		pthread_mutex_unlock(&cache.mutex);
+		bfree(url);
+		bfree(checksum);
+	}
+	return NULL;
+}
+
+void media_cache_init(void)
+{
+	pthread_mutex_init(&cache.mutex, NULL);
+	os_event_init(&cache.event, OS_EVENT_TYPE_AUTO);
+	cache.dir = obs_module_config_path("cache");
+	os_mkdirs(cache.dir);
+	cache.limit = 10ULL * 1024 * 1024 * 1024;
+	media_cache_load_index();
+#ifdef HAVE_CURL
+	curl_global_init(CURL_GLOBAL_ALL);
+#endif
+	cache.thread_created = pthread_create(&cache.thread, NULL, media_cache_thread, NULL) == 0;
+}
+
+void media_cache_free(void)
+{
+	os_atomic_set_bool(&cache.stopping, true);
+	if (cache.thread_created) {
+		os_event_signal(cache.event);
+		pthread_join(cache.thread, NULL);
+		cache.thread_created = false;
+	}
+	for (size_t i = 0; i < cache.entries.num; i++) {
+		if (cache.entries.array[i].pending)
+			media_cache_swap_pending(&cache.entries.array[i]);
+	}
+	if (cache.dirty)
+		media_cache_save_index();
+#ifdef HAVE_CURL
+	curl_global_cleanup();
+#endif
+	for (size_t i = 0; i < cache.entries.num; i++)
+		media_cache_entry_free(&cache.entries.array[i]);
+	da_free(cache.entries);
+	for (size_t i = 0; i < cache.jobs.num; i++)
+		media_cache_job_free(&cache.jobs.array[i]);
+	da_free(cache.jobs);
+	bfree(cache.dir);
+	cache.dir = NULL;
+	os_event_destroy(cache.event);
+	pthread_mutex_destroy(&cache.mutex);
+}
+
+void media_cache_set_limit(uint64_t bytes)
+{
+	pthread_mutex_lock(&cache.mutex);
+	if (cache.limit != bytes) {
+		cache.limit = bytes;
+		media_cache_evict("");
+	}
+	pthread_mutex_unlock(&cache.mutex);
+}
+
+char *media_cache_get(const char *url, const char *checksum)
+{
+	char *file = NULL;
+	pthread_mutex_lock(&cache.mutex);
+	struct media_cache_entry *entry = media_cache_find_entry(url);
+	if (entry && media_cache_checksum_matches(checksum, entry->crc)) {
+		int64_t now = (int64_t)time(NULL);
+		if (now - entry->last_used > 60) {
+			entry->last_used = now;
+			cache.dirty = true;
+		}
+		file = bstrdup(entry->file);
+		entry->pins++;
+	}
+	pthread_mutex_unlock(&cache.mutex);
+	return file;
+}
+
+/* unpins a file returned by media_cache_get */
+void media_cache_release(const char *url)
+{
+	if (!url)
+		return;
+	pthread_mutex_lock(&cache.mutex);
+	struct media_cache_entry *entry = media_cache_find_entry(url);
+	if (entry && entry->pins > 0 && --entry->pins == 0) {
+		if (entry->pending)
+			media_cache_swap_pending(entry);
+		if (cache.total > cache.limit)
+			media_cache_evict("");
+	}
+	pthread_mutex_unlock(&cache.mutex);
+}
+
+void media_cache_request(const char *url, const char *checksum, uint64_t due_ns)
+{
+	pthread_mutex_lock(&cache.mutex);
+	struct media_cache_entry *entry = media_cache_find_entry(url);
+	if (entry && (media_cache_checksum_matches(checksum, entry->crc) ||
+		      (entry->pending && media_cache_checksum_matches(checksum, entry->pending_crc)))) {
+		pthread_mutex_unlock(&cache.mutex);
+		return;
+	}
+	struct media_cache_job *job = media_cache_find_job(url);
+	if (!job) {
+		job = da_push_back_new(cache.jobs);
+		job->url = bstrdup(url);
+		job->checksum = bstrdup(checksum);
+		job->due_ns = due_ns;
+	} else if (due_ns < job->due_ns) {
+		job->due_ns = due_ns;
+	}
+	job->requested_ns = os_gettime_ns();
+	pthread_mutex_unlock(&cache.mutex);
+	os_event_signal(cache.event);
+}
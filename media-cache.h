@@ -0,0 +1,11 @@
+#pragma once
+#include <obs.h>
+
+void media_cache_init(void);
+void media_cache_free(void);
+void media_cache_set_limit(uint64_t bytes);
+
+bool media_cache_is_remote(const char *path);
+char *media_cache_get(const char *url, const char *checksum);
+void media_cache_release(const char *url);
+void media_cache_request(const char *url, const char *checksum, uint64_t due_ns);
@@ -0,0 +1,25 @@
+#include "metrics.h"
+#include <util/threading.h>
+
+void metrics_histogram_add(struct metrics_histogram *histogram, long value)
+{
+	if (value < 0)
+		value = 0;
+	int bucket = 0;
+	for (long v = value; v > 1 && bucket < METRICS_BUCKETS - 1; v >>= 1)
+		bucket++;
+	os_atomic_inc_long(&histogram->buckets[bucket]);
+	os_atomic_inc_long(&histogram->count);
+	long max = os_atomic_load_long(&histogram->max);
+	while (value > max && !os_atomic_compare_exchange_long(&histogram->max, &max, value))
+		;
+}
+
+void metrics_histogram_json(struct metrics_histogram *histogram, struct dstr *json, const char *name)
+{
+	dstr_catf(json, "\"%s\":{\"count\":%ld,\"max\":%ld,\"buckets\":[", name, os_atomic_load_long(&histogram->count),
+		  os_atomic_load_long(&histogram->max));
+	for (int i = 0; i < METRICS_BUCKETS; i++)
+		dstr_catf(json, i ? ",%ld" : "%ld", os_atomic_load_long(&histogram->buckets[i]));
+	dstr_cat(json, "]}");
+}
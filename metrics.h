@@ -0,0 +1,16 @@
+#pragma once
+#include <obs.h>
+#include <util/dstr.h>
+
+/* bucket 0 counts values up to 1, bucket n counts values from 2^n up to 2^(n+1),
+ * the last bucket counts everything above */
+#define METRICS_BUCKETS 16
+
+struct metrics_histogram {
+	volatile long count;
+	volatile long max;
+	volatile long buckets[METRICS_BUCKETS];
+};
+
+void metrics_histogram_add(struct metrics_histogram *histogram, long value);
+void metrics_histogram_json(struct metrics_histogram *histogram, struct dstr *json, const char *name);
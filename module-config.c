@@ -0,0 +1,176 @@
+#include "module-config.h"
+#include "filler.h"
+#include "integrity-scan.h"
+#include "media-cache.h"
+#include "proxy-cache.h"
+#include "trace.h"
+#include <obs-module.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+/* Options of the shared workers and caches exist once per process. They are
+ * shown with the properties of every playout source, but stored in the module
+ * config, so one source can not undo what another one set. */
+
+enum module_config_type {
+	MODULE_CONFIG_STRING,
+	MODULE_CONFIG_INT,
+	MODULE_CONFIG_DOUBLE,
+	MODULE_CONFIG_BOOL,
+};
+
+static const struct {
+	const char *name;
+	enum module_config_type type;
+} module_config_options[] = {
+	{"ffmpeg_path", MODULE_CONFIG_STRING},  {"cache_size_mb", MODULE_CONFIG_INT}, {"proxy_threads", MODULE_CONFIG_INT},
+	{"scan_threads", MODULE_CONFIG_INT},    {"scan_decode", MODULE_CONFIG_BOOL},  {"scan_rate", MODULE_CONFIG_DOUBLE},
+	{"trace", MODULE_CONFIG_BOOL},
+};
+
+#define MODULE_CONFIG_OPTIONS (sizeof(module_config_options) / sizeof(module_config_options[0]))
+
+static struct {
+	pthread_mutex_t mutex;
+	obs_data_t *data;
+	char *file;
+	bool saved;
+} config;
+
+static void module_config_copy(obs_data_t *to, obs_data_t *from, size_t i)
+{
+	const char *name = module_config_options[i].name;
+	switch (module_config_options[i].type) {
+	case MODULE_CONFIG_STRING:
+		obs_data_set_string(to, name, obs_data_get_string(from, name));
+		break;
+	case MODULE_CONFIG_INT:
+		obs_data_set_int(to, name, obs_data_get_int(from, name));
+		break;
+	case MODULE_CONFIG_DOUBLE:
+		obs_data_set_double(to, name, obs_data_get_double(from, name));
+		break;
+	case MODULE_CONFIG_BOOL:
+		obs_data_set_bool(to, name, obs_data_get_bool(from, name));
+		break;
+	}
+}
+
+static bool module_config_equal(obs_data_t *a, obs_data_t *b, size_t i)
+{
+	const char *name = module_config_options[i].name;
+	switch (module_config_options[i].type) {
+	case MODULE_CONFIG_STRING:
+		return strcmp(obs_data_get_string(a, name), obs_data_get_string(b, name)) == 0;
+	case MODULE_CONFIG_INT:
+		return obs_data_get_int(a, name) == obs_data_get_int(b, name);
+	case MODULE_CONFIG_DOUBLE:
+		return obs_data_get_double(a, name) == obs_data_get_double(b, name);
+	case MODULE_CONFIG_BOOL:
+		return obs_data_get_bool(a, name) == obs_data_get_bool(b, name);
+	}
+	return true;
+}
+
+static void module_config_apply(void)
+{
+	pthread_mutex_lock(&config.mutex);
+	obs_data_t *data = config.data;
+	obs_data_addref(data);
+	pthread_mutex_unlock(&config.mutex);
+	const char *ffmpeg_path = obs_data_get_string(data, "ffmpeg_path");
+	media_cache_set_limit((uint64_t)obs_data_get_int(data, "cache_size_mb") * 1024 * 1024);
+	proxy_cache_set_options(ffmpeg_path, (int)obs_data_get_int(data, "proxy_threads"));
+	integrity_scan_set_options(ffmpeg_path, (int)obs_data_get_int(data, "scan_threads"), obs_data_get_bool(data, "scan_decode"),
+				   obs_data_get_double(data, "scan_rate"));
+	filler_set_options(ffmpeg_path);
+	os_atomic_set_bool(&trace_enabled, obs_data_get_bool(data, "trace"));
+	obs_data_release(data);
+}
+
+static void module_config_save(void)
+{
+	pthread_mutex_lock(&config.mutex);
+	obs_data_save_json_safe(config.data, config.file, "tmp", "bak");
+	config.saved = true;
+	pthread_mutex_unlock(&config.mutex);
+}
+
+void module_config_init(void)
+{
+	pthread_mutex_init(&config.mutex, NULL);
+	char *dir = obs_module_config_path("");
+	os_mkdirs(dir);
+	bfree(dir);
+	config.file = obs_module_config_path("config.json");
+	config.data = obs_data_create_from_json_file_safe(config.file, "bak");
+	config.saved = config.data != NULL;
+	if (!config.data)
+		config.data = obs_data_create();
+	obs_data_set_default_string(config.data, "ffmpeg_path", "ffmpeg");
+	obs_data_set_default_int(config.data, "cache_size_mb", 10240);
+	obs_data_set_default_int(config.data, "proxy_threads", 2);
+	obs_data_set_default_int(config.data, "scan_threads", 1);
+	obs_data_set_default_double(config.data, "scan_rate", 4.0);
+	module_config_apply();
+}
+
+void module_config_free(void)
+{
+	obs_data_release(config.data);
+	config.data = NULL;
+	bfree(config.file);
+	config.file = NULL;
+	pthread_mutex_destroy(&config.mutex);
+}
+
+/* these options used to be saved with each source, the first source loaded
+ * before the module config existed brings its values along */
+void module_config_migrate(obs_data_t *settings)
+{
+	pthread_mutex_lock(&config.mutex);
+	bool migrate = !config.saved;
+	bool found = false;
+	for (size_t i = 0; migrate && i < MODULE_CONFIG_OPTIONS; i++) {
+		if (!obs_data_has_user_value(settings, module_config_options[i].name))
+			continue;
+		module_config_copy(config.data, settings, i);
+		found = true;
+	}
+	pthread_mutex_unlock(&config.mutex);
+	if (!found)
+		return;
+	module_config_save();
+	module_config_apply();
+}
+
+/* the properties of a source show the values of the module config */
+void module_config_to_settings(obs_data_t *settings)
+{
+	pthread_mutex_lock(&config.mutex);
+	for (size_t i = 0; i < MODULE_CONFIG_OPTIONS; i++)
+		module_config_copy(settings, config.data, i);
+	pthread_mutex_unlock(&config.mutex);
+}
+
+bool module_config_modified(obs_properties_t *props, obs_property_t *property, obs_data_t *settings)
+{
+	UNUSED_PARAMETER(props);
+	const char *name = obs_property_name(property);
+	bool changed = false;
+	pthread_mutex_lock(&config.mutex);
+	for (size_t i = 0; i < MODULE_CONFIG_OPTIONS; i++) {
+		if (strcmp(module_config_options[i].name, name) != 0)
+			continue;
+		changed = !module_config_equal(config.data, settings, i);
+		if (changed)
+			module_config_copy(config.data, settings, i);
+		break;
+	}
+	pthread_mutex_unlock(&config.mutex);
+	if (changed) {
+		module_config_save();
+		module_config_apply();
+	}
+	return false;
+}
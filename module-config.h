@@ -0,0 +1,9 @@
+#pragma once
+#include <obs.h>
+
+void module_config_init(void);
+void module_config_free(void);
+
+void module_config_migrate(obs_data_t *settings);
+void module_config_to_settings(obs_data_t *settings);
+bool module_config_modified(obs_properties_t *props, obs_property_t *property, obs_data_t *settings);
@@ -0,0 +1,141 @@
+#include "next-up-source.h"
+#include "playout-source.h"
+#include <obs-module.h>
+
+static const char *next_up_get_name(void *type_data)
+{
+	UNUSED_PARAMETER(type_data);
+	return obs_module_text("NextUp");
+}
+
+static void next_up_update(void *data, obs_data_t *settings)
+{
+	struct next_up_info *nu = data;
+	const char *name = obs_data_get_string(settings, "playout");
+	if (nu->playout_name && strcmp(nu->playout_name, name) == 0)
+		return;
+	bfree(nu->playout_name);
+	nu->playout_name = bstrdup(name);
+	obs_weak_source_release(nu->playout);
+	nu->playout = NULL;
+}
+
+static void *next_up_create(obs_data_t *settings, obs_source_t *source)
+{
+	struct next_up_info *nu = bzalloc(sizeof(struct next_up_info));
+	nu->source = source;
+	next_up_update(nu, settings);
+	return nu;
+}
+
+static void next_up_set_shown(struct next_up_info *nu, obs_source_t *source)
+{
+	if (nu->shown == source) {
+		obs_source_release(source);
+		return;
+	}
+	if (nu->shown) {
+		obs_source_dec_showing(nu->shown);
+		obs_source_release(nu->shown);
+	}
+	nu->shown = source;
+	if (nu->shown)
+		obs_source_inc_showing(nu->shown);
+}
+
+static void next_up_destroy(void *data)
+{
+	struct next_up_info *nu = data;
+	next_up_set_shown(nu, NULL);
+	obs_weak_source_release(nu->playout);
+	bfree(nu->playout_name);
+	bfree(data);
+}
+
+static obs_source_t *next_up_get_playout(struct next_up_info *nu)
+{
+	obs_source_t *source = obs_weak_source_get_source(nu->playout);
+	if (source || !nu->playout_name || !strlen(nu->playout_name))
+		return source;
+	source = obs_get_source_by_name(nu->playout_name);
+	if (!source)
+		return NULL;
+	if (strcmp(obs_source_get_unversioned_id(source), "playout_source") != 0) {
+		obs_source_release(source);
+		return NULL;
+	}
+	obs_weak_source_release(nu->playout);
+	nu->playout = obs_source_get_weak_source(source);
+	return source;
+}
+
+static void next_up_video_tick(void *data, float seconds)
+{
+	UNUSED_PARAMETER(seconds);
+	struct next_up_info *nu = data;
+	obs_source_t *next = NULL;
+	obs_source_t *source = next_up_get_playout(nu);
+	if (source) {
+		struct playout_source_context *playout = obs_obj_get_data(source);
+		if (playout)
+			next = playout_source_get_next_source(playout);
+		obs_source_release(source);
+	}
+	next_up_set_shown(nu, next);
+}
+
+static void next_up_video_render(void *data, gs_effect_t *effect)
+{
+	UNUSED_PARAMETER(effect);
+	struct next_up_info *nu = data;
+	if (nu->shown)
+		obs_source_video_render(nu->shown);
+}
+
+static uint32_t next_up_get_width(void *data)
+{
+	struct next_up_info *nu = data;
+	return nu->shown ? obs_source_get_width(nu->shown) : 0;
+}
+
+static uint32_t next_up_get_height(void *data)
+{
+	struct next_up_info *nu = data;
+	return nu->shown ? obs_source_get_height(nu->shown) : 0;
+}
+
+static bool next_up_add_playout(void *data, obs_source_t *source)
+{
+	obs_property_t *p = data;
+	if (strcmp(obs_source_get_unversioned_id(source), "playout_source") == 0) {
+		const char *name = obs_source_get_name(source);
+		obs_property_list_add_string(p, name, name);
+	}
+	return true;
+}
+
+static obs_properties_t *next_up_properties(void *data)
+{
+	UNUSED_PARAMETER(data);
+	obs_properties_t *props = obs_properties_create();
+	obs_property_t *p = obs_properties_add_list(props, "playout", obs_module_text("Playout"), OBS_COMBO_TYPE_LIST,
+						    OBS_COMBO_FORMAT_STRING);
+	obs_enum_sources(next_up_add_playout, p);
+	return props;
+}
+
+struct obs_source_info next_up_source = {
+	.id = "playout_next_up_source",
+	.type = OBS_SOURCE_TYPE_INPUT,
+	.output_flags = OBS_SOURCE_VIDEO | OBS_SOURCE_CUSTOM_DRAW | OBS_SOURCE_DO_NOT_DUPLICATE,
+	.icon_type = OBS_ICON_TYPE_MEDIA,
+	.get_name = next_up_get_name,
+	.create = next_up_create,
+	.destroy = next_up_destroy,
+	.update = next_up_update,
+	.video_tick = next_up_video_tick,
+	.video_render = next_up_video_render,
+	.get_width = next_up_get_width,
+	.get_height = next_up_get_height,
+	.get_properties = next_up_properties,
+};
@@ -0,0 +1,11 @@
+#pragma once
+#include <obs.h>
+
+struct next_up_info {
+	obs_source_t *source;
+	char *playout_name;
+	obs_weak_source_t *playout;
+	obs_source_t *shown;
+};
+
+extern struct obs_source_info next_up_source;
@@ -1,14 +1,76 @@
+#include "as-run.h"
 #include "audio-wrapper.h"
+#include "filler.h"
+#include "integrity-scan.h"
+#include "journal.h"
+#include "media-cache.h"
+#include "module-config.h"
+#include "next-up-source.h"
 #include "playout-source.h"
+#include "proxy-cache.h"
+#include "source-registry.h"
+#include "trace.h"
 #include "version.h"
+#include <graphics/vec4.h>
 #include <obs-frontend-api.h>
 #include <stdio.h>
+#include <time.h>
 #include <util/dstr.h>
 #include <util/platform.h>
+#include <util/profiler.h>
+#include <util/threading.h>
 
 #define PLAYBACK_MODE_LIST 0
 #define PLAYBACK_MODE_SECTION 1
 #define PLAYBACK_MODE_SINGLE 2
+#define PLAYBACK_MODE_SHUFFLE 3
+#define PLAYBACK_MODE_SHUFFLE_SECTION 4
+
+#define CUE_REQUEST_ID 0
+#define CUE_REQUEST_INDEX 1
+#define CUE_REQUEST_SECTION 2
+#define CUE_REQUEST_NEXT 3
+#define CUE_REQUEST_PREVIOUS 4
+#define CUE_REQUEST_NEXT_SECTION 5
+
+#define TAKE_REQUEST_NONE 0
+#define TAKE_REQUEST_TRANSITION 1
+#define TAKE_REQUEST_CUT 2
+
+#define DEFERRED_SCAN_PER_TICK 256
+#define DEFERRED_BUDGET_NS 2000000ULL
+
+#define RESUME_MODE_OFF 0
+#define RESUME_MODE_POSITION 1
+#define RESUME_MODE_SCHEDULE 2
+
+#define RESUME_WAIT_SECONDS 5.0f
+
+#define EVENT_ACTION_SHOW 0
+#define EVENT_ACTION_HIDE 1
+#define EVENT_ACTION_ENABLE_FILTER 2
+#define EVENT_ACTION_DISABLE_FILTER 3
+#define EVENT_ACTION_HOTKEY 4
+
+#define EVENTS_SEEK_MS 1000
+
+#define FILLER_MIN_GAP_MS 100
+/* items whose length is not known yet, like deferred ones without a source,
+ * count this long against the prefetch window */
+#define PREFETCH_UNKNOWN_LENGTH_MS 60000
+/* the memory estimate takes RGBA frames, a media source holds the frame on
+ * screen and about two decoded ahead of it, other sources one frame */
+#define ESTIMATE_BYTES_PER_PIXEL 4
+#define ESTIMATE_MEDIA_FRAMES 3
+#define DAY_MS 86400000LL
+
+#define DECODE_DEFAULT 0
+#define DECODE_HARDWARE 1
+#define DECODE_SOFTWARE 2
+
+#define SCALE_MODE_FIT 0
+#define SCALE_MODE_FILL 1
+#define SCALE_MODE_STRETCH 2
 
 #define PLAYOUT_ACTION_NONE 0
 #define PLAYOUT_ACTION_ADD_ITEM_TOP 1
@@ -25,6 +87,15 @@
 #define PLAYOUT_ACTION_SELECT_NONE 12
 #define PLAYOUT_ACTION_SELECTION_INVERT 13
 
+static const char *profile_update_name = "playout_source_update";
+static const char *profile_switch_name = "playout_source_switch_to_next_item";
+static const char *profile_tick_name = "playout_source_video_tick";
+static const char *profile_action_name = "playout_source_action";
+static const char *trace_current_name = "update_current_source";
+static const char *trace_transition_stop_name = "transition_stop";
+static const char *trace_media_ended_name = "media_ended";
+static const char *trace_media_started_name = "media_started";
+
 #define PLUGIN_INFO                                                                                      \
 	"<a href=\"https://github.com/exeldro/obs-playout-source\">Playout Source</a> (" PROJECT_VERSION \
 	") by <a href=\"https://www.exeldro.com\">Exeldro</a>"
@@ -35,27 +106,777 @@ static const char *playout_source_get_name(void *type_data)
 	return obs_module_text("Playout");
 }
 
+static void playout_source_get_metrics(void *data, calldata_t *cd)
+{
+	struct playout_source_context *playout = data;
+	struct playout_metrics *metrics = &playout->metrics;
+	struct dstr json;
+	dstr_init_copy(&json, "{");
+	metrics_histogram_json(&metrics->tick_us, &json, "video_tick_us");
+	dstr_cat_ch(&json, ',');
+	metrics_histogram_json(&metrics->audio_render_us, &json, "audio_render_us");
+	dstr_cat_ch(&json, ',');
+	metrics_histogram_json(&metrics->switch_late_ms, &json, "switch_late_ms");
+	dstr_cat_ch(&json, ',');
+	metrics_histogram_json(&metrics->seek_ms, &json, "seek_first_frame_ms");
+	dstr_catf(&json, ",\"decoders\":%ld,\"transitions\":%ld,\"memory_estimate_kb\":%ld}",
+		  os_atomic_load_long(&metrics->decoders), os_atomic_load_long(&metrics->transitions),
+		  os_atomic_load_long(&metrics->memory_kb));
+	calldata_set_string(cd, "json", json.array);
+	dstr_free(&json);
+}
+
+static void playout_source_dump_trace(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	char *path = trace_dump();
+	calldata_set_string(cd, "path", path);
+	bfree(path);
+}
+
+static void playout_source_edit_items(void *data, calldata_t *cd);
+
+/* the tick checks the pending flags instead of the arrays, which only change under the mutex */
+static void playout_source_queue_edits(struct playout_source_context *playout, obs_data_t *request)
+{
+	pthread_mutex_lock(&playout->edits_mutex);
+	da_push_back(playout->edits, &request);
+	os_atomic_set_bool(&playout->edits_pending, true);
+	pthread_mutex_unlock(&playout->edits_mutex);
+}
+
+static void playout_source_request_cue(struct playout_source_context *playout, int type, long value, const char *section)
+{
+	pthread_mutex_lock(&playout->edits_mutex);
+	struct playout_cue_request *request = da_push_back_new(playout->cue_requests);
+	request->type = type;
+	request->value = value;
+	request->section = section ? bstrdup(section) : NULL;
+	os_atomic_set_bool(&playout->cues_pending, true);
+	pthread_mutex_unlock(&playout->edits_mutex);
+}
+
+static void playout_source_cue_proc(void *data, calldata_t *cd)
+{
+	playout_source_request_cue(data, CUE_REQUEST_ID, (long)calldata_int(cd, "id"), NULL);
+}
+
+static void playout_source_cue_index_proc(void *data, calldata_t *cd)
+{
+	playout_source_request_cue(data, CUE_REQUEST_INDEX, (long)calldata_int(cd, "index"), NULL);
+}
+
+static void playout_source_cue_section_proc(void *data, calldata_t *cd)
+{
+	playout_source_request_cue(data, CUE_REQUEST_SECTION, 0, calldata_string(cd, "section"));
+}
+
+static void playout_source_take_proc(void *data, calldata_t *cd)
+{
+	struct playout_source_context *playout = data;
+	os_atomic_set_long(&playout->take_request, calldata_bool(cd, "cut") ? TAKE_REQUEST_CUT : TAKE_REQUEST_TRANSITION);
+}
+
+static void playout_source_cue_next_hotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
+{
+	UNUSED_PARAMETER(id);
+	UNUSED_PARAMETER(hotkey);
+	if (pressed)
+		playout_source_request_cue(data, CUE_REQUEST_NEXT, 0, NULL);
+}
+
+static void playout_source_cue_previous_hotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
+{
+	UNUSED_PARAMETER(id);
+	UNUSED_PARAMETER(hotkey);
+	if (pressed)
+		playout_source_request_cue(data, CUE_REQUEST_PREVIOUS, 0, NULL);
+}
+
+static void playout_source_cue_section_hotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
+{
+	UNUSED_PARAMETER(id);
+	UNUSED_PARAMETER(hotkey);
+	if (pressed)
+		playout_source_request_cue(data, CUE_REQUEST_NEXT_SECTION, 0, NULL);
+}
+
+static void playout_source_take_hotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
+{
+	UNUSED_PARAMETER(id);
+	UNUSED_PARAMETER(hotkey);
+	struct playout_source_context *playout = data;
+	if (pressed)
+		os_atomic_set_long(&playout->take_request, TAKE_REQUEST_TRANSITION);
+}
+
+static void playout_source_take_cut_hotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
+{
+	UNUSED_PARAMETER(id);
+	UNUSED_PARAMETER(hotkey);
+	struct playout_source_context *playout = data;
+	if (pressed)
+		os_atomic_set_long(&playout->take_request, TAKE_REQUEST_CUT);
+}
+
+static const char *playout_source_signals[] = {
+	"void item_changed(ptr source, int index, int id, string path)",
+	"void section_changed(ptr source, string section)",
+	"void transition_started(ptr source, int index, int duration)",
+	"void remaining_time(ptr source, int index, int remaining, int duration)",
+	NULL,
+};
+
 static void *playout_source_create(obs_data_t *settings, obs_source_t *source)
 {
-	UNUSED_PARAMETER(settings);
+	module_config_migrate(settings);
 	struct playout_source_context *playout = bzalloc(sizeof(struct playout_source_context));
 	playout->source = source;
 	playout->current_index = -1;
+	playout->current_source_index = -1;
+	playout->loop_index = -1;
+	pthread_mutex_init(&playout->edits_mutex, NULL);
+	pthread_mutex_init(&playout->next_mutex, NULL);
 	playout->audio_wrapper = obs_source_create_private(audio_wrapper_source.id, audio_wrapper_source.id, NULL);
 	struct audio_wrapper_info *aw = obs_obj_get_data(playout->audio_wrapper);
 	aw->playout = playout;
+	signal_handler_add_array(obs_source_get_signal_handler(source), playout_source_signals);
+	proc_handler_t *ph = obs_source_get_proc_handler(source);
+	proc_handler_add(ph, "void get_metrics(out string json)", playout_source_get_metrics, playout);
+	proc_handler_add(ph, "void dump_trace(out string path)", playout_source_dump_trace, playout);
+	proc_handler_add(ph, "void edit_items(in string json, out string result)", playout_source_edit_items, playout);
+	proc_handler_add(ph, "void cue(in int id)", playout_source_cue_proc, playout);
+	proc_handler_add(ph, "void cue_index(in int index)", playout_source_cue_index_proc, playout);
+	proc_handler_add(ph, "void cue_section(in string section)", playout_source_cue_section_proc, playout);
+	proc_handler_add(ph, "void take(in bool cut)", playout_source_take_proc, playout);
+	obs_hotkey_register_source(source, "playout_source.cue_next", obs_module_text("CueNext"),
+				   playout_source_cue_next_hotkey, playout);
+	obs_hotkey_register_source(source, "playout_source.cue_previous", obs_module_text("CuePrevious"),
+				   playout_source_cue_previous_hotkey, playout);
+	obs_hotkey_register_source(source, "playout_source.cue_next_section", obs_module_text("CueNextSection"),
+				   playout_source_cue_section_hotkey, playout);
+	obs_hotkey_register_source(source, "playout_source.take", obs_module_text("Take"), playout_source_take_hotkey,
+				   playout);
+	obs_hotkey_register_source(source, "playout_source.take_cut", obs_module_text("TakeCut"),
+				   playout_source_take_cut_hotkey, playout);
+	playout->journal_id = journal_open(obs_data_get_string(settings, "journal_id"), obs_source_get_name(source));
+	obs_data_set_string(settings, "journal_id", playout->journal_id);
+	if (obs_data_get_int(settings, "resume_mode") != RESUME_MODE_OFF) {
+		int64_t media_ms;
+		int64_t wall_ms;
+		if (journal_read_last(playout->journal_id, &playout->resume_id, &media_ms, &wall_ms)) {
+			playout->resume_pending = true;
+			playout->resume_offset_ms = media_ms > 0 ? media_ms : 0;
+			int64_t behind = as_run_now_ms() - wall_ms;
+			if (obs_data_get_int(settings, "resume_mode") == RESUME_MODE_SCHEDULE && behind > 0)
+				playout->resume_offset_ms += behind;
+		}
+	}
 	obs_source_update(source, settings);
 	return playout;
 }
 
-static void playout_source_destroy(void *data)
+static void playout_source_media_ended(void *data, calldata_t *cd);
+static void playout_source_media_started(void *data, calldata_t *cd);
+
+static obs_data_t *playout_source_item_settings(const char *path, struct playout_source_item *item)
 {
-	struct playout_source_context *playout = data;
-	if (playout->audio_wrapper) {
-		obs_source_release(playout->audio_wrapper);
-		playout->audio_wrapper = NULL;
+	obs_data_t *ss = obs_data_create();
+	obs_data_set_bool(ss, "is_local_file", true);
+	obs_data_set_string(ss, "local_file", path);
+	obs_data_set_bool(ss, "looping", false);
+	obs_data_set_bool(ss, "is_stinger", false);
+	obs_data_set_bool(ss, "hw_decode", item->hw_decode);
+	obs_data_set_int(ss, "buffering_mb", item->buffering_mb);
+	obs_data_set_bool(ss, "close_when_inactive", false);
+	obs_data_set_bool(ss, "clear_on_media_end", false);
+	obs_data_set_bool(ss, "restart_on_activate", false);
+	obs_data_set_int(ss, "speed_percent", item->speed);
+	return ss;
+}
+
+static void playout_source_item_connect(struct playout_source_context *playout, obs_source_t *source)
+{
+	signal_handler_t *sh = obs_source_get_signal_handler(source);
+	signal_handler_connect(sh, "media_ended", playout_source_media_ended, playout);
+	signal_handler_connect(sh, "media_started", playout_source_media_started, playout);
+}
+
+static void playout_source_item_disconnect(struct playout_source_context *playout, obs_source_t *source)
+{
+	signal_handler_t *sh = obs_source_get_signal_handler(source);
+	signal_handler_disconnect(sh, "media_ended", playout_source_media_ended, playout);
+	signal_handler_disconnect(sh, "media_started", playout_source_media_started, playout);
+}
+
+static void playout_source_item_create_private(struct playout_source_context *playout, int i, obs_data_t *settings)
+{
+	struct dstr name;
+	dstr_init(&name);
+	dstr_printf(&name, "%s (%d)", obs_source_get_name(playout->source), i + 1);
+	playout->items.array[i].source = obs_source_create_private("ffmpeg_source", name.array, settings);
+	playout->items.array[i].shared = false;
+	dstr_free(&name);
+	playout_source_item_connect(playout, playout->items.array[i].source);
+}
+
+/* the cache keeps the file of an item until it is released here */
+static void playout_source_item_release_cached(struct playout_source_item *item)
+{
+	if (!item->cached_path)
+		return;
+	media_cache_release(item->path);
+	bfree(item->cached_path);
+	item->cached_path = NULL;
+}
+
+/* a remote item that is not cached yet plays the filler instead */
+static bool playout_source_item_on_filler(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	return item->remote && !item->proxy_path && !item->cached_path && playout->filler_path && strlen(playout->filler_path);
+}
+
+static const char *playout_source_item_file(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	if (item->proxy_path)
+		return item->proxy_path;
+	if (!item->remote)
+		return item->path;
+	if (item->cached_path)
+		return item->cached_path;
+	if (playout_source_item_on_filler(playout, item))
+		return playout->filler_path;
+	return item->path;
+}
+
+/* start and end are the trims of the file on air, the filler plays untrimmed */
+static void playout_source_item_apply_trims(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	bool filler = playout_source_item_on_filler(playout, item);
+	item->start = filler ? 0 : item->trim_start;
+	item->end = filler ? 0 : item->trim_end;
+}
+
+/* media items share a decoder only when they decode the same file the same way */
+static void playout_source_item_media_key(struct playout_source_item *item, const char *file, struct dstr *key)
+{
+	dstr_printf(key, "%s|%u|%d|%d", file, item->speed, item->hw_decode, item->buffering_mb);
+}
+
+static void playout_source_item_create_shared(struct playout_source_context *playout, int i)
+{
+	struct playout_source_item *item = &playout->items.array[i];
+	const char *file = strrchr(item->path, '/');
+	const char *file2 = strrchr(item->path, '\\');
+	if (file2 > file)
+		file = file2;
+	const char *id;
+	obs_data_t *ss;
+	struct dstr key;
+	dstr_init(&key);
+	struct dstr name;
+	dstr_init_copy(&name, "Playout shared ");
+	if (item->type == PLAYOUT_ITEM_TYPE_IMAGE) {
+		id = "image_source";
+		dstr_copy(&key, item->path);
+		dstr_cat(&name, file ? file + 1 : item->path);
+		ss = obs_data_create();
+		obs_data_set_string(ss, "file", item->path);
+		obs_data_set_bool(ss, "unload", false);
+	} else if (item->type == PLAYOUT_ITEM_TYPE_COLOR) {
+		struct obs_video_info ovi;
+		if (!obs_get_video_info(&ovi)) {
+			ovi.base_width = 1920;
+			ovi.base_height = 1080;
+		}
+		id = "color_source_v3";
+		dstr_printf(&key, "%08X|%ux%u", item->color, ovi.base_width, ovi.base_height);
+		dstr_cat(&name, key.array);
+		ss = obs_data_create();
+		obs_data_set_int(ss, "color", item->color);
+		obs_data_set_int(ss, "width", ovi.base_width);
+		obs_data_set_int(ss, "height", ovi.base_height);
+	} else {
+		const char *local_file = playout_source_item_file(playout, item);
+		id = "ffmpeg_source";
+		playout_source_item_media_key(item, local_file, &key);
+		dstr_cat(&name, file ? file + 1 : item->path);
+		ss = playout_source_item_settings(local_file, item);
+	}
+	bool first = false;
+	item->source = source_registry_acquire(id, key.array, name.array, ss, playout, &first);
+	item->shared = true;
+	obs_data_release(ss);
+	dstr_free(&name);
+	dstr_free(&key);
+	if (first && item->type == PLAYOUT_ITEM_TYPE_MEDIA)
+		playout_source_item_connect(playout, item->source);
+}
+
+static void playout_source_item_release_reference(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	if (!item->source)
+		return;
+	if (item->until_end)
+		signal_handler_disconnect(obs_source_get_signal_handler(item->source), "media_ended", playout_source_media_ended,
+					  playout);
+	obs_source_release(item->source);
+	item->source = NULL;
+}
+
+/* the source is looked up by name only while the weak reference is missing or expired */
+static obs_source_t *playout_source_item_reference(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	obs_source_t *source = obs_weak_source_get_source(item->weak_source);
+	if (source)
+		return source;
+	obs_weak_source_release(item->weak_source);
+	item->weak_source = NULL;
+	if (!item->path || !strlen(item->path))
+		return NULL;
+	source = obs_get_source_by_name(item->path);
+	if (source == playout->source) {
+		obs_source_release(source);
+		return NULL;
+	}
+	if (source)
+		item->weak_source = obs_source_get_weak_source(source);
+	return source;
+}
+
+static void playout_source_item_resolve_reference(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	if (item->source)
+		return;
+	item->source = playout_source_item_reference(playout, item);
+	if (!item->source)
+		return;
+	if (item->until_end) {
+		signal_handler_connect(obs_source_get_signal_handler(item->source), "media_ended", playout_source_media_ended,
+				       playout);
+		enum obs_media_state state = obs_source_media_get_state(item->source);
+		if (state == OBS_MEDIA_STATE_ENDED || state == OBS_MEDIA_STATE_STOPPED)
+			obs_source_media_restart(item->source);
+	}
+}
+
+static void playout_source_item_release_source(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	if (item->type == PLAYOUT_ITEM_TYPE_SOURCE) {
+		playout_source_item_release_reference(playout, item);
+		obs_weak_source_release(item->weak_source);
+		item->weak_source = NULL;
+		return;
+	}
+	if (!item->source)
+		return;
+	if (item->shared && source_registry_release(item->source, playout) && item->type == PLAYOUT_ITEM_TYPE_MEDIA)
+		playout_source_item_disconnect(playout, item->source);
+	obs_source_release(item->source);
+	item->source = NULL;
+	item->shared = false;
+	item->private_fallback = false;
+}
+
+static bool playout_source_item_controlled(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	return !item->shared || !source_registry_claimed_by_other(item->source, playout);
+}
+
+/* A shared decoder that is on air in another playout, or for the item before,
+ * can not be cued for this item. It plays from a private decoder instead until
+ * playout_source_share_again hands it back to the registry. */
+static void playout_source_item_use_private(struct playout_source_context *playout, int i)
+{
+	struct playout_source_item *item = &playout->items.array[i];
+	playout_source_item_release_source(playout, item);
+	obs_data_t *ss = playout_source_item_settings(playout_source_item_file(playout, item), item);
+	playout_source_item_create_private(playout, i, ss);
+	obs_data_release(ss);
+	item->private_fallback = true;
+}
+
+static void playout_source_item_release_still(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	source_registry_release(item->still, playout);
+	obs_source_release(item->still);
+	item->still = NULL;
+	bfree(item->still_path);
+	item->still_path = NULL;
+}
+
+/* stills come from the registry under the same key as image items, so a still
+ * that is also an image item, or the still of several items, is loaded once */
+static void playout_source_item_set_still(struct playout_source_context *playout, struct playout_source_item *item,
+					  const char *path)
+{
+	if (strcmp(item->still_path ? item->still_path : "", path) == 0)
+		return;
+	playout_source_item_release_still(playout, item);
+	if (!strlen(path))
+		return;
+	item->still_path = bstrdup(path);
+	const char *file = strrchr(path, '/');
+	const char *file2 = strrchr(path, '\\');
+	if (file2 > file)
+		file = file2;
+	struct dstr name;
+	dstr_init_copy(&name, "Playout shared ");
+	dstr_cat(&name, file ? file + 1 : path);
+	obs_data_t *ss = obs_data_create();
+	obs_data_set_string(ss, "file", path);
+	obs_data_set_bool(ss, "unload", false);
+	item->still = source_registry_acquire("image_source", path, name.array, ss, playout, NULL);
+	obs_data_release(ss);
+	dstr_free(&name);
+}
+
+static bool playout_source_item_frame_ready(struct playout_source_item *item, obs_source_t *source)
+{
+	return item->audio_only || obs_source_get_width(source) > 0;
+}
+
+static bool playout_source_item_check_proxy(struct playout_source_item *item, const char *file)
+{
+	if (!item->use_proxy || !file) {
+		if (!item->proxy_path)
+			return false;
+		bfree(item->proxy_path);
+		item->proxy_path = NULL;
+		return true;
+	}
+	if (item->proxy_path)
+		return false;
+	item->proxy_path = proxy_cache_get(file, item->audio_only);
+	if (item->proxy_path)
+		return true;
+	proxy_cache_request(file, item->audio_only);
+	return false;
+}
+
+/* ffmpeg_source can not skip the video stream of a file, so an audio-only item
+ * gets no decoder until its audio-only proxy exists and is skipped meanwhile */
+static bool playout_source_item_awaits_proxy(struct playout_source_item *item)
+{
+	return item->type == PLAYOUT_ITEM_TYPE_MEDIA && item->audio_only && !item->proxy_path;
+}
+
+static void playout_source_item_create(struct playout_source_context *playout, int i)
+{
+	struct playout_source_item *item = &playout->items.array[i];
+	if (item->type == PLAYOUT_ITEM_TYPE_SOURCE || playout_source_item_awaits_proxy(item))
+		return;
+	playout_source_item_apply_trims(playout, item);
+	if (playout->share_decoders || item->type != PLAYOUT_ITEM_TYPE_MEDIA) {
+		playout_source_item_create_shared(playout, i);
+	} else {
+		obs_data_t *ss = playout_source_item_settings(playout_source_item_file(playout, item), item);
+		playout_source_item_create_private(playout, i, ss);
+		obs_data_release(ss);
+	}
+}
+
+static bool playout_source_item_create_deferred(struct playout_source_context *playout, int i)
+{
+	struct playout_source_item *item = &playout->items.array[i];
+	if (!item->deferred)
+		return false;
+	item->deferred = false;
+	if (!item->source)
+		playout_source_item_create(playout, i);
+	return true;
+}
+
+static void playout_source_loop_release(struct playout_source_context *playout)
+{
+	if (!playout->loop_source)
+		return;
+	if (playout->loop_shared) {
+		source_registry_unclaim(playout->loop_source, playout);
+		if (source_registry_release(playout->loop_source, playout))
+			playout_source_item_disconnect(playout, playout->loop_source);
+	}
+	obs_source_release(playout->loop_source);
+	playout->loop_source = NULL;
+	playout->loop_shared = false;
+	playout->loop_seek = false;
+	playout->loop_ready = false;
+	playout->loop_index = -1;
+}
+
+static void playout_source_free_events(struct darray *events)
+{
+	struct playout_event *array = events->array;
+	for (size_t i = 0; i < events->num; i++) {
+		bfree(array[i].target);
+		bfree(array[i].name);
+	}
+	darray_free(events);
+}
+
+/* The events wheel points into item->events, so update never frees them. The
+ * events of a removed item are retired and freed on the next tick, after the
+ * wheel was reset. */
+static void playout_source_item_retire_events(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	pthread_mutex_lock(&playout->edits_mutex);
+	if (item->events.num) {
+		da_push_back(playout->events_retired, &item->events.da);
+		da_init(item->events);
+	} else {
+		da_free(item->events);
+	}
+	playout_source_free_events(&item->new_events.da);
+	item->events_changed = false;
+	os_atomic_set_bool(&playout->events_changed, true);
+	pthread_mutex_unlock(&playout->edits_mutex);
+}
+
+static bool playout_source_events_equal(const struct darray *a, const struct darray *b)
+{
+	if (a->num != b->num)
+		return false;
+	const struct playout_event *x = a->array;
+	const struct playout_event *y = b->array;
+	for (size_t i = 0; i < a->num; i++) {
+		if (x[i].offset_ms != y[i].offset_ms || x[i].action != y[i].action || strcmp(x[i].target, y[i].target) != 0 ||
+		    strcmp(x[i].name ? x[i].name : "", y[i].name ? y[i].name : "") != 0)
+			return false;
+	}
+	return true;
+}
+
+/* runs on the tick, the only place item->events is replaced */
+static void playout_source_swap_events(struct playout_source_context *playout)
+{
+	if (!os_atomic_load_bool(&playout->events_changed))
+		return;
+	pthread_mutex_lock(&playout->edits_mutex);
+	os_atomic_set_bool(&playout->events_changed, false);
+	timer_wheel_reset(&playout->events_wheel, playout->events_wheel.now);
+	playout->events_reload = true;
+	for (size_t i = 0; i < playout->items.num; i++) {
+		struct playout_source_item *item = &playout->items.array[i];
+		if (!item->events_changed)
+			continue;
+		playout_source_free_events(&item->events.da);
+		da_move(item->events, item->new_events);
+		item->events_changed = false;
+	}
+	for (size_t i = 0; i < playout->events_retired.num; i++)
+		playout_source_free_events(&playout->events_retired.array[i]);
+	da_free(playout->events_retired);
+	pthread_mutex_unlock(&playout->edits_mutex);
+}
+
+static const char *playout_event_actions[] = {"show", "hide", "enable", "disable", "hotkey", NULL};
+
+/* events are written as "<time> <action> <target>[ | <name>]", the time as
+ * seconds or [[hh:]mm:]ss.mmm, the name is the scene for show and hide and the
+ * filter for enable and disable */
+static bool playout_source_parse_event(const char *text, struct playout_event *event)
+{
+	double seconds = 0.0;
+	const char *p = text;
+	while (*p == ' ')
+		p++;
+	while (true) {
+		char *end;
+		double value = strtod(p, &end);
+		if (end == p)
+			return false;
+		seconds = seconds * 60.0 + value;
+		p = end;
+		if (*p != ':')
+			break;
+		p++;
+	}
+	while (*p == ' ')
+		p++;
+	const char *action_end = strchr(p, ' ');
+	if (!action_end)
+		return false;
+	event->action = -1;
+	for (int i = 0; playout_event_actions[i]; i++) {
+		if ((size_t)(action_end - p) == strlen(playout_event_actions[i]) &&
+		    astrcmpi_n(p, playout_event_actions[i], action_end - p) == 0)
+			event->action = i;
+	}
+	if (event->action < 0 || seconds < 0.0)
+		return false;
+	struct dstr target;
+	dstr_init_copy(&target, action_end + 1);
+	struct dstr name;
+	dstr_init(&name);
+	const char *separator = target.array ? strstr(target.array, " | ") : NULL;
+	if (separator) {
+		dstr_copy(&name, separator + 3);
+		dstr_resize(&target, separator - target.array);
+	}
+	dstr_depad(&target);
+	dstr_depad(&name);
+	if (dstr_is_empty(&target)) {
+		dstr_free(&target);
+		dstr_free(&name);
+		return false;
+	}
+	event->offset_ms = (uint64_t)(seconds * 1000.0 + 0.5);
+	event->target = target.array;
+	event->name = name.array;
+	return true;
+}
+
+static void playout_source_item_load_events(struct playout_source_context *playout, struct playout_source_item *item,
+					    obs_data_array_t *events)
+{
+	DARRAY(struct playout_event) parsed;
+	da_init(parsed);
+	size_t count = obs_data_array_count(events);
+	for (size_t i = 0; i < count; i++) {
+		obs_data_t *event_data = obs_data_array_item(events, i);
+		const char *text = obs_data_get_string(event_data, "value");
+		struct playout_event event = {0};
+		if (playout_source_parse_event(text, &event))
+			da_push_back(parsed, &event);
+		else if (strlen(text))
+			blog(LOG_WARNING, "[Playout Source] '%s' ignoring event '%s'", obs_source_get_name(playout->source), text);
+		obs_data_release(event_data);
+	}
+	pthread_mutex_lock(&playout->edits_mutex);
+	if (playout_source_events_equal(item->events_changed ? &item->new_events.da : &item->events.da, &parsed.da)) {
+		pthread_mutex_unlock(&playout->edits_mutex);
+		playout_source_free_events(&parsed.da);
+		return;
+	}
+	playout_source_free_events(&item->new_events.da);
+	da_move(item->new_events, parsed);
+	item->events_changed = true;
+	os_atomic_set_bool(&playout->events_changed, true);
+	pthread_mutex_unlock(&playout->edits_mutex);
+}
+
+static bool playout_source_find_hotkey(void *data, obs_hotkey_id id, obs_hotkey_t *key)
+{
+	struct playout_event *event = data;
+	if (strcmp(obs_hotkey_get_name(key), event->target) != 0)
+		return true;
+	obs_hotkey_trigger_routed_callback(id, true);
+	obs_hotkey_trigger_routed_callback(id, false);
+	return false;
+}
+
+static void playout_source_event_fire(void *param, void *data)
+{
+	struct playout_source_context *playout = param;
+	struct playout_event *event = data;
+	blog(LOG_DEBUG, "[Playout Source] '%s' event %s '%s' at %llu ms", obs_source_get_name(playout->source),
+	     playout_event_actions[event->action], event->target, (unsigned long long)event->offset_ms);
+	if (event->action == EVENT_ACTION_SHOW || event->action == EVENT_ACTION_HIDE) {
+		obs_source_t *scene_source = event->name ? obs_get_source_by_name(event->name) : obs_frontend_get_current_scene();
+		obs_scene_t *scene = scene_source ? obs_scene_from_source(scene_source) : NULL;
+		obs_sceneitem_t *scene_item = scene ? obs_scene_find_source_recursive(scene, event->target) : NULL;
+		if (scene_item)
+			obs_sceneitem_set_visible(scene_item, event->action == EVENT_ACTION_SHOW);
+		obs_source_release(scene_source);
+	} else if (event->action == EVENT_ACTION_ENABLE_FILTER || event->action == EVENT_ACTION_DISABLE_FILTER) {
+		obs_source_t *source = obs_get_source_by_name(event->target);
+		obs_source_t *filter = source && event->name ? obs_source_get_filter_by_name(source, event->name) : NULL;
+		if (filter)
+			obs_source_set_enabled(filter, event->action == EVENT_ACTION_ENABLE_FILTER);
+		obs_source_release(filter);
+		obs_source_release(source);
+	} else if (event->action == EVENT_ACTION_HOTKEY) {
+		obs_enum_hotkeys(playout_source_find_hotkey, event);
+	}
+}
+
+/* The wheel runs on the item's own time, it is rebuilt when another item goes
+ * on air, when the events change or when the time jumps like after a seek. */
+static void playout_source_events_tick(struct playout_source_context *playout, struct playout_source_item *item, int64_t time)
+{
+	struct timer_wheel *wheel = &playout->events_wheel;
+	uint64_t now = time > 0 ? (uint64_t)time : 0;
+	bool changed = playout->events_id != item->id;
+	if (changed || playout->events_reload || now < wheel->now || now - wheel->now > EVENTS_SEEK_MS) {
+		uint64_t start = changed && now <= EVENTS_SEEK_MS ? 0 : now;
+		playout->events_id = item->id;
+		playout->events_reload = false;
+		timer_wheel_reset(wheel, start);
+		for (size_t i = 0; i < item->events.num; i++) {
+			struct playout_event *event = &item->events.array[i];
+			if (!start || event->offset_ms > start)
+				timer_wheel_add(wheel, &event->entry, event->offset_ms, event);
+		}
 	}
+	if (item->events.num)
+		timer_wheel_advance(wheel, now, playout_source_event_fire, playout);
+	else
+		wheel->now = now;
+}
+
+static void playout_source_item_free(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	playout_source_item_release_source(playout, item);
+	playout_source_item_retire_events(playout, item);
+	obs_source_release(item->transition);
+	item->transition = NULL;
+	bfree(item->path);
+	item->path = NULL;
+	bfree(item->section);
+	item->section = NULL;
+	bfree(item->checksum);
+	item->checksum = NULL;
+	playout_source_item_release_cached(item);
+	bfree(item->proxy_path);
+	item->proxy_path = NULL;
+	playout_source_item_release_still(playout, item);
+}
+
+static bool playout_source_item_holds_frame(struct playout_source_context *playout, int index)
+{
+	if (index < 0 || index >= (int)playout->items.num)
+		return false;
+	struct playout_source_item *item = &playout->items.array[index];
+	return item->audio_only && !item->still;
+}
+
+/* The next item is planned when an item goes on air and again whenever the
+ * settings, the playlist or a cue change it. The last frame is only captured
+ * while an audio-only item without a still is on air or next. */
+static void playout_source_stats_plan(struct playout_source_context *playout)
+{
+	bool switch_scene = false;
+	int next = playout_source_next_index(playout, &switch_scene);
+	playout->stats.planned_id = !switch_scene && next >= 0 ? playout->items.array[next].id : 0;
+	playout->hold_frames = playout_source_item_holds_frame(playout, playout->current_source_index) ||
+			       (!switch_scene && playout_source_item_holds_frame(playout, next));
+}
+
+static void playout_source_stats_log(struct playout_source_context *playout)
+{
+	struct playout_switch_stats *stats = &playout->stats;
+	if (!stats->switches)
+		return;
+	blog(LOG_INFO,
+	     "[Playout Source] '%s' switches: %llu, missed out-points: %llu, cut short: %llu, skipped: %llu, doubled: %llu, late min/avg/max: %lld/%lld/%lld ms, drift: %lld ms",
+	     obs_source_get_name(playout->source), (unsigned long long)stats->switches, (unsigned long long)stats->missed,
+	     (unsigned long long)stats->early, (unsigned long long)stats->skipped, (unsigned long long)stats->doubled,
+	     (long long)stats->late_min_ms, (long long)(stats->late_total_ms / (int64_t)stats->switches),
+	     (long long)stats->late_max_ms, (long long)stats->late_total_ms);
+}
+
+static void playout_source_free_filler_pool(struct playout_source_context *playout)
+{
+	for (size_t i = 0; i < playout->filler_pool.num; i++)
+		bfree(playout->filler_pool.array[i]);
+	da_free(playout->filler_pool);
+}
+
+/* takes the source on air and its transition off the air */
+static void playout_source_clear_current(struct playout_source_context *playout)
+{
 	if (playout->current_source) {
+		source_registry_unclaim(playout->current_source, playout);
 		obs_source_remove_active_child(playout->source, playout->current_source);
 		obs_source_dec_showing(playout->current_source);
 		obs_source_release(playout->current_source);
@@ -67,14 +888,81 @@ static void playout_source_destroy(void *data)
 		obs_source_release(playout->current_transition);
 		playout->current_transition = NULL;
 	}
+}
+
+static void playout_source_destroy(void *data)
+{
+	struct playout_source_context *playout = data;
+	playout_source_stats_log(playout);
+	if (playout->as_run_entry) {
+		playout->as_run_entry->end_ms = as_run_now_ms();
+		playout->as_run_entry->out_ms = playout->as_run_out_ms;
+		playout->as_run_entry->ended = "stopped";
+		as_run_push(playout->as_run_entry);
+		playout->as_run_entry = NULL;
+	}
+	if (playout->audio_wrapper) {
+		obs_source_release(playout->audio_wrapper);
+		playout->audio_wrapper = NULL;
+	}
+	playout_source_clear_current(playout);
+	playout_source_loop_release(playout);
+	obs_weak_source_release(playout->sized_transition);
+	playout->sized_transition = NULL;
+	obs_source_release(playout->still);
+	playout->still = NULL;
+	if (playout->render) {
+		obs_enter_graphics();
+		gs_texrender_destroy(playout->render);
+		obs_leave_graphics();
+		playout->render = NULL;
+	}
 	for (int i = 0; i < (int)playout->items.num; i++) {
-		obs_source_release(playout->items.array[i].source);
-		obs_source_release(playout->items.array[i].transition);
+		playout_source_item_free(playout, &playout->items.array[i]);
 	}
 	da_free(playout->items);
+	for (size_t i = 0; i < playout->events_retired.num; i++)
+		playout_source_free_events(&playout->events_retired.array[i]);
+	da_free(playout->events_retired);
+	shuffle_bag_free(&playout->shuffle);
+	sync_group_leave(playout->sync_group, playout);
+	for (size_t i = 0; i < playout->edits.num; i++)
+		obs_data_release(playout->edits.array[i]);
+	da_free(playout->edits);
+	for (size_t i = 0; i < playout->cue_requests.num; i++)
+		bfree(playout->cue_requests.array[i].section);
+	da_free(playout->cue_requests);
+	pthread_mutex_destroy(&playout->edits_mutex);
+	obs_source_release(playout->next_source);
+	pthread_mutex_destroy(&playout->next_mutex);
+	journal_close(playout->journal_id);
+	bfree(playout->journal_id);
+	bfree(playout->signal_section);
+	bfree(playout->as_run_dir);
+	bfree(playout->filler_path);
+	playout_source_free_filler_pool(playout);
 	bfree(data);
 }
 
+static struct playout_source_item *playout_source_current_item(struct playout_source_context *playout)
+{
+	if (playout->current_source_index < 0 || playout->current_source_index >= (int)playout->items.num)
+		return NULL;
+	struct playout_source_item *item = &playout->items.array[playout->current_source_index];
+	if (!item->source || item->source != playout->current_source)
+		return NULL;
+	return item;
+}
+
+static bool playout_source_item_timed(const struct playout_source_item *item)
+{
+	if (!item || item->type == PLAYOUT_ITEM_TYPE_MEDIA)
+		return false;
+	return item->type != PLAYOUT_ITEM_TYPE_SOURCE || !item->until_end;
+}
+
+void playout_source_update_current_source(struct playout_source_context *playout, bool use_transition);
+
 static void playout_source_activate(void *data)
 {
 	struct playout_source_context *playout = data;
@@ -84,31 +972,9 @@ static void playout_source_activate(void *data)
 		return;
 	if (playout->current_index < 0 || playout->current_index >= (int)playout->items.num) {
 		playout->current_index = 0;
-		if (playout->current_source) {
-			obs_source_remove_active_child(playout->source, playout->current_source);
-			obs_source_dec_showing(playout->current_source);
-			obs_source_release(playout->current_source);
-		}
-		if (playout->current_transition) {
-			obs_source_remove_active_child(playout->source, playout->current_transition);
-			obs_source_dec_showing(playout->current_transition);
-			obs_source_release(playout->current_transition);
-			playout->current_transition = NULL;
-		}
-		playout->current_source = obs_source_get_ref(playout->items.array[playout->current_index].source);
-		if (playout->current_source) {
-			obs_source_inc_showing(playout->current_source);
-			obs_source_add_active_child(playout->source, playout->current_source);
-		}
-		if (playout->items.array[playout->current_index].transition) {
-			obs_transition_set(playout->items.array[playout->current_index].transition, playout->current_source);
-			playout->current_transition = obs_source_get_ref(playout->items.array[playout->current_index].transition);
-			obs_source_inc_showing(playout->current_transition);
-			obs_source_add_active_child(playout->source, playout->current_transition);
-			playout->current_transition_duration = playout->items.array[playout->current_index].transition_duration_ms;
-		}
+		playout_source_update_current_source(playout, false);
 	}
-	if (playout->current_source) {
+	if (playout->current_source && playout->items.array[playout->current_index].type == PLAYOUT_ITEM_TYPE_MEDIA) {
 		enum obs_media_state state = obs_source_media_get_state(playout->current_source);
 		if (state == OBS_MEDIA_STATE_NONE) {
 		} else if (state == OBS_MEDIA_STATE_PAUSED) {
@@ -117,7 +983,7 @@ static void playout_source_activate(void *data)
 				obs_source_media_play_pause(playout->current_source, false);
 			}
 		} else if (state == OBS_MEDIA_STATE_PLAYING) {
-			if (!playout->items.array[playout->current_index].seek_start) {
+			if (!playout->items.array[playout->current_index].seek_start && !playout->resumed) {
 				if (obs_source_media_get_time(playout->current_source) >=
 				    (int64_t)playout->items.array[playout->current_index].start) {
 					obs_source_media_set_time(playout->current_source,
@@ -129,23 +995,200 @@ static void playout_source_activate(void *data)
 			obs_source_media_restart(playout->current_source);
 		}
 	}
+	playout->resumed = false;
 	playout->playing = true;
 	playout->active = true;
 }
 
+static void playout_source_signal_current(struct playout_source_context *playout)
+{
+	struct playout_source_item *item = &playout->items.array[playout->current_index];
+	signal_handler_t *sh = obs_source_get_signal_handler(playout->source);
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "source", playout->source);
+	calldata_set_int(&cd, "index", playout->current_index);
+	calldata_set_int(&cd, "id", item->id);
+	calldata_set_string(&cd, "path", item->path);
+	signal_handler_signal(sh, "item_changed", &cd);
+	const char *section = item->section ? item->section : "";
+	if (!playout->signal_section || strcmp(playout->signal_section, section) != 0) {
+		bfree(playout->signal_section);
+		playout->signal_section = bstrdup(section);
+		calldata_set_string(&cd, "section", section);
+		signal_handler_signal(sh, "section_changed", &cd);
+	}
+	calldata_free(&cd);
+}
+
+static void playout_source_as_run_item(struct playout_source_context *playout)
+{
+	int64_t now = as_run_now_ms();
+	if (playout->as_run_entry) {
+		playout->as_run_entry->end_ms = now;
+		playout->as_run_entry->out_ms = playout->as_run_out_ms;
+		playout->as_run_entry->ended = playout->end_reason ? playout->end_reason : "manual";
+		as_run_push(playout->as_run_entry);
+		playout->as_run_entry = NULL;
+	}
+	playout->end_reason = NULL;
+	if (!playout->as_run || playout->current_index < 0 || playout->current_index >= (int)playout->items.num)
+		return;
+	struct playout_source_item *item = &playout->items.array[playout->current_index];
+	struct as_run_entry *entry = bzalloc(sizeof(struct as_run_entry));
+	entry->dir = bstrdup(playout->as_run_dir);
+	entry->csv = playout->as_run_csv;
+	entry->channel = bstrdup(obs_source_get_name(playout->source));
+	entry->path = bstrdup(item->path);
+	entry->section = bstrdup(item->section);
+	entry->index = playout->current_index;
+	entry->id = item->id;
+	entry->start_ms = now;
+	entry->in_ms = playout_source_item_timed(item) ? 0 : (int64_t)item->start;
+	playout->as_run_out_ms = entry->in_ms;
+	playout->as_run_entry = entry;
+}
+
+static void playout_source_journal(struct playout_source_context *playout)
+{
+	playout->journal_elapsed = 0.0f;
+	if (playout->resume_mode == RESUME_MODE_OFF || playout->resume_pending)
+		return;
+	struct playout_source_item *item = playout_source_current_item(playout);
+	if (!item || !playout->current_source)
+		return;
+	int64_t time = playout_source_item_timed(item) ? (int64_t)(item->elapsed_ns / 1000000)
+						     : obs_source_media_get_time(playout->current_source) - (int64_t)item->start;
+	journal_append(playout->journal_id, item->id, time > 0 ? time : 0, as_run_now_ms());
+}
+
+static void playout_source_signal_remaining(struct playout_source_context *playout, int64_t remaining, int64_t duration)
+{
+	uint8_t stack[128];
+	calldata_t cd;
+	calldata_init_fixed(&cd, stack, sizeof(stack));
+	calldata_set_ptr(&cd, "source", playout->source);
+	calldata_set_int(&cd, "index", playout->current_index);
+	calldata_set_int(&cd, "remaining", remaining);
+	calldata_set_int(&cd, "duration", duration);
+	signal_handler_signal(obs_source_get_signal_handler(playout->source), "remaining_time", &cd);
+}
+
+static void playout_source_shuffle_section(struct playout_source_context *playout);
+
+/* hard starts are a local time of day written as hh:mm[:ss.mmm] */
+static int64_t playout_source_parse_hard_start(const char *text)
+{
+	int hours, minutes;
+	double seconds = 0.0;
+	if (!text || sscanf(text, "%d:%d:%lf", &hours, &minutes, &seconds) < 2 || hours < 0 || hours > 23 || minutes < 0 ||
+	    minutes > 59 || seconds < 0.0 || seconds >= 60.0)
+		return -1;
+	return ((int64_t)hours * 3600 + minutes * 60) * 1000 + (int64_t)(seconds * 1000.0 + 0.5);
+}
+
+static int64_t playout_source_local_day_ms(void)
+{
+	int64_t now = as_run_now_ms();
+	time_t seconds = (time_t)(now / 1000);
+	struct tm tm;
+#ifdef _WIN32
+	localtime_s(&tm, &seconds);
+#else
+	localtime_r(&seconds, &tm);
+#endif
+	return ((int64_t)tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec) * 1000 + now % 1000;
+}
+
+/* fillers are inserted for a single gap, once one has aired it is removed again
+ * through the edit queue so the playlist does not grow on every pass */
+static void playout_source_remove_filler(struct playout_source_context *playout, int index)
+{
+	if (index < 0 || index >= (int)playout->items.num || index == playout->current_index || !playout->items.array[index].filler)
+		return;
+	obs_data_t *request = obs_data_create();
+	obs_data_array_t *batch = obs_data_array_create();
+	obs_data_t *edit = obs_data_create();
+	obs_data_set_string(edit, "op", "remove");
+	obs_data_set_int(edit, "id", playout->items.array[index].id);
+	obs_data_array_push_back(batch, edit);
+	obs_data_release(edit);
+	obs_data_set_array(request, "edits", batch);
+	obs_data_array_release(batch);
+	playout_source_queue_edits(playout, request);
+}
+
+static void playout_source_update_audio_only(struct playout_source_context *playout)
+{
+	struct playout_source_item *item = playout_source_current_item(playout);
+	playout->audio_only = item && item->audio_only;
+	obs_source_t *still = playout->audio_only ? item->still : NULL;
+	if (still == playout->still)
+		return;
+	obs_source_release(playout->still);
+	playout->still = obs_source_get_ref(still);
+}
+
 void playout_source_update_current_source(struct playout_source_context *playout, bool use_transition)
 {
 	if (playout->current_index < 0)
 		return;
 	if (playout->current_index >= (int)playout->items.num)
 		return;
-	if (playout->current_source == playout->items.array[playout->current_index].source)
+	uint64_t trace_start = trace_begin();
+	struct playout_source_item *item = &playout->items.array[playout->current_index];
+	playout_source_item_create_deferred(playout, playout->current_index);
+	int old = playout->current_source_index;
+	struct playout_source_item *old_item =
+		old >= 0 && old < (int)playout->items.num && playout->items.array[old].source == playout->current_source
+			? &playout->items.array[old]
+			: NULL;
+	if (item->type == PLAYOUT_ITEM_TYPE_SOURCE) {
+		if (old_item && old_item != item && old_item->type == PLAYOUT_ITEM_TYPE_SOURCE)
+			playout_source_item_release_reference(playout, old_item);
+		playout_source_item_resolve_reference(playout, item);
+	}
+	/* the previous item plays from the same shared decoder, seeking it would skip the transition */
+	if (playout->current_source == item->source && item->source && item->shared && item->type == PLAYOUT_ITEM_TYPE_MEDIA &&
+	    playout->current_source_index != playout->current_index) {
+		blog(LOG_INFO, "[Playout Source] '%s' item %d shares the decoder of the item on air, using a private decoder",
+		     obs_source_get_name(playout->source), playout->current_index + 1);
+		playout_source_item_use_private(playout, playout->current_index);
+	}
+	if (playout->current_source == item->source) {
+		if (playout->current_source_index != playout->current_index)
+			item->elapsed_ns = 0;
+		playout->current_source_index = playout->current_index;
+		if (old != playout->current_index) {
+			playout->resumed = false;
+			playout_source_as_run_item(playout);
+			playout_source_journal(playout);
+			playout_source_signal_current(playout);
+			playout_source_shuffle_section(playout);
+			playout_source_remove_filler(playout, old);
+			playout_source_stats_plan(playout);
+		}
+		playout_source_update_audio_only(playout);
+		trace_end(trace_current_name, trace_start);
 		return;
+	}
+	if (item->shared && item->type == PLAYOUT_ITEM_TYPE_MEDIA && !source_registry_claim(item->source, playout)) {
+		blog(LOG_INFO, "[Playout Source] '%s' item %d is on air in another playout, using a private decoder",
+		     obs_source_get_name(playout->source), playout->current_index + 1);
+		playout_source_item_use_private(playout, playout->current_index);
+	}
 	if (playout->current_transition) {
 		if (use_transition) {
 			obs_transition_start(playout->current_transition, OBS_TRANSITION_MODE_AUTO,
 					     playout->current_transition_duration,
 					     playout->items.array[playout->current_index].source);
+			uint8_t stack[128];
+			calldata_t cd;
+			calldata_init_fixed(&cd, stack, sizeof(stack));
+			calldata_set_ptr(&cd, "source", playout->source);
+			calldata_set_int(&cd, "index", playout->current_index);
+			calldata_set_int(&cd, "duration", playout->current_transition_duration);
+			signal_handler_signal(obs_source_get_signal_handler(playout->source), "transition_started", &cd);
 		} else {
 			obs_source_remove_active_child(playout->source, playout->current_transition);
 			obs_source_dec_showing(playout->current_transition);
@@ -157,22 +1200,35 @@ void playout_source_update_current_source(struct playout_source_context *playout
 	if (playout->current_source) {
 		obs_source_remove_active_child(playout->source, playout->current_source);
 		obs_source_dec_showing(playout->current_source);
-		obs_source_release(playout->current_source);
-		obs_source_media_play_pause(playout->current_source, true);
-		for (size_t i = 0; i < playout->items.num; i++) {
-			if (playout->items.array[i].source == playout->current_source) {
-				enum obs_media_state state = obs_source_media_get_state(playout->current_source);
-				if (state == OBS_MEDIA_STATE_ENDED) {
-					obs_source_media_restart(playout->current_source);
-				} else {
-					obs_source_media_set_time(playout->current_source, playout->items.array[i].start);
-					playout->items.array[i].seek_start = true;
-					obs_source_media_play_pause(playout->current_source, false);
-				}
+		/* the claim is kept until the old decoder is cued again, so no other playout has it on air meanwhile */
+		if (old_item && old_item->type == PLAYOUT_ITEM_TYPE_SOURCE) {
+			playout_source_item_release_reference(playout, old_item);
+		} else {
+			obs_source_media_play_pause(playout->current_source, true);
+		}
+		if (old_item && old_item->type == PLAYOUT_ITEM_TYPE_MEDIA) {
+			enum obs_media_state state = obs_source_media_get_state(playout->current_source);
+			if (state == OBS_MEDIA_STATE_ENDED) {
+				obs_source_media_restart(playout->current_source);
+			} else {
+				obs_source_media_set_time(playout->current_source, old_item->start);
+				old_item->seek_start = true;
+				obs_source_media_play_pause(playout->current_source, false);
 			}
 		}
+		source_registry_unclaim(playout->current_source, playout);
+		obs_source_release(playout->current_source);
+	}
+	playout->current_source = obs_source_get_ref(item->source);
+	playout->current_source_index = playout->current_index;
+	item->elapsed_ns = 0;
+	if (item->shared && item->type == PLAYOUT_ITEM_TYPE_MEDIA && playout->current_source) {
+		int64_t time = obs_source_media_get_time(playout->current_source);
+		if (time < (int64_t)item->start || time > (int64_t)item->start + 1000) {
+			obs_source_media_set_time(playout->current_source, item->start);
+			item->seek_start = true;
+		}
 	}
-	playout->current_source = obs_source_get_ref(playout->items.array[playout->current_index].source);
 	if (!playout->current_transition && playout->items.array[playout->current_index].transition) {
 		obs_transition_set(playout->items.array[playout->current_index].transition, playout->current_source);
 		playout->current_transition = obs_source_get_ref(playout->items.array[playout->current_index].transition);
@@ -187,61 +1243,311 @@ void playout_source_update_current_source(struct playout_source_context *playout
 	}
 	if (playout->active)
 		playout_source_activate(playout);
+	if (old != playout->current_index) {
+		playout->resumed = false;
+		playout_source_as_run_item(playout);
+		playout_source_journal(playout);
+		playout_source_signal_current(playout);
+		playout_source_shuffle_section(playout);
+		playout_source_remove_filler(playout, old);
+		playout_source_stats_plan(playout);
+	}
+	playout_source_update_audio_only(playout);
+	trace_end(trace_current_name, trace_start);
 }
 
-void playout_source_switch_to_next_item(struct playout_source_context *playout)
+int playout_source_find_id(struct playout_source_context *playout, long id)
 {
-	playout->switch_to_next = false;
-	if (!playout->items.num)
+	for (size_t i = 0; i < playout->items.num; i++) {
+		if (playout->items.array[i].id == id)
+			return (int)i;
+	}
+	return -1;
+}
+
+static bool playout_source_shuffled(struct playout_source_context *playout)
+{
+	return playout->playback_mode == PLAYBACK_MODE_SHUFFLE || playout->playback_mode == PLAYBACK_MODE_SHUFFLE_SECTION;
+}
+
+static bool playout_source_same_section(struct playout_source_item *a, struct playout_source_item *b)
+{
+	if (!a->section || !b->section)
+		return !a->section && !b->section;
+	return strcmp(a->section, b->section) == 0;
+}
+
+static void playout_source_shuffle_range(struct playout_source_context *playout, int *first, int *count)
+{
+	struct playout_source_item *items = playout->items.array;
+	int index = playout->current_index;
+	*first = 0;
+	*count = (int)playout->items.num;
+	if (playout->playback_mode != PLAYBACK_MODE_SHUFFLE_SECTION || index < 0 || index >= (int)playout->items.num)
 		return;
-	if (playout->current_index >= (int)playout->items.num - 1 && !playout->loop && !playout->auto_play)
+	int start = index;
+	int end = index + 1;
+	while (start > 0 && playout_source_same_section(&items[start - 1], &items[index]))
+		start--;
+	while (end < (int)playout->items.num && playout_source_same_section(&items[end], &items[index]))
+		end++;
+	*first = start;
+	*count = end - start;
+}
+
+static void playout_source_shuffle_save(struct playout_source_context *playout, obs_data_t *settings, bool save_ids)
+{
+	if (save_ids) {
+		struct dstr ids;
+		dstr_init(&ids);
+		shuffle_bag_save(&playout->shuffle, &ids);
+		obs_data_set_string(settings, "shuffle_bag", ids.array ? ids.array : "");
+		dstr_free(&ids);
+	}
+	obs_data_set_int(settings, "shuffle_position", (long long)playout->shuffle.position);
+}
+
+static void playout_source_shuffle_section(struct playout_source_context *playout)
+{
+	if (!playout_source_shuffled(playout) || !playout->shuffle.ids.num ||
+	    shuffle_bag_covers(&playout->shuffle, playout->current_index))
 		return;
+	int first;
+	int count;
+	playout_source_shuffle_range(playout, &first, &count);
+	shuffle_bag_start(&playout->shuffle, playout->items.array, first, count, playout->current_index,
+			  playout->shuffle_no_repeat);
+	obs_data_t *settings = obs_source_get_settings(playout->source);
+	playout_source_shuffle_save(playout, settings, true);
+	obs_data_release(settings);
+}
 
-	bool switch_scene = false;
+static void playout_source_shuffle_update(struct playout_source_context *playout, obs_data_t *settings)
+{
+	if (!playout_source_shuffled(playout) || playout->current_index < 0 ||
+	    playout->current_index >= (int)playout->items.num) {
+		shuffle_bag_free(&playout->shuffle);
+		return;
+	}
+	int first;
+	int count;
+	playout_source_shuffle_range(playout, &first, &count);
+	struct shuffle_bag *bag = &playout->shuffle;
+	if (!bag->ids.num)
+		shuffle_bag_load(bag, obs_data_get_string(settings, "shuffle_bag"),
+				 (size_t)obs_data_get_int(settings, "shuffle_position"));
+	if (bag->ids.num && (!bag->count || shuffle_bag_covers(bag, playout->current_index)))
+		shuffle_bag_remap(bag, playout->items.array, first, count, playout->shuffle_no_repeat);
+	if (!shuffle_bag_covers(bag, playout->current_index))
+		shuffle_bag_start(bag, playout->items.array, first, count, playout->current_index, playout->shuffle_no_repeat);
+	playout_source_shuffle_save(playout, settings, true);
+}
+
+/* items that failed the integrity scan with skip_failed set, and audio-only
+ * items still waiting for their proxy, are passed over */
+static bool playout_source_item_skipped(struct playout_source_context *playout, int index)
+{
+	if (index < 0 || index >= (int)playout->items.num)
+		return false;
+	struct playout_source_item *item = &playout->items.array[index];
+	return (playout->skip_failed && item->scan_status == INTEGRITY_SCAN_FAILED) || playout_source_item_awaits_proxy(item);
+}
+
+static int playout_source_next_index_after(struct playout_source_context *playout, int index, bool *switch_scene)
+{
+	struct playout_source_item *items = playout->items.array;
+	int count = (int)playout->items.num;
+	if (index < 0 || index >= count)
+		return 0;
 
 	if (playout->playback_mode == PLAYBACK_MODE_LIST) {
-		if (playout->current_index < (int)playout->items.num - 1) {
-			playout->current_index++;
+		if (index < count - 1) {
+			index++;
 		} else if (playout->loop) {
-			playout->current_index = 0;
+			index = 0;
 		} else if (playout->auto_play && obs_frontend_preview_program_mode_active()) {
-			switch_scene = true;
+			*switch_scene = true;
 		}
 	} else if (playout->playback_mode == PLAYBACK_MODE_SECTION) {
-		if (playout->items.array[playout->current_index].section &&
-		    playout->items.array[playout->current_index + 1].section &&
-		    strcmp(playout->items.array[playout->current_index].section,
-			   playout->items.array[playout->current_index + 1].section) == 0) {
-
-			playout->current_index++;
+		if (index < count - 1 && items[index].section && items[index + 1].section &&
+		    strcmp(items[index].section, items[index + 1].section) == 0) {
+			index++;
 		} else if (playout->loop) {
-			if (playout->items.array[playout->current_index].section) {
-				while (playout->current_index > 0 && playout->items.array[playout->current_index - 1].section &&
-				       strcmp(playout->items.array[playout->current_index].section,
-					      playout->items.array[playout->current_index - 1].section) == 0) {
-					playout->current_index--;
+			if (items[index].section) {
+				while (index > 0 && items[index - 1].section &&
+				       strcmp(items[index].section, items[index - 1].section) == 0) {
+					index--;
 				}
 			} else {
-				while (playout->current_index > 0 && !playout->items.array[playout->current_index - 1].section) {
-					playout->current_index--;
+				while (index > 0 && !items[index - 1].section) {
+					index--;
 				}
 			}
 		} else if (playout->auto_play && obs_frontend_preview_program_mode_active()) {
-			switch_scene = true;
+			*switch_scene = true;
 		}
 	} else if (playout->playback_mode == PLAYBACK_MODE_SINGLE) {
-		if (playout->loop) {
-			obs_source_media_set_time(playout->current_source, playout->items.array[playout->current_index].start);
-			playout->items.array[playout->current_index].seek_start = true;
+		if (!playout->loop && playout->auto_play && obs_frontend_preview_program_mode_active())
+			*switch_scene = true;
+	} else if (playout_source_shuffled(playout)) {
+		if (playout->shuffle.cycle_end && !playout->loop) {
+			if (playout->auto_play && obs_frontend_preview_program_mode_active())
+				*switch_scene = true;
+			return index;
+		}
+		int next;
+		for (size_t ahead = 0; (next = shuffle_bag_peek_at(&playout->shuffle, ahead)) >= 0; ahead++) {
+			index = next;
+			if (!playout_source_item_skipped(playout, next))
+				break;
+		}
+	}
+	return index;
+}
+
+int playout_source_next_index(struct playout_source_context *playout, bool *switch_scene)
+{
+	int count = (int)playout->items.num;
+	*switch_scene = false;
+	if (!count)
+		return -1;
+	if (playout->cue_id) {
+		int cued = playout_source_find_id(playout, playout->cue_id);
+		if (cued >= 0)
+			return cued;
+	}
+	int next = playout_source_next_index_after(playout, playout->current_index, switch_scene);
+	if (playout_source_shuffled(playout))
+		return next;
+	for (int n = 0; n < count && !*switch_scene && playout_source_item_skipped(playout, next); n++) {
+		int after = playout_source_next_index_after(playout, next, switch_scene);
+		if (after == next)
+			break;
+		next = after;
+	}
+	return next;
+}
+
+static obs_source_t *playout_source_find_next_source(struct playout_source_context *playout)
+{
+	bool switch_scene;
+	int next = playout_source_next_index(playout, &switch_scene);
+	if (switch_scene || next < 0)
+		return NULL;
+	struct playout_source_item *item = &playout->items.array[next];
+	if (next == playout->current_source_index) {
+		if (playout->loop_ready && playout->loop_index == next)
+			return obs_source_get_ref(playout->loop_source);
+		return NULL;
+	}
+	if (item->type == PLAYOUT_ITEM_TYPE_SOURCE)
+		return playout_source_item_reference(playout, item);
+	return obs_source_get_ref(item->source);
+}
+
+/* other sources only read the published next source, the items are not theirs to walk */
+static void playout_source_publish_next_source(struct playout_source_context *playout)
+{
+	obs_source_t *next = playout_source_find_next_source(playout);
+	pthread_mutex_lock(&playout->next_mutex);
+	obs_source_t *old = playout->next_source;
+	playout->next_source = next;
+	pthread_mutex_unlock(&playout->next_mutex);
+	obs_source_release(old);
+}
+
+obs_source_t *playout_source_get_next_source(struct playout_source_context *playout)
+{
+	pthread_mutex_lock(&playout->next_mutex);
+	obs_source_t *next = obs_source_get_ref(playout->next_source);
+	pthread_mutex_unlock(&playout->next_mutex);
+	return next;
+}
+
+void playout_source_switch_to_next_item(struct playout_source_context *playout)
+{
+	playout->switch_to_next = false;
+	if (!playout->items.num)
+		return;
+	if (playout->current_index >= (int)playout->items.num - 1 && !playout->loop && !playout->auto_play && !playout->cue_id &&
+	    !playout_source_shuffled(playout))
+		return;
+
+	profile_start(profile_switch_name);
+	bool switch_scene = false;
+	int next = playout_source_next_index(playout, &switch_scene);
+	bool cued = playout->cue_id && playout_source_find_id(playout, playout->cue_id) >= 0;
+	playout->cue_id = 0;
+	size_t ahead = 0;
+	while (playout_source_shuffled(playout) && shuffle_bag_peek_at(&playout->shuffle, ahead) >= 0 &&
+	       shuffle_bag_peek_at(&playout->shuffle, ahead) != next)
+		ahead++;
+	if (playout_source_shuffled(playout) && !cued && !switch_scene && next >= 0 &&
+	    next == shuffle_bag_peek_at(&playout->shuffle, ahead) && (playout->loop || !playout->shuffle.cycle_end)) {
+		for (size_t n = 0; n <= ahead; n++)
+			shuffle_bag_advance(&playout->shuffle, playout->items.array, playout->shuffle_no_repeat);
+		obs_data_t *settings = obs_source_get_settings(playout->source);
+		playout_source_shuffle_save(playout, settings, playout->shuffle.cycle_end);
+		obs_data_release(settings);
+	}
+	if (playout->playback_mode == PLAYBACK_MODE_SINGLE && playout->loop && next >= 0 && next == playout->current_index) {
+		if (playout->items.array[next].type == PLAYOUT_ITEM_TYPE_MEDIA) {
+			obs_source_media_set_time(playout->current_source, playout->items.array[next].start);
+			playout->items.array[next].seek_start = true;
 			obs_source_media_play_pause(playout->current_source, false);
-		} else if (playout->auto_play && obs_frontend_preview_program_mode_active()) {
-			switch_scene = true;
+		} else {
+			playout->items.array[next].elapsed_ns = 0;
 		}
 	}
+	playout->current_index = next;
 	if (switch_scene && obs_source_active(playout->source)) {
 		obs_frontend_preview_program_trigger_transition();
 	}
 	playout_source_update_current_source(playout, true);
+	profile_end(profile_switch_name);
+}
+
+/* A switch at the end of an item is compared with the plan: more than a frame
+ * after the out-point misses it, more than a frame before cuts the item short,
+ * another item than planned skips the planned one and the same item again
+ * doubles it. */
+static void playout_source_stats_record(struct playout_source_context *playout, int64_t late_ms, long from_id, long planned_id)
+{
+	struct playout_switch_stats *stats = &playout->stats;
+	struct playout_source_item *item = playout_source_current_item(playout);
+	long aired_id = item ? item->id : 0;
+	struct obs_video_info ovi;
+	int64_t frame = obs_get_video_info(&ovi) && ovi.fps_num ? (int64_t)ovi.fps_den * 1000 / ovi.fps_num : 0;
+	if (late_ms > frame)
+		stats->missed++;
+	else if (late_ms < -frame)
+		stats->early++;
+	if (planned_id && aired_id != planned_id) {
+		if (aired_id == from_id)
+			stats->doubled++;
+		else
+			stats->skipped++;
+	}
+	metrics_histogram_add(&playout->metrics.switch_late_ms, (long)late_ms);
+	if (!stats->switches || late_ms < stats->late_min_ms)
+		stats->late_min_ms = late_ms;
+	if (!stats->switches || late_ms > stats->late_max_ms)
+		stats->late_max_ms = late_ms;
+	stats->late_total_ms += late_ms;
+	stats->switches++;
+	blog(LOG_DEBUG, "[Playout Source] '%s' switch to item %d, %lld ms late%s", obs_source_get_name(playout->source),
+	     playout->current_index + 1, (long long)late_ms,
+	     planned_id && aired_id != planned_id ? ", not the planned item" : "");
+}
+
+/* switches from the current item at its end and records how that went */
+static void playout_source_switch_at_end(struct playout_source_context *playout, int64_t late_ms)
+{
+	struct playout_source_item *item = playout_source_current_item(playout);
+	long from_id = item ? item->id : 0;
+	long planned_id = playout->stats.planned_id;
+	playout_source_switch_to_next_item(playout);
+	playout_source_stats_record(playout, late_ms, from_id, planned_id);
 }
 
 static bool playout_source_use_global_transition(struct playout_source_context *playout)
@@ -271,17 +1577,14 @@ static bool playout_source_last(struct playout_source_context *playout)
 			!playout->items.array[playout->current_index + 1].section);
 	} else if (playout->playback_mode == PLAYBACK_MODE_SINGLE) {
 		return true;
+	} else if (playout_source_shuffled(playout)) {
+		return playout->shuffle.cycle_end;
 	}
 	return false;
 }
 
-static void playout_source_media_ended(void *data, calldata_t *cd)
+static void playout_source_current_ended(struct playout_source_context *playout)
 {
-	struct playout_source_context *playout = data;
-	obs_source_t *source = calldata_ptr(cd, "source");
-	if (playout->current_source != source)
-		return;
-
 	if (playout_source_last(playout)) {
 		if (playout_source_use_global_transition(playout) && !playout->next_after_transition &&
 		    obs_source_active(playout->source)) {
@@ -293,20 +1596,43 @@ static void playout_source_media_ended(void *data, calldata_t *cd)
 	}
 }
 
+static void playout_source_media_ended(void *data, calldata_t *cd)
+{
+	struct playout_source_context *playout = data;
+	obs_source_t *source = calldata_ptr(cd, "source");
+	if (playout->current_source != source || source_registry_claimed_by_other(source, playout))
+		return;
+	uint64_t trace_start = trace_begin();
+	playout->stats.ended_ns = os_gettime_ns();
+	playout_source_current_ended(playout);
+	trace_end(trace_media_ended_name, trace_start);
+}
+
 static void playout_source_media_started(void *data, calldata_t *cd)
 {
 	struct playout_source_context *playout = data;
 	obs_source_t *source = calldata_ptr(cd, "source");
+	if (source_registry_claimed_by_other(source, playout))
+		return;
 
-	for (size_t i = 0; i < playout->items.num; i++) {
-		if (playout->items.array[i].source != source)
-			continue;
-		if (obs_source_media_get_time(source) < (int64_t)playout->items.array[i].start) {
-			obs_source_media_set_time(source, playout->items.array[i].start);
+	int index = playout->current_source_index;
+	if (index < 0 || index >= (int)playout->items.num || playout->items.array[index].source != source) {
+		index = -1;
+		for (size_t i = 0; i < playout->items.num; i++) {
+			if (playout->items.array[i].source == source) {
+				index = (int)i;
+				break;
+			}
 		}
-		playout->items.array[i].seek_start = true;
-		break;
 	}
+	if (index < 0)
+		return;
+	uint64_t trace_start = trace_begin();
+	if (obs_source_media_get_time(source) < (int64_t)playout->items.array[index].start) {
+		obs_source_media_set_time(source, playout->items.array[index].start);
+	}
+	playout->items.array[index].seek_start = true;
+	trace_end(trace_media_started_name, trace_start);
 }
 
 void playout_source_transition_stop(void *data, calldata_t *cd)
@@ -315,6 +1641,7 @@ void playout_source_transition_stop(void *data, calldata_t *cd)
 	struct playout_source_context *playout = data;
 	if (playout->current_index < 0 || playout->current_index >= (int)playout->items.num)
 		return;
+	uint64_t trace_start = trace_begin();
 	if (playout_source_last(playout)) {
 		if (playout->current_transition) {
 			obs_source_remove_active_child(playout->source, playout->current_transition);
@@ -324,8 +1651,10 @@ void playout_source_transition_stop(void *data, calldata_t *cd)
 			playout->current_transition_duration = 0;
 		}
 	} else if (playout->items.array[playout->current_index].transition) {
-		if (playout->current_transition == playout->items.array[playout->current_index].transition)
+		if (playout->current_transition == playout->items.array[playout->current_index].transition) {
+			trace_end(trace_transition_stop_name, trace_start);
 			return;
+		}
 		if (playout->current_transition) {
 			obs_source_t *newTransition = playout->items.array[playout->current_index].transition;
 			obs_source_t *oldTransition = playout->current_transition;
@@ -349,143 +1678,987 @@ void playout_source_transition_stop(void *data, calldata_t *cd)
 		playout->current_transition = NULL;
 		playout->current_transition_duration = 0;
 	}
+	trace_end(trace_transition_stop_name, trace_start);
+}
+
+/* Loads item i from the settings into the item array, creating its source
+ * unless that is deferred. Returns false past the last item. */
+static bool playout_source_item_load(struct playout_source_context *playout, obs_data_t *settings, int i,
+				     struct dstr *setting_name, bool *deferred)
+{
+	dstr_printf(setting_name, "path%d", i);
+	const char *path = obs_data_get_string(settings, setting_name->array);
+	dstr_printf(setting_name, "type%d", i);
+	int type = (int)obs_data_get_int(settings, setting_name->array);
+	if (type == PLAYOUT_ITEM_TYPE_SOURCE) {
+		dstr_printf(setting_name, "source%d", i);
+		path = obs_data_get_string(settings, setting_name->array);
+	}
+	if (!strlen(path) && type != PLAYOUT_ITEM_TYPE_COLOR)
+		return false;
+	if (i >= (int)playout->items.num) {
+		da_push_back_new(playout->items);
+	}
+	struct playout_source_item *item = &playout->items.array[i];
+	dstr_printf(setting_name, "id%d", i);
+	item->id = (long)obs_data_get_int(settings, setting_name->array);
+	if (item->id) {
+		long next_id = os_atomic_load_long(&playout->next_id);
+		while (item->id > next_id && !os_atomic_compare_exchange_long(&playout->next_id, &next_id, item->id))
+			;
+	} else {
+		item->id = os_atomic_inc_long(&playout->next_id);
+		obs_data_set_int(settings, setting_name->array, item->id);
+	}
+	dstr_printf(setting_name, "speed_percent%d", i);
+	obs_data_set_default_int(settings, setting_name->array, 100);
+	uint32_t speed = (uint32_t)obs_data_get_int(settings, setting_name->array);
+	if (!speed)
+		speed = 100;
+	dstr_printf(setting_name, "decode%d", i);
+	int decode = (int)obs_data_get_int(settings, setting_name->array);
+	bool hw_decode = decode == DECODE_HARDWARE || (decode == DECODE_DEFAULT && playout->hw_decode);
+	dstr_printf(setting_name, "buffering_mb%d", i);
+	int buffering_mb = (int)obs_data_get_int(settings, setting_name->array);
+	if (buffering_mb <= 0)
+		buffering_mb = playout->buffering_mb;
+	bool profile_changed = speed != item->speed || hw_decode != item->hw_decode || buffering_mb != item->buffering_mb;
+	dstr_printf(setting_name, "color%d", i);
+	obs_data_set_default_int(settings, setting_name->array, 0xFF000000);
+	uint32_t color = (uint32_t)obs_data_get_int(settings, setting_name->array);
+	dstr_printf(setting_name, "duration%d", i);
+	obs_data_set_default_double(settings, setting_name->array, 10.0);
+	item->duration = (uint64_t)(obs_data_get_double(settings, setting_name->array) * 1000.0);
+	dstr_printf(setting_name, "until_end%d", i);
+	bool until_end = obs_data_get_bool(settings, setting_name->array);
+
+	dstr_printf(setting_name, "checksum%d", i);
+	const char *checksum = obs_data_get_string(settings, setting_name->array);
+	dstr_printf(setting_name, "section%d", i);
+	const char *section = obs_data_get_string(settings, setting_name->array);
+	bfree(item->section);
+	item->section = strlen(section) ? bstrdup(section) : NULL;
+	dstr_printf(setting_name, "start%d", i);
+	item->trim_start = (uint64_t)(obs_data_get_double(settings, setting_name->array) * 1000.0);
+	dstr_printf(setting_name, "end%d", i);
+	item->trim_end = (uint64_t)(obs_data_get_double(settings, setting_name->array) * -1000.0);
+	dstr_printf(setting_name, "audio_only%d", i);
+	bool audio_only = type == PLAYOUT_ITEM_TYPE_MEDIA && obs_data_get_bool(settings, setting_name->array);
+	if (audio_only != item->audio_only) {
+		bfree(item->proxy_path);
+		item->proxy_path = NULL;
+		item->audio_only = audio_only;
+		profile_changed = true;
+	}
+	dstr_printf(setting_name, "still%d", i);
+	const char *still = audio_only ? obs_data_get_string(settings, setting_name->array) : "";
+	playout_source_item_set_still(playout, item, still);
+	dstr_printf(setting_name, "proxy%d", i);
+	item->use_proxy = type == PLAYOUT_ITEM_TYPE_MEDIA &&
+			  (audio_only || obs_data_get_bool(settings, setting_name->array) ||
+			   (playout->proxy_trimmed && item->trim_start));
+
+	bool path_changed = !item->path || strcmp(item->path, path) != 0 ||
+			    strcmp(item->checksum ? item->checksum : "", checksum) != 0;
+	if (path_changed) {
+		playout_source_item_release_cached(item);
+		bfree(item->proxy_path);
+		item->proxy_path = NULL;
+		item->scan_status = INTEGRITY_SCAN_NONE;
+		bfree(item->checksum);
+		item->checksum = bstrdup(checksum);
+	}
+	item->remote = type == PLAYOUT_ITEM_TYPE_MEDIA && media_cache_is_remote(path);
+	if (item->remote && !item->cached_path) {
+		item->cached_path = media_cache_get(path, checksum);
+		if (item->cached_path)
+			path_changed = true;
+	}
+	playout_source_item_apply_trims(playout, item);
+	dstr_printf(setting_name, "hard_start%d", i);
+	item->hard_start_ms = playout_source_parse_hard_start(obs_data_get_string(settings, setting_name->array));
+	dstr_printf(setting_name, "filler%d", i);
+	item->filler = obs_data_get_bool(settings, setting_name->array);
+	dstr_printf(setting_name, "events%d", i);
+	obs_data_array_t *events = obs_data_get_array(settings, setting_name->array);
+	playout_source_item_load_events(playout, item, events);
+	obs_data_array_release(events);
+	if (playout_source_item_check_proxy(item, item->remote ? item->cached_path : path))
+		path_changed = true;
+	bool type_changed = item->type != type || (type == PLAYOUT_ITEM_TYPE_COLOR && color != item->color) ||
+			    (type == PLAYOUT_ITEM_TYPE_SOURCE && until_end != item->until_end);
+	if (i == playout->loop_index && (type_changed || path_changed || profile_changed))
+		playout_source_loop_release(playout);
+	if (item->type == PLAYOUT_ITEM_TYPE_SOURCE) {
+		if (type_changed || path_changed)
+			playout_source_item_release_source(playout, item);
+	} else if (item->source && (type_changed || (item->shared && (path_changed || profile_changed)) ||
+			     (i == playout->current_index && path_changed))) {
+		playout_source_item_release_source(playout, item);
+	}
+	if (path_changed) {
+		bfree(item->path);
+		item->path = bstrdup(path);
+	}
+	item->type = type;
+	item->until_end = until_end;
+	item->speed = speed;
+	item->hw_decode = hw_decode;
+	item->buffering_mb = buffering_mb;
+	item->color = color;
+
+	if (playout->resume_pending && playout->current_index < 0 && item->id == playout->resume_id)
+		playout->current_index = i;
+	bool current = i == playout->current_index || (playout->current_index < 0 && !playout->resume_pending);
+	if (item->source && playout_source_item_awaits_proxy(item) && i != playout->current_source_index)
+		playout_source_item_release_source(playout, item);
+	bool created = !item->source;
+	item->deferred = created && !current;
+	if (item->deferred)
+		*deferred = true;
+	else if (created)
+		playout_source_item_create(playout, i);
+	if (!playout->current_source && current) {
+		playout->current_index = i;
+		playout_source_update_current_source(playout, false);
+	}
+	if (!created && !item->shared && item->type == PLAYOUT_ITEM_TYPE_MEDIA) {
+		obs_data_t *ss = playout_source_item_settings(playout_source_item_file(playout, item), item);
+		obs_source_update(item->source, ss);
+		obs_data_release(ss);
+	}
+	dstr_printf(setting_name, "transition%d", i);
+	const char *transition = obs_data_get_string(settings, setting_name->array);
+	if (strlen(transition)) {
+		if (!playout->items.array[i].transition ||
+		    strcmp(obs_source_get_unversioned_id(playout->items.array[i].transition), transition) != 0) {
+			obs_source_release(playout->items.array[i].transition);
+
+			dstr_printf(setting_name, "transition_settings%d", i);
+			obs_data_t *transition_settings = obs_data_get_obj(settings, setting_name->array);
+			if (!transition_settings) {
+				transition_settings = obs_data_create();
+				obs_data_set_obj(settings, setting_name->array, transition_settings);
+			}
+			playout->items.array[i].transition =
+				obs_source_create_private(transition, "test", transition_settings);
+			signal_handler_t *sh = obs_source_get_signal_handler(playout->items.array[i].transition);
+			signal_handler_connect(sh, "transition_stop", playout_source_transition_stop, playout);
+			//signal_handler_connect(sh, "transition_video_stop", playout_source_transition_video_stop, data);
+
+			obs_data_release(transition_settings);
+		}
+	} else if (playout->items.array[i].transition) {
+		obs_source_release(playout->items.array[i].transition);
+		playout->items.array[i].transition = NULL;
+	}
+	dstr_printf(setting_name, "transition_duration%d", i);
+	item->transition_duration_ms = (uint32_t)obs_data_get_int(settings, setting_name->array);
+	return true;
+}
+
+/* restarts the deferred creation at the item on air */
+static void playout_source_defer_items(struct playout_source_context *playout)
+{
+	playout->deferred_pending = true;
+	playout->deferred_cursor = playout->current_index > 0 ? (size_t)playout->current_index : 0;
+	playout->deferred_scanned = 0;
+}
+
+static void playout_source_update(void *data, obs_data_t *settings)
+{
+	profile_start(profile_update_name);
+	struct playout_source_context *playout = data;
+	playout->auto_play = obs_data_get_bool(settings, "autoplay");
+	playout->loop = obs_data_get_bool(settings, "loop");
+	playout->playback_mode = (int)obs_data_get_int(settings, "playback_mode");
+	playout->shuffle_no_repeat = obs_data_get_bool(settings, "shuffle_no_repeat");
+	bfree(playout->filler_path);
+	playout->filler_path = bstrdup(obs_data_get_string(settings, "filler_path"));
+	playout->prefetch_window_ns = (uint64_t)obs_data_get_int(settings, "prefetch_minutes") * 60000000000ULL;
+	playout->proxy_trimmed = obs_data_get_bool(settings, "proxy_trimmed");
+	playout->seamless_loop = obs_data_get_bool(settings, "seamless_loop");
+	playout->hw_decode = obs_data_get_bool(settings, "hw_decode");
+	playout->buffering_mb = (int)obs_data_get_int(settings, "buffering_mb");
+	playout->as_run = obs_data_get_bool(settings, "as_run");
+	playout->as_run_csv = obs_data_get_int(settings, "as_run_format") == 1;
+	bfree(playout->as_run_dir);
+	playout->as_run_dir = bstrdup(obs_data_get_string(settings, "as_run_dir"));
+	playout->resume_mode = (int)obs_data_get_int(settings, "resume_mode");
+	playout->journal_interval = (float)obs_data_get_int(settings, "journal_interval");
+	double status_rate = obs_data_get_double(settings, "status_rate");
+	playout->status_interval = status_rate > 0.0 ? (float)(1.0 / status_rate) : 0.0f;
+	playout->fixed_size = obs_data_get_bool(settings, "fixed_size");
+	playout->fixed_width = (uint32_t)obs_data_get_int(settings, "width");
+	playout->fixed_height = (uint32_t)obs_data_get_int(settings, "height");
+	playout->scale_mode = (int)obs_data_get_int(settings, "scale_mode");
+	playout->scan = obs_data_get_bool(settings, "scan");
+	playout->skip_failed = obs_data_get_bool(settings, "skip_failed");
+	const char *sync_group = obs_data_get_string(settings, "sync_group");
+	bool sync_master = obs_data_get_bool(settings, "sync_master");
+	if (!playout->sync_group || strcmp(sync_group_name(playout->sync_group), sync_group) != 0 ||
+	    sync_master != playout->sync_master) {
+		sync_group_leave(playout->sync_group, playout);
+		playout->sync_group = sync_group_join(sync_group, playout, sync_master, &playout->sync_seq);
+		playout->sync_master = sync_master;
+	}
+	playout_source_free_filler_pool(playout);
+	obs_data_array_t *filler_pool = obs_data_get_array(settings, "filler_pool");
+	size_t filler_count = obs_data_array_count(filler_pool);
+	for (size_t i = 0; i < filler_count; i++) {
+		obs_data_t *filler = obs_data_array_item(filler_pool, i);
+		const char *path = obs_data_get_string(filler, "value");
+		if (strlen(path)) {
+			char *copy = bstrdup(path);
+			da_push_back(playout->filler_pool, &copy);
+		}
+		obs_data_release(filler);
+	}
+	obs_data_array_release(filler_pool);
+	playout->filler_lead = (float)obs_data_get_int(settings, "filler_lead");
+	bool share_decoders = obs_data_get_bool(settings, "share_decoders");
+	if (share_decoders != playout->share_decoders) {
+		playout->share_decoders = share_decoders;
+		playout_source_loop_release(playout);
+		for (size_t i = 0; i < playout->items.num; i++)
+			playout_source_item_release_source(playout, &playout->items.array[i]);
+	}
+	struct dstr setting_name;
+	dstr_init(&setting_name);
+	bool deferred = false;
+	for (int i = 0; playout_source_item_load(playout, settings, i, &setting_name, &deferred); i++)
+		;
+
+	dstr_free(&setting_name);
+	if (playout->resume_pending && playout->current_index < 0 && playout->items.num) {
+		blog(LOG_INFO, "[Playout Source] '%s' journal item %ld not found, starting at the first item",
+		     obs_source_get_name(playout->source), playout->resume_id);
+		playout->resume_pending = false;
+		playout->current_index = 0;
+		playout_source_update_current_source(playout, false);
+	}
+	if (deferred)
+		playout_source_defer_items(playout);
+	playout_source_shuffle_update(playout, settings);
+	playout_source_stats_plan(playout);
+	profile_end(profile_update_name);
+}
+
+static int64_t playout_source_item_length(struct playout_source_item *item)
+{
+	if (playout_source_item_timed(item))
+		return (int64_t)item->duration;
+	if (!item->source || item->type != PLAYOUT_ITEM_TYPE_MEDIA)
+		return 0;
+	int64_t duration = obs_source_media_get_duration(item->source) - (int64_t)item->start - (int64_t)item->end;
+	return duration > 0 ? duration : 0;
+}
+
+static void playout_source_item_scan(struct playout_source_context *playout, struct playout_source_item *item, bool force)
+{
+	const char *file = item->remote ? item->cached_path : item->path;
+	if (!file)
+		return;
+	/* the status is looked up again only after the scanner changed one */
+	if (force || item->scan_status == INTEGRITY_SCAN_NONE)
+		integrity_scan_request(file, force);
+	long generation = integrity_scan_generation();
+	if (!force && item->scan_status != INTEGRITY_SCAN_NONE && item->scan_generation == generation)
+		return;
+	item->scan_generation = generation;
+	int status = integrity_scan_get(file, NULL);
+	if (status == INTEGRITY_SCAN_FAILED && item->scan_status != status && playout->skip_failed)
+		blog(LOG_WARNING, "[Playout Source] '%s' will skip '%s' after a failed integrity scan",
+		     obs_source_get_name(playout->source), item->path);
+	item->scan_status = status;
+}
+
+/* the item that plays after index, following the shuffle bag in shuffle
+ * modes, -1 when nothing is known to follow */
+static int playout_source_prefetch_next(struct playout_source_context *playout, int index, size_t *ahead)
+{
+	if (playout_source_shuffled(playout)) {
+		if (playout->shuffle.cycle_end && !playout->loop)
+			return -1;
+		return shuffle_bag_peek_at(&playout->shuffle, (*ahead)++);
+	}
+	bool switch_scene = false;
+	int next = playout_source_next_index_after(playout, index, &switch_scene);
+	return switch_scene || next == index ? -1 : next;
+}
+
+static void playout_source_prefetch(struct playout_source_context *playout)
+{
+	if (playout->current_index < 0 || playout->current_index >= (int)playout->items.num)
+		return;
+	uint64_t now = os_gettime_ns();
+	int64_t offset = 0;
+	struct playout_source_item *current = playout_source_current_item(playout);
+	if (current) {
+		int64_t time = playout_source_item_timed(current) ? (int64_t)(current->elapsed_ns / 1000000)
+								  : obs_source_media_get_time(current->source) - (int64_t)current->start;
+		offset = playout_source_item_length(current) - time;
+		if (offset < 0)
+			offset = 0;
+	}
+	int cued = playout->cue_id ? playout_source_find_id(playout, playout->cue_id) : -1;
+	size_t ahead = 0;
+	int index = playout->current_index;
+	for (size_t n = 0; n < playout->items.num && index >= 0; n++) {
+		struct playout_source_item *item = &playout->items.array[index];
+		if (n && (uint64_t)offset * 1000000 > playout->prefetch_window_ns)
+			break;
+		bool changed = false;
+		if (item->remote && !item->cached_path) {
+			item->cached_path = media_cache_get(item->path, item->checksum);
+			if (item->cached_path)
+				changed = true;
+			else
+				media_cache_request(item->path, item->checksum, now + (uint64_t)offset * 1000000);
+		}
+		if (item->use_proxy && !item->proxy_path &&
+		    playout_source_item_check_proxy(item, item->remote ? item->cached_path : item->path))
+			changed = true;
+		if (playout->scan && item->type == PLAYOUT_ITEM_TYPE_MEDIA)
+			playout_source_item_scan(playout, item, false);
+		if (changed && (index != playout->current_source_index || !playout->current_source)) {
+			playout_source_item_release_source(playout, item);
+			playout_source_item_create(playout, index);
+			/* a cued or first audio-only item goes on air once its proxy is there */
+			if (index == playout->current_index && !playout->current_source)
+				playout_source_update_current_source(playout, false);
+		}
+		if (n) {
+			int64_t length = playout_source_item_length(item);
+			offset += length ? length : PREFETCH_UNKNOWN_LENGTH_MS;
+		}
+		if (!n && cued >= 0 && cued != index)
+			index = cued;
+		else
+			index = playout_source_prefetch_next(playout, index, &ahead);
+	}
+}
+
+/* Items that fell back to a private decoder are handed back to the registry
+ * once they are off air and not up next, which releases the private decoder. */
+static void playout_source_share_again(struct playout_source_context *playout)
+{
+	if (!playout->share_decoders)
+		return;
+	bool switch_scene;
+	int next = playout_source_next_index(playout, &switch_scene);
+	for (size_t i = 0; i < playout->items.num; i++) {
+		struct playout_source_item *item = &playout->items.array[i];
+		if (!item->private_fallback || !item->source || item->source == playout->current_source || (int)i == next ||
+		    item->id == playout->cue_id)
+			continue;
+		playout_source_item_release_source(playout, item);
+		playout_source_item_create(playout, (int)i);
+	}
+}
+
+/* like playout_source_item_length, but falls back to the probed duration of
+ * the file while the item source has not loaded it yet, -1 while probing */
+static int64_t playout_source_filler_length(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	int64_t length = playout_source_item_length(item);
+	if (length > 0 || item->type != PLAYOUT_ITEM_TYPE_MEDIA)
+		return length;
+	int64_t duration = filler_get_duration(playout_source_item_file(playout, item));
+	if (duration == FILLER_DURATION_PENDING)
+		return -1;
+	if (duration == FILLER_DURATION_ERROR)
+		return 0;
+	duration -= (int64_t)item->start + (int64_t)item->end;
+	return duration > 0 ? duration : 0;
+}
+
+/* Once the next item with a hard start is within the filler lead, the time
+ * between its expected start and the hard start is closed with fillers from
+ * the pool. They go through the edit queue, so they are created and prerolled
+ * before they are needed like any inserted item. */
+static void playout_source_fill_gap(struct playout_source_context *playout)
+{
+	if (!playout->filler_pool.num || playout->filler_lead <= 0.0f ||
+	    (playout->playback_mode != PLAYBACK_MODE_LIST && playout->playback_mode != PLAYBACK_MODE_SECTION))
+		return;
+	struct playout_source_item *current = playout_source_current_item(playout);
+	if (!current)
+		return;
+	current->filler_planned = false;
+	int64_t lead_ms = (int64_t)(playout->filler_lead * 1000.0f);
+	int64_t time = playout_source_item_timed(current) ? (int64_t)(current->elapsed_ns / 1000000)
+							  : obs_source_media_get_time(current->source) - (int64_t)current->start;
+	int64_t offset = playout_source_filler_length(playout, current);
+	if (offset < 0)
+		return;
+	offset = offset > time ? offset - time : 0;
+
+	int index = playout->current_source_index;
+	struct playout_source_item *hard = NULL;
+	bool switch_scene = false;
+	for (size_t n = 1; n < playout->items.num && !hard; n++) {
+		int next = playout_source_next_index_after(playout, index, &switch_scene);
+		if (switch_scene || next == index || next == playout->current_source_index)
+			return;
+		index = next;
+		if (playout->items.array[index].hard_start_ms >= 0) {
+			hard = &playout->items.array[index];
+		} else if (!playout_source_item_skipped(playout, index)) {
+			int64_t length = playout_source_filler_length(playout, &playout->items.array[index]);
+			if (length < 0)
+				return;
+			offset += length;
+			if (offset > lead_ms)
+				return;
+		}
+	}
+	if (!hard || hard->filler_planned || offset > lead_ms)
+		return;
+
+	int64_t until = hard->hard_start_ms - playout_source_local_day_ms();
+	if (until < -DAY_MS / 2)
+		until += DAY_MS;
+	else if (until > DAY_MS / 2)
+		until -= DAY_MS;
+	int64_t gap = until - offset;
+	if (gap < FILLER_MIN_GAP_MS) {
+		hard->filler_planned = true;
+		if (gap < 0)
+			blog(LOG_WARNING, "[Playout Source] '%s' item %d will start %lld ms after its hard start",
+			     obs_source_get_name(playout->source), index + 1, (long long)-gap);
+		return;
+	}
+
+	DARRAY(int64_t) durations;
+	da_init(durations);
+	for (size_t i = 0; i < playout->filler_pool.num; i++) {
+		int64_t duration = filler_get_duration(playout->filler_pool.array[i]);
+		if (duration == FILLER_DURATION_PENDING) {
+			da_free(durations);
+			return;
+		}
+		da_push_back(durations, &duration);
+	}
+	hard->filler_planned = true;
+	struct filler_plan plan;
+	if (!filler_plan(durations.array, durations.num, gap, &plan)) {
+		blog(LOG_WARNING, "[Playout Source] '%s' no fillers found for the %lld ms before item %d",
+		     obs_source_get_name(playout->source), (long long)gap, index + 1);
+		da_free(durations);
+		return;
+	}
+
+	obs_data_t *request = obs_data_create();
+	obs_data_array_t *batch = obs_data_array_create();
+	for (size_t p = 0; p < plan.picks.num; p++) {
+		obs_data_t *item = obs_data_create();
+		obs_data_set_int(item, "type", PLAYOUT_ITEM_TYPE_MEDIA);
+		obs_data_set_string(item, "path", playout->filler_pool.array[plan.picks.array[p]]);
+		if (hard->section)
+			obs_data_set_string(item, "section", hard->section);
+		if (p == plan.trim_pick && plan.trim_ms)
+			obs_data_set_double(item, "end", (double)-plan.trim_ms / 1000.0);
+		obs_data_set_bool(item, "filler", true);
+		obs_data_t *edit = obs_data_create();
+		obs_data_set_string(edit, "op", "insert");
+		obs_data_set_int(edit, "id", os_atomic_inc_long(&playout->next_id));
+		obs_data_set_int(edit, "index", index + (int)p);
+		obs_data_set_obj(edit, "item", item);
+		obs_data_array_push_back(batch, edit);
+		obs_data_release(edit);
+		obs_data_release(item);
+	}
+	obs_data_set_array(request, "edits", batch);
+	obs_data_array_release(batch);
+	playout_source_queue_edits(playout, request);
+	blog(LOG_INFO, "[Playout Source] '%s' filling %lld ms before item %d with %d fillers, the last trimmed by %lld ms",
+	     obs_source_get_name(playout->source), (long long)gap, index + 1, (int)plan.picks.num, (long long)plan.trim_ms);
+	filler_plan_free(&plan);
+	da_free(durations);
+}
+
+static bool playout_source_loop_eligible(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	return playout->seamless_loop && playout->loop && playout->playback_mode == PLAYBACK_MODE_SINGLE && item &&
+	       item->type == PLAYOUT_ITEM_TYPE_MEDIA && !playout->cue_id;
+}
+
+/* With shared decoders the twin comes from the registry under its own key, so
+ * playouts looping the same file reuse it. It stays claimed while parked, a
+ * twin claimed by another playout is replaced by a private one. */
+static void playout_source_loop_create(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	const char *file = playout_source_item_file(playout, item);
+	obs_data_t *ss = playout_source_item_settings(file, item);
+	struct dstr name;
+	dstr_init(&name);
+	if (playout->share_decoders) {
+		struct dstr key;
+		dstr_init(&key);
+		playout_source_item_media_key(item, file, &key);
+		dstr_cat(&key, "|loop");
+		const char *base = strrchr(item->path, '/');
+		const char *base2 = strrchr(item->path, '\\');
+		if (base2 > base)
+			base = base2;
+		dstr_printf(&name, "Playout shared %s (loop)", base ? base + 1 : item->path);
+		bool first = false;
+		playout->loop_source = source_registry_acquire("ffmpeg_source", key.array, name.array, ss, playout, &first);
+		dstr_free(&key);
+		if (source_registry_claim(playout->loop_source, playout)) {
+			if (first)
+				playout_source_item_connect(playout, playout->loop_source);
+			playout->loop_shared = true;
+		} else {
+			source_registry_release(playout->loop_source, playout);
+			obs_source_release(playout->loop_source);
+			playout->loop_source = NULL;
+		}
+	}
+	if (!playout->loop_source) {
+		dstr_printf(&name, "%s (%d loop)", obs_source_get_name(playout->source), playout->current_source_index + 1);
+		playout->loop_source = obs_source_create_private("ffmpeg_source", name.array, ss);
+		playout_source_item_connect(playout, playout->loop_source);
+		playout->loop_shared = false;
+	}
+	obs_data_release(ss);
+	dstr_free(&name);
+	playout->loop_index = playout->current_source_index;
+	playout->loop_seek = true;
+	playout->loop_ready = false;
+}
+
+static void playout_source_loop_preroll(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	if (!playout->loop_source)
+		playout_source_loop_create(playout, item);
+	if (!playout->loop_seek)
+		return;
+	enum obs_media_state state = obs_source_media_get_state(playout->loop_source);
+	if (state == OBS_MEDIA_STATE_ENDED || state == OBS_MEDIA_STATE_STOPPED) {
+		obs_source_media_restart(playout->loop_source);
+		return;
+	}
+	/* the cut pauses the old decoder before seeking it, it plays again up to the first frame */
+	if (state == OBS_MEDIA_STATE_PAUSED) {
+		obs_source_media_play_pause(playout->loop_source, false);
+		return;
+	}
+	if (state != OBS_MEDIA_STATE_PLAYING)
+		return;
+	/* a decoder still reporting the old position has not seen the seek yet */
+	int64_t time = obs_source_media_get_time(playout->loop_source);
+	if (time < (int64_t)item->start || time > (int64_t)item->start + 1000) {
+		obs_source_media_set_time(playout->loop_source, item->start);
+		return;
+	}
+	if (!playout_source_item_frame_ready(item, playout->loop_source))
+		return;
+	obs_source_media_play_pause(playout->loop_source, true);
+	playout->loop_seek = false;
+	playout->loop_ready = true;
+}
+
+/* Both decoders stay claimed, the one going off air becomes the parked twin. */
+static void playout_source_loop_cut(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	obs_source_t *next = playout->loop_source;
+	obs_source_t *prev = playout->current_source;
+	bool next_shared = playout->loop_shared;
+
+	obs_source_media_play_pause(next, false);
+	obs_source_inc_showing(next);
+	obs_source_add_active_child(playout->source, next);
+	if (playout->current_transition)
+		obs_transition_set(playout->current_transition, next);
+	obs_source_remove_active_child(playout->source, prev);
+	obs_source_dec_showing(prev);
+
+	playout->loop_source = item->source;
+	playout->loop_shared = item->shared;
+	item->source = next;
+	item->shared = next_shared;
+	playout->current_source = obs_source_get_ref(next);
+	obs_source_release(prev);
+
+	obs_source_media_play_pause(playout->loop_source, true);
+	obs_source_media_set_time(playout->loop_source, item->start);
+	playout->loop_seek = true;
+	playout->loop_ready = false;
+}
+
+/* In single mode with loop the out-point normally seeks the decoder back to the
+ * in-point, which stalls video and audio. Seamless loop keeps a second decoder
+ * parked on the in-point and swaps to it on the last frame before the out-point. */
+static bool playout_source_seamless_loop(struct playout_source_context *playout)
+{
+	struct playout_source_item *item = playout_source_current_item(playout);
+	if (!playout_source_loop_eligible(playout, item)) {
+		playout_source_loop_release(playout);
+		return false;
+	}
+	if (playout->loop_index != playout->current_source_index)
+		playout_source_loop_release(playout);
+	playout_source_loop_preroll(playout, item);
+	if (!playout->loop_ready || !playout->playing || (playout->auto_play && !playout->active))
+		return false;
+	int64_t duration = obs_source_media_get_duration(item->source);
+	if (duration <= 0)
+		return false;
+	struct obs_video_info ovi;
+	int64_t frame = obs_get_video_info(&ovi) && ovi.fps_num ? (int64_t)ovi.fps_den * 1000 / ovi.fps_num : 0;
+	int64_t time = obs_source_media_get_time(item->source);
+	enum obs_media_state state = obs_source_media_get_state(item->source);
+	if (state != OBS_MEDIA_STATE_ENDED && time + frame < duration - (int64_t)item->end)
+		return false;
+	long planned_id = playout->stats.planned_id;
+	playout_source_loop_cut(playout, item);
+	playout_source_stats_record(playout, time - (duration - (int64_t)item->end), item->id, planned_id);
+	return true;
+}
+
+static void playout_source_count_resources(struct playout_source_context *playout)
+{
+	long decoders = 0;
+	long transitions = 0;
+	uint64_t memory = 0;
+	for (size_t i = 0; i < playout->items.num; i++) {
+		struct playout_source_item *item = &playout->items.array[i];
+		if (item->transition)
+			transitions++;
+		if (!item->source || item->type == PLAYOUT_ITEM_TYPE_SOURCE)
+			continue;
+		/* a shared decoder is counted by the playout that has it claimed */
+		if (item->shared && !source_registry_claimed_by(item->source, playout))
+			continue;
+		uint64_t frame = (uint64_t)obs_source_get_width(item->source) * obs_source_get_height(item->source) *
+				 ESTIMATE_BYTES_PER_PIXEL;
+		if (item->type == PLAYOUT_ITEM_TYPE_MEDIA) {
+			decoders++;
+			memory += frame * ESTIMATE_MEDIA_FRAMES;
+		} else {
+			memory += frame;
+		}
+	}
+	if (playout->loop_source) {
+		decoders++;
+		memory += (uint64_t)obs_source_get_width(playout->loop_source) * obs_source_get_height(playout->loop_source) *
+			  ESTIMATE_BYTES_PER_PIXEL * ESTIMATE_MEDIA_FRAMES;
+	}
+	if (playout->render)
+		memory += (uint64_t)playout->fixed_width * playout->fixed_height * ESTIMATE_BYTES_PER_PIXEL;
+	os_atomic_set_long(&playout->metrics.decoders, decoders);
+	os_atomic_set_long(&playout->metrics.transitions, transitions);
+	os_atomic_set_long(&playout->metrics.memory_kb, (long)(memory / 1024));
+}
+
+static void playout_source_in_active_tree(obs_source_t *parent, obs_source_t *child, void *data)
+{
+	UNUSED_PARAMETER(parent);
+	struct playout_source_context *playout = data;
+	if (playout->source == child) {
+		playout->active = true;
+	}
+}
+
+static void playout_source_deactivate(void *data)
+{
+	struct playout_source_context *playout = data;
+	if (playout->next_after_transition) {
+		if (playout->current_index >= (int)playout->items.num - 1) {
+			playout->current_index = 0;
+		} else {
+			playout->current_index++;
+		}
+		playout->end_reason = "transition";
+		playout_source_update_current_source(playout, false);
+		playout->next_after_transition = false;
+	}
+	playout->active = false;
+	playout_source_stats_log(playout);
+}
+
+static void playout_source_resume(struct playout_source_context *playout, float seconds)
+{
+	struct playout_source_item *item = playout_source_current_item(playout);
+	if (!item)
+		return;
+	int64_t length = playout_source_item_length(item);
+	if (length <= 0 && item->type == PLAYOUT_ITEM_TYPE_MEDIA) {
+		playout->resume_wait += seconds;
+		if (playout->resume_wait < RESUME_WAIT_SECONDS)
+			return;
+	}
+	playout->resume_wait = 0.0f;
+	if (playout->resume_mode == RESUME_MODE_SCHEDULE && length > 0 && playout->resume_offset_ms >= length) {
+		bool switch_scene;
+		int next = playout_source_next_index(playout, &switch_scene);
+		if (!switch_scene && next >= 0 && next != playout->current_index) {
+			if (playout_source_shuffled(playout) && next == shuffle_bag_peek_at(&playout->shuffle, 0))
+				shuffle_bag_advance(&playout->shuffle, playout->items.array, playout->shuffle_no_repeat);
+			playout->resume_offset_ms -= length;
+			playout->current_index = next;
+			playout_source_update_current_source(playout, false);
+			return;
+		}
+	}
+	int64_t offset = playout->resume_offset_ms;
+	if (length > 0 && offset >= length)
+		offset = length;
+	playout->resume_pending = false;
+	playout->resumed = offset > 0;
+	blog(LOG_INFO, "[Playout Source] '%s' resuming item %d at %lld ms", obs_source_get_name(playout->source),
+	     playout->current_index + 1, (long long)offset);
+	if (playout_source_item_timed(item)) {
+		item->elapsed_ns = (uint64_t)offset * 1000000;
+	} else if (item->type == PLAYOUT_ITEM_TYPE_MEDIA && item->source && offset > 0) {
+		obs_source_media_set_time(item->source, (int64_t)item->start + offset);
+		item->seek_start = true;
+	}
+	playout_source_journal(playout);
+}
+
+static void playout_source_item_preroll(struct playout_source_context *playout, struct playout_source_item *item)
+{
+	if (!playout_source_item_controlled(playout, item))
+		return;
+	if (playout_source_item_timed(item)) {
+		item->elapsed_ns = 0;
+	} else if (item->type == PLAYOUT_ITEM_TYPE_MEDIA) {
+		enum obs_media_state state = obs_source_media_get_state(item->source);
+		if (state == OBS_MEDIA_STATE_ENDED || state == OBS_MEDIA_STATE_STOPPED) {
+			obs_source_media_restart(item->source);
+			if (item->start)
+				obs_source_media_set_time(item->source, item->start);
+		} else {
+			obs_source_media_set_time(item->source, item->start);
+			obs_source_media_play_pause(item->source, false);
+		}
+		item->seek_start = true;
+	}
+}
+
+static bool playout_source_next_ready(struct playout_source_context *playout)
+{
+	bool switch_scene;
+	int next = playout_source_next_index(playout, &switch_scene);
+	if (switch_scene || next < 0 || next == playout->current_source_index)
+		return true;
+	playout_source_item_create_deferred(playout, next);
+	struct playout_source_item *item = &playout->items.array[next];
+	if (item->type != PLAYOUT_ITEM_TYPE_MEDIA || !item->source)
+		return true;
+	if (item->shared && (item->source == playout->current_source || !playout_source_item_controlled(playout, item)))
+		playout_source_item_use_private(playout, next);
+	if (item->seek_start)
+		return false;
+	enum obs_media_state state = obs_source_media_get_state(item->source);
+	if (state == OBS_MEDIA_STATE_ENDED || state == OBS_MEDIA_STATE_STOPPED) {
+		playout_source_item_preroll(playout, item);
+		return false;
+	}
+	return state != OBS_MEDIA_STATE_NONE && playout_source_item_frame_ready(item, item->source);
+}
+
+/* Members of a sync group only switch when the group commits. The master asks
+ * for the commit once every member has its next item decoded and waiting. */
+static bool playout_source_sync_hold(struct playout_source_context *playout)
+{
+	if (!playout->sync_group)
+		return false;
+	if (!sync_group_is_master(playout->sync_group, playout)) {
+		playout->switch_to_next = false;
+		return true;
+	}
+	if (!sync_group_all_ready(playout->sync_group))
+		return true;
+	playout->switch_to_next = false;
+	sync_group_request_switch(playout->sync_group, obs_get_video_frame_time());
+	return true;
 }
 
-static void playout_source_update(void *data, obs_data_t *settings)
+static void playout_source_sync_tick(struct playout_source_context *playout)
 {
-	struct playout_source_context *playout = data;
-	playout->auto_play = obs_data_get_bool(settings, "autoplay");
-	playout->loop = obs_data_get_bool(settings, "loop");
-	playout->playback_mode = (int)obs_data_get_int(settings, "playback_mode");
-	struct dstr setting_name;
-	dstr_init(&setting_name);
+	if (!playout->sync_group)
+		return;
+	if (sync_group_switch_due(playout->sync_group, &playout->sync_seq, obs_get_video_frame_time())) {
+		if (!playout->end_reason)
+			playout->end_reason = "sync";
+		playout_source_switch_to_next_item(playout);
+	}
+	sync_group_set_ready(playout->sync_group, playout, playout_source_next_ready(playout));
+}
 
-	for (int i = 0;; i++) {
-		dstr_printf(&setting_name, "path%d", i);
-		const char *path = obs_data_get_string(settings, setting_name.array);
-		if (!strlen(path))
+/* Items that are not on air are created after load, a few per tick starting at
+ * the current item, so loading a collection does not depend on list length. */
+static void playout_source_create_deferred(struct playout_source_context *playout)
+{
+	if (!playout->deferred_pending)
+		return;
+	uint64_t start = os_gettime_ns();
+	size_t count = playout->items.num;
+	for (size_t n = 0; n < DEFERRED_SCAN_PER_TICK; n++) {
+		if (playout->deferred_scanned >= count) {
+			playout->deferred_pending = false;
 			break;
-		if (i >= (int)playout->items.num) {
-			da_push_back_new(playout->items);
-		}
-		if (i == playout->current_index && playout->items.array[i].source) {
-			obs_data_t *s = obs_source_get_settings(playout->items.array[i].source);
-			if (strcmp(obs_data_get_string(s, "local_file"), path) != 0) {
-				obs_source_release(playout->items.array[i].source);
-				playout->items.array[i].source = NULL;
-			}
-			obs_data_release(s);
-		}
-
-		dstr_printf(&setting_name, "start%d", i);
-		playout->items.array[i].start = (uint64_t)(obs_data_get_double(settings, setting_name.array) * 1000.0);
-		dstr_printf(&setting_name, "end%d", i);
-		playout->items.array[i].end = (uint64_t)(obs_data_get_double(settings, setting_name.array) * -1000.0);
-
-		if (!playout->items.array[i].source) {
-			dstr_printf(&setting_name, "%s (%d)", obs_source_get_name(playout->source), i + 1);
-			playout->items.array[i].source = obs_source_create_private("ffmpeg_source", setting_name.array, NULL);
-			signal_handler_t *sh = obs_source_get_signal_handler(playout->items.array[i].source);
-			signal_handler_connect(sh, "media_ended", playout_source_media_ended, data);
-			signal_handler_connect(sh, "media_started", playout_source_media_started, data);
-		}
-		if (!playout->current_source && (i == playout->current_index || playout->current_index < 0)) {
-			playout->current_index = i;
-			playout_source_update_current_source(playout, false);
-		}
-		obs_data_t *ss = obs_data_create();
-		obs_data_set_bool(ss, "is_local_file", true);
-		obs_data_set_string(ss, "local_file", path);
-		obs_data_set_bool(ss, "looping", false);
-		obs_data_set_bool(ss, "is_stinger", false);
-		obs_data_set_bool(ss, "hw_decode", true);
-		obs_data_set_bool(ss, "close_when_inactive", false);
-		obs_data_set_bool(ss, "clear_on_media_end", false);
-		obs_data_set_bool(ss, "restart_on_activate", false);
-
-		dstr_printf(&setting_name, "speed_percent%d", i);
-		obs_data_set_default_int(settings, setting_name.array, 100);
-		playout->items.array[i].speed = (uint32_t)obs_data_get_int(settings, setting_name.array);
-		if (!playout->items.array[i].speed)
-			playout->items.array[i].speed = 100;
-		obs_data_set_int(ss, "speed_percent", playout->items.array[i].speed);
-		obs_source_update(playout->items.array[i].source, ss);
-		obs_data_release(ss);
-		dstr_printf(&setting_name, "transition%d", i);
-		const char *transition = obs_data_get_string(settings, setting_name.array);
-		if (strlen(transition)) {
-			if (!playout->items.array[i].transition ||
-			    strcmp(obs_source_get_unversioned_id(playout->items.array[i].transition), transition) != 0) {
-				obs_source_release(playout->items.array[i].transition);
-
-				dstr_printf(&setting_name, "transition_settings%d", i);
-				obs_data_t *transition_settings = obs_data_get_obj(settings, setting_name.array);
-				if (!transition_settings) {
-					transition_settings = obs_data_create();
-					obs_data_set_obj(settings, setting_name.array, transition_settings);
-				}
-				playout->items.array[i].transition =
-					obs_source_create_private(transition, "test", transition_settings);
-				signal_handler_t *sh = obs_source_get_signal_handler(playout->items.array[i].transition);
-				signal_handler_connect(sh, "transition_stop", playout_source_transition_stop, data);
-				//signal_handler_connect(sh, "transition_video_stop", playout_source_transition_video_stop, data);
-
-				obs_data_release(transition_settings);
-			}
-		} else if (playout->items.array[i].transition) {
-			obs_source_release(playout->items.array[i].transition);
-			playout->items.array[i].transition = NULL;
 		}
-		dstr_printf(&setting_name, "transition_duration%d", i);
-		playout->items.array[i].transition_duration_ms = (uint32_t)obs_data_get_int(settings, setting_name.array);
+		if (playout->deferred_cursor >= count)
+			playout->deferred_cursor = 0;
+		int i = (int)playout->deferred_cursor++;
+		playout->deferred_scanned++;
+		if (!playout_source_item_create_deferred(playout, i))
+			continue;
+		playout->deferred_scanned = 0;
+		if (os_gettime_ns() - start > DEFERRED_BUDGET_NS)
+			break;
 	}
+}
 
-	dstr_free(&setting_name);
+static void playout_source_cue(struct playout_source_context *playout, int index)
+{
+	if (index < 0 || index >= (int)playout->items.num)
+		return;
+	struct playout_source_item *item = &playout->items.array[index];
+	playout_source_item_create_deferred(playout, index);
+	playout->cue_id = item->id;
+	blog(LOG_INFO, "[Playout Source] '%s' cued item %d", obs_source_get_name(playout->source), index + 1);
+	if (index == playout->current_source_index || !item->source)
+		return;
+	if (item->shared && item->type == PLAYOUT_ITEM_TYPE_MEDIA && item->source == playout->current_source)
+		playout_source_item_use_private(playout, index);
+	if (item->source == playout->current_source)
+		return;
+	playout_source_item_preroll(playout, item);
 }
 
-static void playout_source_in_active_tree(obs_source_t *parent, obs_source_t *child, void *data)
+static int playout_source_cue_base(struct playout_source_context *playout)
 {
-	UNUSED_PARAMETER(parent);
-	struct playout_source_context *playout = data;
-	if (playout->source == child) {
-		playout->active = true;
+	int cued = playout->cue_id ? playout_source_find_id(playout, playout->cue_id) : -1;
+	return cued >= 0 ? cued : playout->current_index;
+}
+
+static void playout_source_process_cue(struct playout_source_context *playout, struct playout_cue_request *request)
+{
+	int count = (int)playout->items.num;
+	int base = playout_source_cue_base(playout);
+	int index = -1;
+	if (request->type == CUE_REQUEST_ID) {
+		index = playout_source_find_id(playout, request->value);
+	} else if (request->type == CUE_REQUEST_INDEX) {
+		index = (int)request->value;
+	} else if (request->type == CUE_REQUEST_SECTION) {
+		for (int i = 0; i < count && index < 0; i++) {
+			const char *section = playout->items.array[i].section;
+			if (section && request->section && strcmp(section, request->section) == 0)
+				index = i;
+		}
+	} else if (request->type == CUE_REQUEST_NEXT) {
+		index = base < count - 1 ? base + 1 : (playout->loop ? 0 : base);
+	} else if (request->type == CUE_REQUEST_PREVIOUS) {
+		index = base > 0 ? base - 1 : 0;
+	} else if (request->type == CUE_REQUEST_NEXT_SECTION && base >= 0) {
+		for (int n = 1; n < count && index < 0; n++) {
+			int i = (base + n) % count;
+			if (!playout_source_same_section(&playout->items.array[i], &playout->items.array[base]))
+				index = i;
+		}
 	}
+	if (index < 0 || index >= count) {
+		blog(LOG_WARNING, "[Playout Source] '%s' nothing to cue", obs_source_get_name(playout->source));
+		return;
+	}
+	playout_source_cue(playout, index);
 }
 
-static void playout_source_deactivate(void *data)
+/* Cue requests and takes arrive from hotkey and proc threads and are applied
+ * at the start of the next tick, so a take goes to air on the following frame. */
+static void playout_source_apply_cues(struct playout_source_context *playout)
 {
-	struct playout_source_context *playout = data;
-	if (playout->next_after_transition) {
-		if (playout->current_index >= (int)playout->items.num - 1) {
-			playout->current_index = 0;
-		} else {
-			playout->current_index++;
+	if (os_atomic_load_bool(&playout->cues_pending)) {
+		pthread_mutex_lock(&playout->edits_mutex);
+		DARRAY(struct playout_cue_request) requests;
+		da_init(requests);
+		da_move(requests, playout->cue_requests);
+		os_atomic_set_bool(&playout->cues_pending, false);
+		pthread_mutex_unlock(&playout->edits_mutex);
+		for (size_t i = 0; i < requests.num; i++) {
+			playout_source_process_cue(playout, &requests.array[i]);
+			bfree(requests.array[i].section);
 		}
-		playout_source_update_current_source(playout, false);
-		playout->next_after_transition = false;
+		da_free(requests);
+		playout_source_stats_plan(playout);
 	}
-	playout->active = false;
+
+	long take = os_atomic_exchange_long(&playout->take_request, TAKE_REQUEST_NONE);
+	if (take == TAKE_REQUEST_NONE || !playout->cue_id)
+		return;
+	int index = playout_source_find_id(playout, playout->cue_id);
+	playout->cue_id = 0;
+	if (index < 0)
+		return;
+	playout->end_reason = "take";
+	playout->current_index = index;
+	playout_source_update_current_source(playout, take == TAKE_REQUEST_TRANSITION);
 }
 
-static void playout_source_video_tick(void *data, float seconds)
+/* the transition on air is sized only when it, the size or the scale mode changed */
+static void playout_source_size_transition(struct playout_source_context *playout)
+{
+	obs_source_t *transition = playout->current_transition;
+	if (!playout->fixed_size || !transition)
+		return;
+	if (!obs_weak_source_expired(playout->sized_transition) &&
+	    obs_weak_source_references_source(playout->sized_transition, transition) &&
+	    playout->sized_width == playout->fixed_width && playout->sized_height == playout->fixed_height &&
+	    playout->sized_mode == playout->scale_mode)
+		return;
+	obs_transition_set_size(transition, playout->fixed_width, playout->fixed_height);
+	obs_transition_set_scale_type(transition, playout->scale_mode == SCALE_MODE_STRETCH ? OBS_TRANSITION_SCALE_STRETCH
+											     : OBS_TRANSITION_SCALE_ASPECT);
+	obs_weak_source_release(playout->sized_transition);
+	playout->sized_transition = obs_source_get_weak_source(transition);
+	playout->sized_width = playout->fixed_width;
+	playout->sized_height = playout->fixed_height;
+	playout->sized_mode = playout->scale_mode;
+}
+
+static void playout_source_apply_edits(struct playout_source_context *playout);
+
+static void playout_source_tick(void *data, float seconds)
 {
-	UNUSED_PARAMETER(seconds);
 	struct playout_source_context *playout = data;
+	playout_source_apply_edits(playout);
+	playout_source_apply_cues(playout);
+	playout_source_swap_events(playout);
+	playout_source_create_deferred(playout);
+	playout_source_sync_tick(playout);
+	uint64_t now = os_gettime_ns();
 	for (size_t i = 0; i < playout->items.num; i++) {
 		if (!playout->items.array[i].seek_start)
 			continue;
+		if (!playout_source_item_controlled(playout, &playout->items.array[i])) {
+			playout->items.array[i].seek_start = false;
+			playout->items.array[i].seek_ns = 0;
+			continue;
+		}
+		if (!playout->items.array[i].seek_ns)
+			playout->items.array[i].seek_ns = now;
 		enum obs_media_state state = obs_source_media_get_state(playout->items.array[i].source);
 		if (state == OBS_MEDIA_STATE_NONE)
 			continue;
 		if (state != OBS_MEDIA_STATE_PLAYING) {
 			playout->items.array[i].seek_start = false;
+			playout->items.array[i].seek_ns = 0;
 			continue;
 		}
 		if (obs_source_media_get_time(playout->items.array[i].source) <= (int64_t)playout->items.array[i].start)
 			continue;
-		if (!obs_source_get_width(playout->items.array[i].source))
+		if (!playout_source_item_frame_ready(&playout->items.array[i], playout->items.array[i].source))
 			continue;
 		playout->items.array[i].seek_start = false;
+		metrics_histogram_add(&playout->metrics.seek_ms, (long)((now - playout->items.array[i].seek_ns) / 1000000));
+		playout->items.array[i].seek_ns = 0;
 		if (playout->current_source != playout->items.array[i].source) {
 			obs_source_media_play_pause(playout->items.array[i].source, true);
 		} else if (playout->auto_play && !playout->active) {
@@ -493,11 +2666,34 @@ static void playout_source_video_tick(void *data, float seconds)
 		}
 	}
 
+	playout->rendered = false;
+	playout_source_update_audio_only(playout);
+	playout_source_size_transition(playout);
+
 	if (playout->switch_to_next) {
-		playout_source_switch_to_next_item(playout);
-		return;
+		playout->end_reason = "media_ended";
+		if (!playout_source_sync_hold(playout)) {
+			/* the out-point lies the transition and the end trim before the end of the file */
+			struct playout_source_item *ended = playout_source_current_item(playout);
+			int64_t lead = ended ? (int64_t)ended->end + (ended->transition ? ended->transition_duration_ms : 0) : 0;
+			playout_source_switch_at_end(playout, lead + (int64_t)(os_gettime_ns() - playout->stats.ended_ns) / 1000000);
+			return;
+		}
+	}
+
+	playout->prefetch_elapsed += seconds;
+	if (playout->prefetch_elapsed >= 1.0f) {
+		playout->prefetch_elapsed = 0.0f;
+		playout_source_prefetch(playout);
+		playout_source_share_again(playout);
+		playout_source_fill_gap(playout);
+		playout_source_count_resources(playout);
 	}
 
+	if (!playout->current_source && playout->current_index >= 0 && playout->current_index < (int)playout->items.num &&
+	    playout->items.array[playout->current_index].type == PLAYOUT_ITEM_TYPE_SOURCE)
+		playout_source_update_current_source(playout, false);
+
 	if (playout->auto_play) {
 		bool old = playout->active;
 		playout->active = false;
@@ -515,17 +2711,34 @@ static void playout_source_video_tick(void *data, float seconds)
 		}
 	}
 
+	if (playout->resume_pending && playout->current_source)
+		playout_source_resume(playout, seconds);
+
 	if (!playout->playing)
 		return;
 
-	if (!playout->current_source)
+	if (!playout->current_source || playout->current_index < 0 || playout->current_index >= (int)playout->items.num)
 		return;
 
-	int64_t duration = obs_source_media_get_duration(playout->current_source);
-	if (duration <= 0)
+	if (playout_source_seamless_loop(playout))
 		return;
 
-	int64_t time = obs_source_media_get_time(playout->current_source);
+	struct playout_source_item *item = playout_source_current_item(playout);
+	int64_t duration;
+	int64_t time;
+	int64_t end = (int64_t)playout->items.array[playout->current_index].end;
+	if (playout_source_item_timed(item)) {
+		if (!playout->auto_play || playout->active)
+			item->elapsed_ns += (uint64_t)((double)seconds * 1000000000.0);
+		duration = (int64_t)item->duration;
+		time = (int64_t)(item->elapsed_ns / 1000000);
+		end = 0;
+	} else {
+		duration = obs_source_media_get_duration(playout->current_source);
+		if (duration <= 0)
+			return;
+		time = obs_source_media_get_time(playout->current_source);
+	}
 	bool use_global_transition = playout_source_use_global_transition(playout);
 	bool last = playout_source_last(playout);
 
@@ -542,18 +2755,61 @@ static void playout_source_video_tick(void *data, float seconds)
 		}
 	}
 
-	if (time >= duration - transition_duration - (int64_t)playout->items.array[playout->current_index].end) {
+	playout->as_run_out_ms = time;
+	playout_source_events_tick(playout, item, playout_source_item_timed(item) ? time : time - (int64_t)item->start);
+
+	if (playout->journal_interval > 0.0f) {
+		playout->journal_elapsed += seconds;
+		if (playout->journal_elapsed >= playout->journal_interval)
+			playout_source_journal(playout);
+	}
+
+	if (playout->status_interval > 0.0f) {
+		playout->status_elapsed += seconds;
+		if (playout->status_elapsed >= playout->status_interval) {
+			playout->status_elapsed = 0.0f;
+			int64_t start = item && !playout_source_item_timed(item) ? (int64_t)item->start : 0;
+			int64_t remaining = duration - transition_duration - end - time;
+			playout_source_signal_remaining(playout, remaining > 0 ? remaining : 0, duration - start - end);
+		}
+	}
+
+	int64_t out_point = duration - transition_duration - end;
+	/* played again after the end of the file the decoder reopens it, so an item
+	 * looping on itself is seeked back on its last frame instead */
+	if (playout->playback_mode == PLAYBACK_MODE_SINGLE && playout->loop && !playout_source_item_timed(item)) {
+		struct obs_video_info ovi;
+		if (obs_get_video_info(&ovi) && ovi.fps_num)
+			out_point -= (int64_t)ovi.fps_den * 1000 / ovi.fps_num;
+	}
+	if (time >= out_point) {
 		if (use_global_transition && last) {
 			if (!playout->next_after_transition && obs_source_active(playout->source)) {
 				playout->next_after_transition = true;
 				obs_frontend_preview_program_trigger_transition();
 			}
 		} else if (!last) {
-			playout_source_switch_to_next_item(playout);
+			playout->end_reason = "out_point";
+			if (!playout_source_sync_hold(playout)) {
+				playout_source_switch_at_end(playout, time - (duration - transition_duration - end));
+			}
 		}
 	}
 }
 
+static void playout_source_video_tick(void *data, float seconds)
+{
+	struct playout_source_context *playout = data;
+	uint64_t start = os_gettime_ns();
+	uint64_t trace_start = trace_begin();
+	profile_start(profile_tick_name);
+	playout_source_tick(data, seconds);
+	playout_source_publish_next_source(playout);
+	profile_end(profile_tick_name);
+	trace_end(profile_tick_name, trace_start);
+	metrics_histogram_add(&playout->metrics.tick_us, (long)((os_gettime_ns() - start) / 1000));
+}
+
 bool edit_transition_clicked(obs_properties_t *props, obs_property_t *property, void *data)
 {
 	UNUSED_PARAMETER(props);
@@ -569,21 +2825,87 @@ bool edit_transition_clicked(obs_properties_t *props, obs_property_t *property,
 	return false;
 }
 
+static bool playout_source_add_source_name(void *data, obs_source_t *source)
+{
+	obs_property_t *p = data;
+	const char *name = obs_source_get_name(source);
+	if (name && strlen(name) && strcmp(obs_source_get_unversioned_id(source), "playout_source") != 0)
+		obs_property_list_add_string(p, name, name);
+	return true;
+}
+
 void add_item_properties(struct playout_source_context *playout, obs_properties_t *props, struct dstr *setting_name, int i)
 {
 	obs_properties_t *item_group = obs_properties_create();
 	dstr_printf(setting_name, "section%d", i);
 	obs_properties_add_text(item_group, setting_name->array, obs_module_text("Section"), OBS_TEXT_DEFAULT);
+	dstr_printf(setting_name, "type%d", i);
+	obs_property_t *p = obs_properties_add_list(item_group, setting_name->array, obs_module_text("Type"), OBS_COMBO_TYPE_LIST,
+						    OBS_COMBO_FORMAT_INT);
+	obs_property_list_add_int(p, obs_module_text("Media"), PLAYOUT_ITEM_TYPE_MEDIA);
+	obs_property_list_add_int(p, obs_module_text("Image"), PLAYOUT_ITEM_TYPE_IMAGE);
+	obs_property_list_add_int(p, obs_module_text("Color"), PLAYOUT_ITEM_TYPE_COLOR);
+	obs_property_list_add_int(p, obs_module_text("Source"), PLAYOUT_ITEM_TYPE_SOURCE);
 	dstr_printf(setting_name, "path%d", i);
 	obs_properties_add_path(item_group, setting_name->array, obs_module_text("Path"), OBS_PATH_FILE, NULL, NULL);
+	dstr_printf(setting_name, "checksum%d", i);
+	obs_properties_add_text(item_group, setting_name->array, obs_module_text("Checksum"), OBS_TEXT_DEFAULT);
+	dstr_printf(setting_name, "proxy%d", i);
+	obs_properties_add_bool(item_group, setting_name->array, obs_module_text("UseProxy"));
+	dstr_printf(setting_name, "decode%d", i);
+	p = obs_properties_add_list(item_group, setting_name->array, obs_module_text("Decode"), OBS_COMBO_TYPE_LIST,
+				    OBS_COMBO_FORMAT_INT);
+	obs_property_list_add_int(p, obs_module_text("Default"), DECODE_DEFAULT);
+	obs_property_list_add_int(p, obs_module_text("DecodeHardware"), DECODE_HARDWARE);
+	obs_property_list_add_int(p, obs_module_text("DecodeSoftware"), DECODE_SOFTWARE);
+	dstr_printf(setting_name, "buffering_mb%d", i);
+	p = obs_properties_add_int(item_group, setting_name->array, obs_module_text("Buffering"), 0, 64, 1);
+	obs_property_int_set_suffix(p, " MB");
+	dstr_printf(setting_name, "audio_only%d", i);
+	p = obs_properties_add_bool(item_group, setting_name->array, obs_module_text("AudioOnly"));
+	obs_property_set_long_description(p, obs_module_text("AudioOnlyDescription"));
+	dstr_printf(setting_name, "still%d", i);
+	obs_properties_add_path(item_group, setting_name->array, obs_module_text("StillImage"), OBS_PATH_FILE, NULL, NULL);
+	int scan_status = playout && i < (int)playout->items.num ? playout->items.array[i].scan_status : INTEGRITY_SCAN_NONE;
+	if (scan_status >= INTEGRITY_SCAN_OK) {
+		char *reason = NULL;
+		struct playout_source_item *item = &playout->items.array[i];
+		integrity_scan_get(item->remote ? item->cached_path : item->path, &reason);
+		struct dstr text;
+		dstr_init(&text);
+		dstr_printf(&text, "%s: %s", obs_module_text("IntegrityStatus"), integrity_scan_status_name(scan_status));
+		if (reason)
+			dstr_catf(&text, " (%s)", reason);
+		dstr_printf(setting_name, "scan%d", i);
+		p = obs_properties_add_text(item_group, setting_name->array, text.array, OBS_TEXT_INFO);
+		obs_property_text_set_info_type(p, scan_status == INTEGRITY_SCAN_FAILED ? OBS_TEXT_INFO_ERROR
+						   : scan_status == INTEGRITY_SCAN_WARNING || scan_status == INTEGRITY_SCAN_UNKNOWN
+							   ? OBS_TEXT_INFO_WARNING
+							   : OBS_TEXT_INFO_NORMAL);
+		dstr_free(&text);
+		bfree(reason);
+	}
+	dstr_printf(setting_name, "source%d", i);
+	p = obs_properties_add_list(item_group, setting_name->array, obs_module_text("Source"), OBS_COMBO_TYPE_EDITABLE,
+				    OBS_COMBO_FORMAT_STRING);
+	obs_enum_sources(playout_source_add_source_name, p);
+	obs_enum_scenes(playout_source_add_source_name, p);
+	dstr_printf(setting_name, "until_end%d", i);
+	obs_properties_add_bool(item_group, setting_name->array, obs_module_text("UntilMediaEnded"));
+	dstr_printf(setting_name, "color%d", i);
+	obs_properties_add_color_alpha(item_group, setting_name->array, obs_module_text("Color"));
+	dstr_printf(setting_name, "duration%d", i);
+	p = obs_properties_add_float(item_group, setting_name->array, obs_module_text("Duration"), 0.1, 86400.0, 0.1);
+	obs_property_float_set_suffix(p, " s");
 	dstr_printf(setting_name, "start%d", i);
 
-	int64_t duration = playout && i < (int)playout->items.num && playout->items.array[i].source
+	int64_t duration = playout && i < (int)playout->items.num && playout->items.array[i].source &&
+					   playout->items.array[i].type == PLAYOUT_ITEM_TYPE_MEDIA
 				   ? obs_source_media_get_duration(playout->items.array[i].source)
 				   : 0;
 	if (!duration)
 		duration = 10000;
-	obs_property_t *p = obs_properties_add_float_slider(item_group, setting_name->array, obs_module_text("Start"), 0.0,
+	p = obs_properties_add_float_slider(item_group, setting_name->array, obs_module_text("Start"), 0.0,
 							    (double)duration / 1000.0, 0.01);
 	obs_property_float_set_suffix(p, " s");
 	dstr_printf(setting_name, "end%d", i);
@@ -611,6 +2933,15 @@ void add_item_properties(struct playout_source_context *playout, obs_properties_
 	p = obs_properties_add_int(item_group, setting_name->array, obs_module_text("TransitionDuration"), 50, 20000, 1000);
 	obs_property_int_set_suffix(p, " ms");
 
+	dstr_printf(setting_name, "hard_start%d", i);
+	p = obs_properties_add_text(item_group, setting_name->array, obs_module_text("HardStart"), OBS_TEXT_DEFAULT);
+	obs_property_set_long_description(p, obs_module_text("HardStartDescription"));
+
+	dstr_printf(setting_name, "events%d", i);
+	p = obs_properties_add_editable_list(item_group, setting_name->array, obs_module_text("Events"),
+					     OBS_EDITABLE_LIST_TYPE_STRINGS, NULL, NULL);
+	obs_property_set_long_description(p, obs_module_text("EventsDescription"));
+
 	dstr_printf(setting_name, "selected%d", i);
 	obs_properties_add_bool(item_group, setting_name->array, obs_module_text("Selected"));
 
@@ -656,6 +2987,17 @@ static void playout_source_switch_int(obs_data_t *settings, size_t i, size_t j,
 	obs_data_set_int(settings, setting_name->array, vj);
 }
 
+static void playout_source_switch_bool(obs_data_t *settings, size_t i, size_t j, struct dstr *setting_name, const char *format)
+{
+	dstr_printf(setting_name, format, i);
+	bool vi = obs_data_get_bool(settings, setting_name->array);
+	dstr_printf(setting_name, format, j);
+	bool vj = obs_data_get_bool(settings, setting_name->array);
+	obs_data_set_bool(settings, setting_name->array, vi);
+	dstr_printf(setting_name, format, i);
+	obs_data_set_bool(settings, setting_name->array, vj);
+}
+
 static void playout_source_switch_obj(obs_data_t *settings, size_t i, size_t j, struct dstr *setting_name, const char *format)
 {
 	dstr_printf(setting_name, format, i);
@@ -673,16 +3015,327 @@ static void playout_source_switch_obj(obs_data_t *settings, size_t i, size_t j,
 	obs_data_release(sj);
 }
 
+static void playout_source_switch_array(obs_data_t *settings, size_t i, size_t j, struct dstr *setting_name, const char *format)
+{
+	dstr_printf(setting_name, format, i);
+	obs_data_array_t *ai = obs_data_get_array(settings, setting_name->array);
+	if (!ai)
+		ai = obs_data_array_create();
+	dstr_printf(setting_name, format, j);
+	obs_data_array_t *aj = obs_data_get_array(settings, setting_name->array);
+	if (!aj)
+		aj = obs_data_array_create();
+	obs_data_set_array(settings, setting_name->array, ai);
+	dstr_printf(setting_name, format, i);
+	obs_data_set_array(settings, setting_name->array, aj);
+	obs_data_array_release(ai);
+	obs_data_array_release(aj);
+}
+
 static void playout_source_switch_item_settings(obs_data_t *settings, size_t i, size_t j, struct dstr *setting_name)
 {
+	playout_source_switch_int(settings, i, j, setting_name, "id%d");
 	playout_source_switch_text(settings, i, j, setting_name, "section%d");
+	playout_source_switch_int(settings, i, j, setting_name, "type%d");
 	playout_source_switch_text(settings, i, j, setting_name, "path%d");
+	playout_source_switch_text(settings, i, j, setting_name, "checksum%d");
+	playout_source_switch_bool(settings, i, j, setting_name, "proxy%d");
+	playout_source_switch_int(settings, i, j, setting_name, "color%d");
+	playout_source_switch_float(settings, i, j, setting_name, "duration%d");
+	playout_source_switch_text(settings, i, j, setting_name, "source%d");
+	playout_source_switch_bool(settings, i, j, setting_name, "until_end%d");
 	playout_source_switch_float(settings, i, j, setting_name, "start%d");
 	playout_source_switch_float(settings, i, j, setting_name, "end%d");
 	playout_source_switch_int(settings, i, j, setting_name, "speed_percent%d");
 	playout_source_switch_text(settings, i, j, setting_name, "transition%d");
 	playout_source_switch_obj(settings, i, j, setting_name, "transition_settings%d");
 	playout_source_switch_int(settings, i, j, setting_name, "transition_duration%d");
+	playout_source_switch_int(settings, i, j, setting_name, "decode%d");
+	playout_source_switch_int(settings, i, j, setting_name, "buffering_mb%d");
+	playout_source_switch_bool(settings, i, j, setting_name, "audio_only%d");
+	playout_source_switch_text(settings, i, j, setting_name, "still%d");
+	playout_source_switch_text(settings, i, j, setting_name, "hard_start%d");
+	playout_source_switch_bool(settings, i, j, setting_name, "filler%d");
+	playout_source_switch_array(settings, i, j, setting_name, "events%d");
+}
+
+static const char *item_setting_formats[] = {"id%d",     "section%d", "type%d",          "path%d",       "checksum%d",
+					     "proxy%d",  "color%d",   "duration%d",      "source%d",     "until_end%d",
+					     "start%d",  "end%d",     "speed_percent%d", "transition%d", "transition_settings%d",
+					     "transition_duration%d", "decode%d", "buffering_mb%d", "audio_only%d",
+					     "still%d", "hard_start%d", "filler%d", "events%d"};
+
+static void playout_source_clear_item_settings(obs_data_t *settings, int i, struct dstr *setting_name)
+{
+	for (size_t f = 0; f < sizeof(item_setting_formats) / sizeof(item_setting_formats[0]); f++) {
+		dstr_printf(setting_name, item_setting_formats[f], i);
+		obs_data_unset_user_value(settings, setting_name->array);
+	}
+}
+
+static void playout_source_set_item_settings(obs_data_t *settings, int i, obs_data_t *item, struct dstr *setting_name)
+{
+	for (obs_data_item_t *di = obs_data_first(item); di; obs_data_item_next(&di)) {
+		dstr_printf(setting_name, "%s%d", obs_data_item_get_name(di), i);
+		enum obs_data_type type = obs_data_item_gettype(di);
+		if (type == OBS_DATA_STRING) {
+			obs_data_set_string(settings, setting_name->array, obs_data_item_get_string(di));
+		} else if (type == OBS_DATA_NUMBER) {
+			if (obs_data_item_numtype(di) == OBS_DATA_NUM_INT)
+				obs_data_set_int(settings, setting_name->array, obs_data_item_get_int(di));
+			else
+				obs_data_set_double(settings, setting_name->array, obs_data_item_get_double(di));
+		} else if (type == OBS_DATA_BOOLEAN) {
+			obs_data_set_bool(settings, setting_name->array, obs_data_item_get_bool(di));
+		} else if (type == OBS_DATA_OBJECT) {
+			obs_data_t *obj = obs_data_item_get_obj(di);
+			obs_data_set_obj(settings, setting_name->array, obj);
+			obs_data_release(obj);
+		} else if (type == OBS_DATA_ARRAY) {
+			obs_data_array_t *array = obs_data_item_get_array(di);
+			obs_data_set_array(settings, setting_name->array, array);
+			obs_data_array_release(array);
+		}
+	}
+}
+
+static void playout_source_swap_index(int *index, int a, int b)
+{
+	if (*index == a)
+		*index = b;
+	else if (*index == b)
+		*index = a;
+}
+
+static void playout_source_move_item(struct playout_source_context *playout, obs_data_t *settings, int from, int to,
+				     struct dstr *setting_name)
+{
+	while (from != to) {
+		int next = from < to ? from + 1 : from - 1;
+		playout_source_switch_item_settings(settings, from, next, setting_name);
+		struct playout_source_item tmp = playout->items.array[from];
+		playout->items.array[from] = playout->items.array[next];
+		playout->items.array[next] = tmp;
+		playout_source_swap_index(&playout->current_index, from, next);
+		playout_source_swap_index(&playout->current_source_index, from, next);
+		playout_source_swap_index(&playout->loop_index, from, next);
+		from = next;
+	}
+}
+
+static bool playout_source_edit_valid_item(obs_data_t *item)
+{
+	if (!item)
+		return false;
+	if (obs_data_get_int(item, "type") == PLAYOUT_ITEM_TYPE_COLOR)
+		return true;
+	const char *key = obs_data_get_int(item, "type") == PLAYOUT_ITEM_TYPE_SOURCE ? "source" : "path";
+	return strlen(obs_data_get_string(item, key)) > 0;
+}
+
+/* returns the id of an item that has to be loaded again from the settings, or 0 */
+static long playout_source_apply_edit(struct playout_source_context *playout, obs_data_t *settings, obs_data_t *edit,
+				      struct dstr *setting_name, bool *removed_on_air)
+{
+	const char *op = obs_data_get_string(edit, "op");
+	long id = (long)obs_data_get_int(edit, "id");
+	int count = (int)playout->items.num;
+	int index = strcmp(op, "insert") == 0 ? count : playout_source_find_id(playout, id);
+	if (index < 0 || !id)
+		return 0;
+	int to = obs_data_has_user_value(edit, "index") ? (int)obs_data_get_int(edit, "index") : count;
+
+	if (strcmp(op, "insert") == 0) {
+		obs_data_t *item = obs_data_get_obj(edit, "item");
+		playout_source_clear_item_settings(settings, index, setting_name);
+		playout_source_set_item_settings(settings, index, item, setting_name);
+		dstr_printf(setting_name, "id%d", index);
+		obs_data_set_int(settings, setting_name->array, id);
+		obs_data_release(item);
+		struct playout_source_item *added = da_push_back_new(playout->items);
+		added->id = id;
+		playout_source_move_item(playout, settings, index, to < 0 ? 0 : (to > count ? count : to), setting_name);
+		return id;
+	} else if (strcmp(op, "remove") == 0) {
+		if (playout->loop_index == index)
+			playout_source_loop_release(playout);
+		if (playout->current_index == index)
+			playout->current_index = index - 1;
+		else if (playout->current_index > index)
+			playout->current_index--;
+		if (playout->current_source_index == index) {
+			playout->current_source_index = -1;
+			*removed_on_air = true;
+		} else if (playout->current_source_index > index)
+			playout->current_source_index--;
+		int current_index = playout->current_index;
+		int current_source_index = playout->current_source_index;
+		playout_source_move_item(playout, settings, index, count - 1, setting_name);
+		playout->current_index = current_index;
+		playout->current_source_index = current_source_index;
+		playout_source_item_free(playout, &playout->items.array[count - 1]);
+		da_erase(playout->items, count - 1);
+		playout_source_clear_item_settings(settings, count - 1, setting_name);
+	} else if (strcmp(op, "move") == 0) {
+		playout_source_move_item(playout, settings, index, to < 0 ? 0 : (to >= count ? count - 1 : to), setting_name);
+	} else if (strcmp(op, "replace") == 0) {
+		obs_data_t *item = obs_data_get_obj(edit, "item");
+		playout_source_clear_item_settings(settings, index, setting_name);
+		playout_source_set_item_settings(settings, index, item, setting_name);
+		dstr_printf(setting_name, "id%d", index);
+		obs_data_set_int(settings, setting_name->array, id);
+		obs_data_release(item);
+		return id;
+	} else if (strcmp(op, "cue") == 0) {
+		playout->cue_id = id;
+	}
+	return 0;
+}
+
+/* The item on air was removed. The item after it goes on air as if the removed
+ * one had ended, when nothing follows the orphaned decoder is stopped. */
+static void playout_source_removed_on_air(struct playout_source_context *playout)
+{
+	blog(LOG_INFO, "[Playout Source] '%s' the item on air was removed", obs_source_get_name(playout->source));
+	playout->end_reason = "removed";
+	if (playout->playback_mode != PLAYBACK_MODE_SINGLE)
+		playout_source_switch_to_next_item(playout);
+	if (playout->current_source_index >= 0 || !playout->current_source)
+		return;
+	if (playout->as_run_entry) {
+		playout->as_run_entry->end_ms = as_run_now_ms();
+		playout->as_run_entry->out_ms = playout->as_run_out_ms;
+		playout->as_run_entry->ended = playout->end_reason;
+		as_run_push(playout->as_run_entry);
+		playout->as_run_entry = NULL;
+	}
+	playout->end_reason = NULL;
+	obs_source_media_play_pause(playout->current_source, true);
+	playout_source_clear_current(playout);
+}
+
+/* Edits queued by edit_items are applied together at the start of a tick and
+ * keep the item array in step with the settings, so only the items that were
+ * inserted or replaced are loaded again instead of running the whole update. */
+static void playout_source_apply_edits(struct playout_source_context *playout)
+{
+	if (!os_atomic_load_bool(&playout->edits_pending))
+		return;
+	pthread_mutex_lock(&playout->edits_mutex);
+	DARRAY(obs_data_t *) edits;
+	da_init(edits);
+	da_move(edits, playout->edits);
+	os_atomic_set_bool(&playout->edits_pending, false);
+	pthread_mutex_unlock(&playout->edits_mutex);
+
+	obs_data_t *settings = obs_source_get_settings(playout->source);
+	struct dstr setting_name;
+	dstr_init(&setting_name);
+	DARRAY(long) loaded;
+	da_init(loaded);
+	bool removed_on_air = false;
+	for (size_t i = 0; i < edits.num; i++) {
+		obs_data_array_t *batch = obs_data_get_array(edits.array[i], "edits");
+		size_t count = obs_data_array_count(batch);
+		for (size_t j = 0; j < count; j++) {
+			obs_data_t *edit = obs_data_array_item(batch, j);
+			long id = playout_source_apply_edit(playout, settings, edit, &setting_name, &removed_on_air);
+			if (id && da_find(loaded, &id, 0) == DARRAY_INVALID)
+				da_push_back(loaded, &id);
+			obs_data_release(edit);
+		}
+		obs_data_array_release(batch);
+		obs_data_release(edits.array[i]);
+	}
+	da_free(edits);
+
+	bool deferred = false;
+	for (size_t i = 0; i < loaded.num; i++) {
+		int index = playout_source_find_id(playout, loaded.array[i]);
+		if (index >= 0)
+			playout_source_item_load(playout, settings, index, &setting_name, &deferred);
+	}
+	da_free(loaded);
+	dstr_free(&setting_name);
+	if (removed_on_air)
+		playout_source_removed_on_air(playout);
+	if (deferred)
+		playout_source_defer_items(playout);
+	playout_source_shuffle_update(playout, settings);
+	playout_source_stats_plan(playout);
+	obs_data_release(settings);
+	obs_source_update_properties(playout->source);
+}
+
+static void playout_source_edit_items(void *data, calldata_t *cd)
+{
+	struct playout_source_context *playout = data;
+	obs_data_t *request = obs_data_create_from_json(calldata_string(cd, "json"));
+	if (!request) {
+		calldata_set_string(cd, "result", "{\"error\":\"invalid json\"}");
+		return;
+	}
+	struct dstr result;
+	dstr_init_copy(&result, "{\"ids\":[");
+	obs_data_array_t *batch = obs_data_get_array(request, "edits");
+	size_t count = obs_data_array_count(batch);
+	for (size_t i = 0; i < count; i++) {
+		obs_data_t *edit = obs_data_array_item(batch, i);
+		if (strcmp(obs_data_get_string(edit, "op"), "insert") == 0) {
+			obs_data_t *item = obs_data_get_obj(edit, "item");
+			obs_data_set_int(edit, "id", playout_source_edit_valid_item(item) ? os_atomic_inc_long(&playout->next_id) : 0);
+			obs_data_release(item);
+		} else if (strcmp(obs_data_get_string(edit, "op"), "replace") == 0) {
+			obs_data_t *item = obs_data_get_obj(edit, "item");
+			if (!playout_source_edit_valid_item(item))
+				obs_data_set_int(edit, "id", 0);
+			obs_data_release(item);
+		}
+		dstr_catf(&result, i ? ",%lld" : "%lld", obs_data_get_int(edit, "id"));
+		obs_data_release(edit);
+	}
+	obs_data_array_release(batch);
+	dstr_cat(&result, "]}");
+
+	playout_source_queue_edits(playout, request);
+
+	calldata_set_string(cd, "result", result.array);
+	dstr_free(&result);
+}
+
+/* rows get their id when they are added, so they can be removed by id like
+ * items edited through edit_items */
+static void playout_source_add_row_id(struct playout_source_context *playout, obs_data_t *settings, int i,
+				      struct dstr *setting_name)
+{
+	long id = os_atomic_inc_long(&playout->next_id);
+	dstr_printf(setting_name, "id%d", i);
+	obs_data_set_int(settings, setting_name->array, id);
+	playout->items.array[i].id = id;
+}
+
+/* removed rows go through the edit queue, which frees the items on the
+ * graphics thread and clears all of their settings */
+static void playout_source_queue_remove(struct playout_source_context *playout, obs_data_t *settings, bool selected_only,
+					struct dstr *setting_name)
+{
+	obs_data_t *request = obs_data_create();
+	obs_data_array_t *batch = obs_data_array_create();
+	for (int i = 0; i < (int)playout->items.num; i++) {
+		dstr_printf(setting_name, "selected%d", i);
+		if (selected_only && !obs_data_get_bool(settings, setting_name->array))
+			continue;
+		obs_data_unset_user_value(settings, setting_name->array);
+		dstr_printf(setting_name, "id%d", i);
+		obs_data_t *edit = obs_data_create();
+		obs_data_set_string(edit, "op", "remove");
+		obs_data_set_int(edit, "id", obs_data_get_int(settings, setting_name->array));
+		obs_data_array_push_back(batch, edit);
+		obs_data_release(edit);
+	}
+	obs_data_set_array(request, "edits", batch);
+	obs_data_array_release(batch);
+	playout_source_queue_edits(playout, request);
 }
 
 static bool playout_source_action_changed(obs_properties_t *props, obs_property_t *property, obs_data_t *settings)
@@ -724,6 +3377,7 @@ static bool playout_source_action(obs_properties_t *props, obs_property_t *prope
 		return false;
 	struct dstr setting_name;
 	dstr_init(&setting_name);
+	profile_start(profile_action_name);
 	long long action = obs_data_get_int(settings, "action");
 	if (action == PLAYOUT_ACTION_ADD_ITEM_TOP) {
 		dstr_printf(&setting_name, "speed_percent%d", (int)playout->items.num);
@@ -735,55 +3389,19 @@ static bool playout_source_action(obs_properties_t *props, obs_property_t *prope
 		add_item_properties(playout, props, &setting_name, (int)playout->items.num);
 		obs_properties_add_text(props, "plugin_info", PLUGIN_INFO, OBS_TEXT_INFO);
 		da_insert_new(playout->items, 0);
+		playout_source_add_row_id(playout, settings, 0, &setting_name);
 	} else if (action == PLAYOUT_ACTION_ADD_ITEM_BOTTOM) {
 		dstr_printf(&setting_name, "speed_percent%d", (int)playout->items.num);
 		obs_data_set_default_int(settings, setting_name.array, 100);
 		obs_properties_remove_by_name(props, "plugin_info");
 		add_item_properties(playout, props, &setting_name, (int)playout->items.num);
 		obs_properties_add_text(props, "plugin_info", PLUGIN_INFO, OBS_TEXT_INFO);
-		dstr_free(&setting_name);
 		da_push_back_new(playout->items);
+		playout_source_add_row_id(playout, settings, (int)playout->items.num - 1, &setting_name);
 	} else if (action == PLAYOUT_ACTION_REMOVE_SELECTED) {
-		int selected = 0;
-		for (int i = 0; i < (int)playout->items.num; i++) {
-			dstr_printf(&setting_name, "selected%d", i);
-			if (obs_data_get_bool(settings, setting_name.array)) {
-				selected++;
-			} else if (selected) {
-				playout_source_switch_item_settings(settings, i, i - selected, &setting_name);
-			}
-		}
-		for (int i = (int)playout->items.num - selected; i < (int)playout->items.num; i++) {
-			dstr_printf(&setting_name, "path%d", i);
-			obs_data_unset_user_value(settings, setting_name.array);
-			dstr_printf(&setting_name, "transition%d", i);
-			obs_data_unset_user_value(settings, setting_name.array);
-			dstr_printf(&setting_name, "item%d", i);
-			obs_properties_remove_by_name(props, setting_name.array);
-		}
-		selected = 0;
-		for (int i = 0; i < (int)playout->items.num; i++) {
-			dstr_printf(&setting_name, "selected%d", i);
-			if (obs_data_get_bool(settings, setting_name.array)) {
-				obs_data_unset_user_value(settings, setting_name.array);
-				obs_source_release(playout->items.array[i - selected].source);
-				obs_source_release(playout->items.array[i - selected].transition);
-				da_erase(playout->items, i - selected);
-				selected++;
-			}
-		}
+		playout_source_queue_remove(playout, settings, true, &setting_name);
 	} else if (action == PLAYOUT_ACTION_REMOVE_ALL) {
-		for (int i = 0; i < (int)playout->items.num; i++) {
-			dstr_printf(&setting_name, "item%d", i);
-			obs_properties_remove_by_name(props, setting_name.array);
-			dstr_printf(&setting_name, "path%d", i);
-			obs_data_unset_user_value(settings, setting_name.array);
-			dstr_printf(&setting_name, "transition%d", i);
-			obs_data_unset_user_value(settings, setting_name.array);
-			obs_source_release(playout->items.array[i].source);
-			obs_source_release(playout->items.array[i].transition);
-		}
-		playout->items.num = 0;
+		playout_source_queue_remove(playout, settings, false, &setting_name);
 	} else if (action == PLAYOUT_ACTION_MOVE_SELECTED_UP) {
 		for (int i = 1; i < (int)playout->items.num; i++) {
 			dstr_printf(&setting_name, "selected%d", i);
@@ -817,6 +3435,7 @@ static bool playout_source_action(obs_properties_t *props, obs_property_t *prope
 			dstr_free(&dir_path);
 			add_item_properties(playout, props, &setting_name, (int)playout->items.num);
 			da_push_back_new(playout->items);
+			playout_source_add_row_id(playout, settings, (int)playout->items.num - 1, &setting_name);
 		}
 		obs_properties_add_text(props, "plugin_info", PLUGIN_INFO, OBS_TEXT_INFO);
 	} else if (action == PLAYOUT_ACTION_TRANSITION_SELECTED) {
@@ -862,15 +3481,50 @@ static bool playout_source_action(obs_properties_t *props, obs_property_t *prope
 		}
 	}
 	dstr_free(&setting_name);
+	profile_end(profile_action_name);
 	obs_data_unset_user_value(settings, "action");
 	playout_source_action_changed(props, property, settings);
 	obs_data_release(settings);
 	return true;
 }
 
+static bool playout_source_trace_clicked(obs_properties_t *props, obs_property_t *property, void *data)
+{
+	UNUSED_PARAMETER(props);
+	UNUSED_PARAMETER(property);
+	UNUSED_PARAMETER(data);
+	char *path = trace_dump();
+	bfree(path);
+	return false;
+}
+
+static bool playout_source_scan_clicked(obs_properties_t *props, obs_property_t *property, void *data)
+{
+	UNUSED_PARAMETER(props);
+	UNUSED_PARAMETER(property);
+	struct playout_source_context *playout = data;
+	for (size_t i = 0; i < playout->items.num; i++) {
+		if (playout->items.array[i].type == PLAYOUT_ITEM_TYPE_MEDIA)
+			playout_source_item_scan(playout, &playout->items.array[i], true);
+	}
+	return false;
+}
+
+/* options of the shared workers are kept in the module config, not in the source */
+static void playout_source_module_option(obs_property_t *p)
+{
+	obs_property_set_modified_callback(p, module_config_modified);
+	obs_property_set_long_description(p, obs_module_text("ModuleOptionDescription"));
+}
+
 static obs_properties_t *playout_source_properties(void *data)
 {
 	struct playout_source_context *playout = data;
+	if (playout) {
+		obs_data_t *settings = obs_source_get_settings(playout->source);
+		module_config_to_settings(settings);
+		obs_data_release(settings);
+	}
 	obs_properties_t *props = obs_properties_create();
 	obs_properties_add_bool(props, "autoplay", obs_module_text("Autoplay"));
 	obs_property_t *p = obs_properties_add_list(props, "playback_mode", obs_module_text("PlaybackMode"), OBS_COMBO_TYPE_LIST,
@@ -878,7 +3532,38 @@ static obs_properties_t *playout_source_properties(void *data)
 	obs_property_list_add_int(p, obs_module_text("Single"), PLAYBACK_MODE_SINGLE);
 	obs_property_list_add_int(p, obs_module_text("Section"), PLAYBACK_MODE_SECTION);
 	obs_property_list_add_int(p, obs_module_text("List"), PLAYBACK_MODE_LIST);
+	obs_property_list_add_int(p, obs_module_text("ShuffleSection"), PLAYBACK_MODE_SHUFFLE_SECTION);
+	obs_property_list_add_int(p, obs_module_text("Shuffle"), PLAYBACK_MODE_SHUFFLE);
 	obs_properties_add_bool(props, "loop", obs_module_text("Loop"));
+	obs_properties_add_bool(props, "shuffle_no_repeat", obs_module_text("ShuffleNoRepeat"));
+	obs_properties_add_bool(props, "seamless_loop", obs_module_text("SeamlessLoop"));
+	obs_properties_add_bool(props, "share_decoders", obs_module_text("ShareDecoders"));
+	obs_properties_add_bool(props, "hw_decode", obs_module_text("HardwareDecode"));
+	p = obs_properties_add_int(props, "buffering_mb", obs_module_text("Buffering"), 1, 64, 1);
+	obs_property_int_set_suffix(p, " MB");
+	obs_properties_add_bool(props, "fixed_size", obs_module_text("FixedSize"));
+	obs_properties_add_int(props, "width", obs_module_text("Width"), 1, 16384, 1);
+	obs_properties_add_int(props, "height", obs_module_text("Height"), 1, 16384, 1);
+	p = obs_properties_add_list(props, "scale_mode", obs_module_text("ScaleMode"), OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+	obs_property_list_add_int(p, obs_module_text("ScaleFit"), SCALE_MODE_FIT);
+	obs_property_list_add_int(p, obs_module_text("ScaleFill"), SCALE_MODE_FILL);
+	obs_property_list_add_int(p, obs_module_text("ScaleStretch"), SCALE_MODE_STRETCH);
+	obs_properties_add_path(props, "filler_path", obs_module_text("FillerPath"), OBS_PATH_FILE, NULL, NULL);
+	p = obs_properties_add_editable_list(props, "filler_pool", obs_module_text("FillerPool"), OBS_EDITABLE_LIST_TYPE_FILES,
+					     NULL, NULL);
+	obs_property_set_long_description(p, obs_module_text("FillerPoolDescription"));
+	p = obs_properties_add_int(props, "filler_lead", obs_module_text("FillerLead"), 10, 3600, 10);
+	obs_property_int_set_suffix(p, " s");
+	p = obs_properties_add_int(props, "prefetch_minutes", obs_module_text("PrefetchWindow"), 1, 1440, 1);
+	obs_property_int_set_suffix(p, " min");
+	p = obs_properties_add_int(props, "cache_size_mb", obs_module_text("CacheSize"), 100, 1048576, 100);
+	obs_property_int_set_suffix(p, " MB");
+	playout_source_module_option(p);
+	obs_properties_add_bool(props, "proxy_trimmed", obs_module_text("ProxyTrimmed"));
+	p = obs_properties_add_path(props, "ffmpeg_path", obs_module_text("FFmpegPath"), OBS_PATH_FILE, NULL, NULL);
+	playout_source_module_option(p);
+	p = obs_properties_add_int_slider(props, "proxy_threads", obs_module_text("ProxyThreads"), 1, 16, 1);
+	playout_source_module_option(p);
 
 	p = obs_properties_add_list(props, "action", obs_module_text("Action"), OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
 	obs_property_list_add_int(p, obs_module_text("None"), PLAYOUT_ACTION_NONE);
@@ -912,6 +3597,37 @@ static obs_properties_t *playout_source_properties(void *data)
 
 	obs_properties_add_button2(props, "action_go", obs_module_text("ExecuteAction"), playout_source_action, data);
 
+	p = obs_properties_add_float(props, "status_rate", obs_module_text("StatusRate"), 0.0, 60.0, 0.5);
+	obs_property_float_set_suffix(p, " Hz");
+	obs_properties_add_text(props, "sync_group", obs_module_text("SyncGroup"), OBS_TEXT_DEFAULT);
+	obs_properties_add_bool(props, "sync_master", obs_module_text("SyncMaster"));
+	obs_properties_add_bool(props, "scan", obs_module_text("IntegrityScan"));
+	p = obs_properties_add_bool(props, "scan_decode", obs_module_text("IntegrityScanDecode"));
+	playout_source_module_option(p);
+	p = obs_properties_add_int(props, "scan_threads", obs_module_text("IntegrityScanThreads"), 1, 4, 1);
+	playout_source_module_option(p);
+	p = obs_properties_add_float(props, "scan_rate", obs_module_text("IntegrityScanRate"), 0.0, 100.0, 0.5);
+	obs_property_float_set_suffix(p, "x");
+	playout_source_module_option(p);
+	obs_properties_add_bool(props, "skip_failed", obs_module_text("SkipFailed"));
+	obs_properties_add_button2(props, "scan_now", obs_module_text("IntegrityScanNow"), playout_source_scan_clicked, data);
+	obs_properties_add_bool(props, "as_run", obs_module_text("AsRun"));
+	obs_properties_add_path(props, "as_run_dir", obs_module_text("AsRunDirectory"), OBS_PATH_DIRECTORY, NULL, NULL);
+	p = obs_properties_add_list(props, "as_run_format", obs_module_text("AsRunFormat"), OBS_COMBO_TYPE_LIST,
+				    OBS_COMBO_FORMAT_INT);
+	obs_property_list_add_int(p, "JSONL", 0);
+	obs_property_list_add_int(p, "CSV", 1);
+	p = obs_properties_add_list(props, "resume_mode", obs_module_text("ResumeMode"), OBS_COMBO_TYPE_LIST,
+				    OBS_COMBO_FORMAT_INT);
+	obs_property_list_add_int(p, obs_module_text("ResumeOff"), RESUME_MODE_OFF);
+	obs_property_list_add_int(p, obs_module_text("ResumePosition"), RESUME_MODE_POSITION);
+	obs_property_list_add_int(p, obs_module_text("ResumeSchedule"), RESUME_MODE_SCHEDULE);
+	p = obs_properties_add_int(props, "journal_interval", obs_module_text("JournalInterval"), 0, 3600, 1);
+	obs_property_int_set_suffix(p, " s");
+	p = obs_properties_add_bool(props, "trace", obs_module_text("Trace"));
+	playout_source_module_option(p);
+	obs_properties_add_button2(props, "trace_dump", obs_module_text("DumpTrace"), playout_source_trace_clicked, data);
+
 	if (playout) {
 		struct dstr setting_name;
 		dstr_init(&setting_name);
@@ -926,12 +3642,36 @@ static obs_properties_t *playout_source_properties(void *data)
 
 void playout_source_defaults(obs_data_t *settings)
 {
-	UNUSED_PARAMETER(settings);
+	obs_data_set_default_bool(settings, "share_decoders", false);
+	obs_data_set_default_bool(settings, "hw_decode", true);
+	obs_data_set_default_int(settings, "buffering_mb", 2);
+	obs_data_set_default_double(settings, "status_rate", 2.0);
+	obs_data_set_default_int(settings, "journal_interval", 5);
+	obs_data_set_default_bool(settings, "shuffle_no_repeat", true);
+	obs_data_set_default_int(settings, "scan_threads", 1);
+	obs_data_set_default_double(settings, "scan_rate", 4.0);
+	obs_data_set_default_bool(settings, "skip_failed", true);
+	obs_data_set_default_int(settings, "prefetch_minutes", 60);
+	obs_data_set_default_int(settings, "filler_lead", 60);
+	obs_data_set_default_int(settings, "cache_size_mb", 10240);
+	obs_data_set_default_string(settings, "ffmpeg_path", "ffmpeg");
+	obs_data_set_default_int(settings, "proxy_threads", 2);
+	struct obs_video_info ovi;
+	if (!obs_get_video_info(&ovi)) {
+		ovi.base_width = 1920;
+		ovi.base_height = 1080;
+	}
+	obs_data_set_default_int(settings, "width", ovi.base_width);
+	obs_data_set_default_int(settings, "height", ovi.base_height);
 }
 
 uint32_t playout_source_get_width(void *data)
 {
 	struct playout_source_context *playout = data;
+	if (playout->fixed_size)
+		return playout->fixed_width;
+	if (playout->audio_only)
+		return playout->still ? obs_source_get_width(playout->still) : playout->render_width;
 	if (playout->current_transition)
 		return obs_source_get_width(playout->current_transition);
 	if (playout->current_source)
@@ -942,6 +3682,10 @@ uint32_t playout_source_get_width(void *data)
 uint32_t playout_source_get_height(void *data)
 {
 	struct playout_source_context *playout = data;
+	if (playout->fixed_size)
+		return playout->fixed_height;
+	if (playout->audio_only)
+		return playout->still ? obs_source_get_height(playout->still) : playout->render_height;
 	if (playout->current_transition)
 		return obs_source_get_height(playout->current_transition);
 	if (playout->current_source)
@@ -949,14 +3693,86 @@ uint32_t playout_source_get_height(void *data)
 	return 0;
 }
 
+static void playout_source_render_texture(struct playout_source_context *playout, obs_source_t *child, uint32_t width,
+					  uint32_t height)
+{
+	if (playout->rendered || !width || !height)
+		return;
+	if (!playout->render)
+		playout->render = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+	playout->rendered = true;
+	gs_texrender_reset(playout->render);
+	if (!gs_texrender_begin(playout->render, width, height))
+		return;
+	playout->render_width = width;
+	playout->render_height = height;
+	struct vec4 clear;
+	vec4_zero(&clear);
+	gs_clear(GS_CLEAR_COLOR, &clear, 0.0f, 0);
+	uint32_t cx = obs_source_get_width(child);
+	uint32_t cy = obs_source_get_height(child);
+	if (cx && cy) {
+		float sx = (float)width / (float)cx;
+		float sy = (float)height / (float)cy;
+		if (playout->scale_mode == SCALE_MODE_FIT) {
+			sx = sy = sx < sy ? sx : sy;
+		} else if (playout->scale_mode == SCALE_MODE_FILL) {
+			sx = sy = sx > sy ? sx : sy;
+		}
+		gs_ortho(0.0f, (float)width, 0.0f, (float)height, -100.0f, 100.0f);
+		gs_matrix_push();
+		gs_matrix_translate3f(((float)width - (float)cx * sx) / 2.0f, ((float)height - (float)cy * sy) / 2.0f, 0.0f);
+		gs_matrix_scale3f(sx, sy, 1.0f);
+		gs_blend_state_push();
+		gs_blend_function(GS_BLEND_ONE, GS_BLEND_INVSRCALPHA);
+		obs_source_video_render(child);
+		gs_blend_state_pop();
+		gs_matrix_pop();
+	}
+	gs_texrender_end(playout->render);
+}
+
+static void playout_source_draw_texture(struct playout_source_context *playout)
+{
+	gs_texture_t *tex = playout->render ? gs_texrender_get_texture(playout->render) : NULL;
+	if (!tex)
+		return;
+	gs_effect_t *effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
+	gs_effect_set_texture(gs_effect_get_param_by_name(effect, "image"), tex);
+	/* the texrender holds premultiplied alpha */
+	gs_blend_state_push();
+	gs_blend_function(GS_BLEND_ONE, GS_BLEND_INVSRCALPHA);
+	while (gs_effect_loop(effect, "Draw"))
+		gs_draw_sprite(tex, 0, playout->render_width, playout->render_height);
+	gs_blend_state_pop();
+}
+
+/* While an audio-only item is on air the still image is shown, or without one
+ * the last frame captured in the texrender is held. The capture only runs when
+ * an audio-only item without a still is on air or next. */
 static void playout_source_video_render(void *data, gs_effect_t *effect)
 {
 	UNUSED_PARAMETER(effect);
 	struct playout_source_context *playout = data;
-	if (playout->current_transition)
-		obs_source_video_render(playout->current_transition);
-	else if (playout->current_source)
-		obs_source_video_render(playout->current_source);
+	obs_source_t *child = playout->current_transition ? playout->current_transition : playout->current_source;
+	if (playout->audio_only) {
+		child = playout->still;
+		if (!child) {
+			playout_source_draw_texture(playout);
+			return;
+		}
+	}
+	if (!child)
+		return;
+	if (playout->fixed_size) {
+		playout_source_render_texture(playout, child, playout->fixed_width, playout->fixed_height);
+		playout_source_draw_texture(playout);
+	} else if (playout->hold_frames && !playout->audio_only) {
+		playout_source_render_texture(playout, child, obs_source_get_width(child), obs_source_get_height(child));
+		playout_source_draw_texture(playout);
+	} else {
+		obs_source_video_render(child);
+	}
 }
 
 int64_t playout_source_get_duration(void *data)
@@ -965,10 +3781,12 @@ int64_t playout_source_get_duration(void *data)
 
 	if (!playout->current_source)
 		return 0;
-	int64_t duration = obs_source_media_get_duration(playout->current_source);
+	struct playout_source_item *item = playout_source_current_item(playout);
+	int64_t duration = playout_source_item_timed(item) ? (int64_t)item->duration
+							   : obs_source_media_get_duration(playout->current_source);
 	if (duration <= 0)
 		return 0;
-	if (playout->current_index >= 0 && playout->current_index < (int)playout->items.num) {
+	if (!playout_source_item_timed(item) && playout->current_index >= 0 && playout->current_index < (int)playout->items.num) {
 		duration -= playout->items.array[playout->current_index].start;
 		duration -= playout->items.array[playout->current_index].end;
 	}
@@ -988,6 +3806,9 @@ int64_t playout_source_get_time(void *data)
 	struct playout_source_context *playout = data;
 	if (!playout->current_source)
 		return 0;
+	struct playout_source_item *item = playout_source_current_item(playout);
+	if (playout_source_item_timed(item))
+		return (int64_t)(item->elapsed_ns / 1000000);
 	int64_t time = obs_source_media_get_time(playout->current_source);
 	if (playout->current_index >= 0 && playout->current_index < (int)playout->items.num)
 		time -= playout->items.array[playout->current_index].start;
@@ -997,6 +3818,12 @@ int64_t playout_source_get_time(void *data)
 enum obs_media_state playout_source_get_state(void *data)
 {
 	struct playout_source_context *playout = data;
+	struct playout_source_item *item = playout_source_current_item(playout);
+	if (playout_source_item_timed(item)) {
+		if (item->elapsed_ns / 1000000 >= item->duration)
+			return OBS_MEDIA_STATE_ENDED;
+		return playout->playing ? OBS_MEDIA_STATE_PLAYING : OBS_MEDIA_STATE_PAUSED;
+	}
 	if (playout->current_source)
 		return obs_source_media_get_state(playout->current_source);
 	return OBS_MEDIA_STATE_NONE;
@@ -1007,6 +3834,11 @@ void playout_source_set_time(void *data, int64_t miliseconds)
 	struct playout_source_context *playout = data;
 	if (!playout->current_source)
 		return;
+	struct playout_source_item *item = playout_source_current_item(playout);
+	if (playout_source_item_timed(item)) {
+		item->elapsed_ns = miliseconds > 0 ? (uint64_t)miliseconds * 1000000 : 0;
+		return;
+	}
 	if (playout->current_index >= 0 && playout->current_index < (int)playout->items.num)
 		miliseconds += playout->items.array[playout->current_index].start;
 	obs_source_media_set_time(playout->current_source, miliseconds);
@@ -1015,7 +3847,10 @@ void playout_source_set_time(void *data, int64_t miliseconds)
 void playout_source_stop(void *data)
 {
 	struct playout_source_context *playout = data;
-	if (playout->current_source)
+	struct playout_source_item *item = playout_source_current_item(playout);
+	if (playout_source_item_timed(item))
+		item->elapsed_ns = 0;
+	else if (playout->current_source)
 		obs_source_media_stop(playout->current_source);
 	playout->playing = false;
 }
@@ -1023,7 +3858,10 @@ void playout_source_stop(void *data)
 void playout_source_restart(void *data)
 {
 	struct playout_source_context *playout = data;
-	if (playout->current_source) {
+	struct playout_source_item *item = playout_source_current_item(playout);
+	if (playout_source_item_timed(item)) {
+		item->elapsed_ns = 0;
+	} else if (playout->current_source) {
 		enum obs_media_state state = obs_source_media_get_state(playout->current_source);
 		if (state == OBS_MEDIA_STATE_ENDED || state == OBS_MEDIA_STATE_STOPPED || state == OBS_MEDIA_STATE_NONE) {
 			obs_source_media_restart(playout->current_source);
@@ -1053,6 +3891,7 @@ void playout_source_play_pause(void *data, bool pause)
 void playout_source_next(void *data)
 {
 	struct playout_source_context *playout = data;
+	playout->end_reason = "next";
 	playout_source_switch_to_next_item(playout);
 }
 
@@ -1061,6 +3900,7 @@ void playout_source_previous(void *data)
 	struct playout_source_context *playout = data;
 	if (playout->current_index <= 0)
 		return;
+	playout->end_reason = "previous";
 	playout->current_index--;
 	playout_source_update_current_source(playout, true);
 }
@@ -1121,11 +3961,30 @@ MODULE_EXPORT const char *obs_module_name(void)
 bool obs_module_load(void)
 {
 	blog(LOG_INFO, "[Playout Source] loaded version %s", PROJECT_VERSION);
+	trace_init();
+	as_run_init();
+	journal_init();
+	integrity_scan_init();
+	media_cache_init();
+	proxy_cache_init();
+	filler_init();
+	module_config_init();
 	obs_register_source(&playout_source);
 	obs_register_source(&audio_wrapper_source);
+	obs_register_source(&next_up_source);
 	return true;
 }
 
 void obs_module_post_load() {}
 
-void obs_module_unload() {}
+void obs_module_unload()
+{
+	module_config_free();
+	proxy_cache_free();
+	filler_free();
+	media_cache_free();
+	integrity_scan_free();
+	journal_free();
+	as_run_free();
+	trace_free();
+}
@@ -1,18 +1,100 @@
 #pragma once
+#include "as-run.h"
+#include "metrics.h"
+#include "shuffle-bag.h"
+#include "sync-group.h"
+#include "timer-wheel.h"
 #include <obs-module.h>
+#include <util/darray.h>
+#include <util/threading.h>
+
+#define PLAYOUT_ITEM_TYPE_MEDIA 0
+#define PLAYOUT_ITEM_TYPE_IMAGE 1
+#define PLAYOUT_ITEM_TYPE_COLOR 2
+#define PLAYOUT_ITEM_TYPE_SOURCE 3
+
+struct playout_event {
+	struct timer_wheel_entry entry;
+	uint64_t offset_ms;
+	int action;
+	char *target;
+	char *name;
+};
 
 struct playout_source_item {
 	obs_source_t *source;
+	char *path;
 	char *section;
+	int type;
+	bool shared;
+	bool private_fallback;
+	bool remote;
+	char *checksum;
+	char *cached_path;
+	bool use_proxy;
+	char *proxy_path;
+	bool audio_only;
+	char *still_path;
+	obs_source_t *still;
 
 	uint64_t start;
 	uint64_t end;
+	uint64_t trim_start;
+	uint64_t trim_end;
 
 	obs_source_t *transition;
 	uint32_t transition_duration_ms;
 	uint32_t speed;
+	bool hw_decode;
+	int buffering_mb;
 	bool seek_start;
 	int64_t last_time;
+
+	uint64_t duration;
+	bool until_end;
+	uint32_t color;
+	obs_weak_source_t *weak_source;
+	uint64_t elapsed_ns;
+	uint64_t seek_ns;
+	long id;
+	bool deferred;
+	int scan_status;
+	long scan_generation;
+	int64_t hard_start_ms;
+	bool filler;
+	bool filler_planned;
+	DARRAY(struct playout_event) events;
+	DARRAY(struct playout_event) new_events;
+	bool events_changed;
+};
+
+struct playout_cue_request {
+	int type;
+	long value;
+	char *section;
+};
+
+struct playout_switch_stats {
+	uint64_t switches;
+	uint64_t missed;
+	uint64_t skipped;
+	uint64_t doubled;
+	uint64_t early;
+	int64_t late_min_ms;
+	int64_t late_max_ms;
+	int64_t late_total_ms;
+	long planned_id;
+	uint64_t ended_ns;
+};
+
+struct playout_metrics {
+	struct metrics_histogram tick_us;
+	struct metrics_histogram audio_render_us;
+	struct metrics_histogram switch_late_ms;
+	struct metrics_histogram seek_ms;
+	volatile long decoders;
+	volatile long transitions;
+	volatile long memory_kb;
 };
 
 struct playout_source_context {
@@ -28,6 +110,86 @@ struct playout_source_context {
 	bool switch_to_next;
 	int playback_mode;
 	int current_index;
+	int current_source_index;
+	bool share_decoders;
+	bool hw_decode;
+	int buffering_mb;
+	char *filler_path;
+	DARRAY(char *) filler_pool;
+	float filler_lead;
+	uint64_t prefetch_window_ns;
+	float prefetch_elapsed;
+	bool deferred_pending;
+	size_t deferred_cursor;
+	size_t deferred_scanned;
+	bool proxy_trimmed;
+	bool scan;
+	bool skip_failed;
+	bool seamless_loop;
+	obs_source_t *loop_source;
+	bool loop_shared;
+	bool loop_seek;
+	bool loop_ready;
+	int loop_index;
+	bool fixed_size;
+	uint32_t fixed_width;
+	uint32_t fixed_height;
+	int scale_mode;
+	obs_weak_source_t *sized_transition;
+	uint32_t sized_width;
+	uint32_t sized_height;
+	int sized_mode;
+	gs_texrender_t *render;
+	bool rendered;
+	uint32_t render_width;
+	uint32_t render_height;
+	bool hold_frames;
+	bool audio_only;
+	obs_source_t *still;
+	struct playout_switch_stats stats;
+	struct playout_metrics metrics;
+	volatile long next_id;
+	long cue_id;
+	char *signal_section;
+	float status_interval;
+	float status_elapsed;
+	bool as_run;
+	bool as_run_csv;
+	char *as_run_dir;
+	struct as_run_entry *as_run_entry;
+	int64_t as_run_out_ms;
+	const char *end_reason;
+	struct timer_wheel events_wheel;
+	long events_id;
+	bool events_reload;
+	volatile bool events_changed;
+	DARRAY(struct darray) events_retired;
+	struct sync_group *sync_group;
+	bool sync_master;
+	long sync_seq;
+	struct shuffle_bag shuffle;
+	bool shuffle_no_repeat;
+	int resume_mode;
+	bool resume_pending;
+	bool resumed;
+	long resume_id;
+	int64_t resume_offset_ms;
+	float resume_wait;
+	char *journal_id;
+	float journal_interval;
+	float journal_elapsed;
+	pthread_mutex_t edits_mutex;
+	DARRAY(obs_data_t *) edits;
+	volatile bool edits_pending;
+	DARRAY(struct playout_cue_request) cue_requests;
+	volatile bool cues_pending;
+	volatile long take_request;
 	DARRAY(struct playout_source_item) items;
 	obs_source_t *audio_wrapper;
+	pthread_mutex_t next_mutex;
+	obs_source_t *next_source;
 };
+
+int playout_source_find_id(struct playout_source_context *playout, long id);
+int playout_source_next_index(struct playout_source_context *playout, bool *switch_scene);
+obs_source_t *playout_source_get_next_source(struct playout_source_context *playout);
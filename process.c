@@ -0,0 +1,231 @@
+#include "process.h"
+#include <stdarg.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+#endif
+
+#define PROCESS_CANCEL_POLL_MS 100
+
+void process_args_init(struct process_args *args, const char *program)
+{
+	da_init(args->argv);
+	process_args_add(args, program);
+}
+
+void process_args_add(struct process_args *args, const char *arg)
+{
+	char *copy = bstrdup(arg);
+	da_push_back(args->argv, &copy);
+}
+
+void process_args_addf(struct process_args *args, const char *format, ...)
+{
+	struct dstr arg;
+	dstr_init(&arg);
+	va_list list;
+	va_start(list, format);
+	dstr_vprintf(&arg, format, list);
+	va_end(list);
+	da_push_back(args->argv, &arg.array);
+}
+
+void process_args_add_list(struct process_args *args, const char *arg, ...)
+{
+	va_list list;
+	va_start(list, arg);
+	for (; arg; arg = va_arg(list, const char *))
+		process_args_add(args, arg);
+	va_end(list);
+}
+
+void process_args_free(struct process_args *args)
+{
+	for (size_t i = 0; i < args->argv.num; i++)
+		bfree(args->argv.array[i]);
+	da_free(args->argv);
+}
+
+static void process_append_error(struct dstr *error, size_t max_error, const char *data, size_t len)
+{
+	if (!error || error->len >= max_error)
+		return;
+	if (len > max_error - error->len)
+		len = max_error - error->len;
+	dstr_ncat(error, data, len);
+}
+
+#ifdef _WIN32
+
+/* quotes an argument the way CommandLineToArgvW splits it again */
+static void process_quote_arg(struct dstr *cmd, const char *arg)
+{
+	if (cmd->len)
+		dstr_cat_ch(cmd, ' ');
+	if (*arg && !strpbrk(arg, " \t\n\v\"")) {
+		dstr_cat(cmd, arg);
+		return;
+	}
+	dstr_cat_ch(cmd, '"');
+	for (const char *p = arg;; p++) {
+		size_t backslashes = 0;
+		while (*p == '\\') {
+			backslashes++;
+			p++;
+		}
+		if (!*p) {
+			for (size_t i = 0; i < backslashes * 2; i++)
+				dstr_cat_ch(cmd, '\\');
+			break;
+		}
+		size_t count = *p == '"' ? backslashes * 2 + 1 : backslashes;
+		for (size_t i = 0; i < count; i++)
+			dstr_cat_ch(cmd, '\\');
+		dstr_cat_ch(cmd, *p);
+	}
+	dstr_cat_ch(cmd, '"');
+}
+
+int process_run(struct process_args *args, bool low_priority, struct dstr *error, size_t max_error, volatile bool *cancel)
+{
+	struct dstr cmd;
+	dstr_init(&cmd);
+	for (size_t i = 0; i < args->argv.num; i++)
+		process_quote_arg(&cmd, args->argv.array[i]);
+	wchar_t *wcmd = NULL;
+	os_utf8_to_wcs_ptr(cmd.array, 0, &wcmd);
+	dstr_free(&cmd);
+
+	SECURITY_ATTRIBUTES sa = {sizeof(sa), NULL, TRUE};
+	HANDLE read_pipe = NULL;
+	HANDLE write_pipe = NULL;
+	if (!wcmd || !CreatePipe(&read_pipe, &write_pipe, &sa, 0)) {
+		bfree(wcmd);
+		return PROCESS_NOT_EXECUTABLE;
+	}
+	SetHandleInformation(read_pipe, HANDLE_FLAG_INHERIT, 0);
+	HANDLE null = CreateFileW(L"NUL", GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_EXISTING,
+				  0, NULL);
+	STARTUPINFOW si = {0};
+	si.cb = sizeof(si);
+	si.dwFlags = STARTF_USESTDHANDLES;
+	si.hStdInput = null;
+	si.hStdOutput = null;
+	si.hStdError = write_pipe;
+	PROCESS_INFORMATION pi = {0};
+	DWORD flags = CREATE_NO_WINDOW | (low_priority ? IDLE_PRIORITY_CLASS : 0);
+	BOOL started = CreateProcessW(NULL, wcmd, NULL, NULL, TRUE, flags, NULL, NULL, &si, &pi);
+	DWORD create_error = GetLastError();
+	CloseHandle(write_pipe);
+	if (null != INVALID_HANDLE_VALUE)
+		CloseHandle(null);
+	bfree(wcmd);
+	if (!started) {
+		CloseHandle(read_pipe);
+		return create_error == ERROR_FILE_NOT_FOUND || create_error == ERROR_PATH_NOT_FOUND ? PROCESS_NOT_FOUND
+													: PROCESS_NOT_EXECUTABLE;
+	}
+	CloseHandle(pi.hThread);
+
+	char buffer[1024];
+	for (;;) {
+		DWORD available = 0;
+		if (!PeekNamedPipe(read_pipe, NULL, 0, NULL, &available, NULL))
+			break;
+		if (!available) {
+			if (cancel && os_atomic_load_bool(cancel))
+				TerminateProcess(pi.hProcess, 1);
+			if (WaitForSingleObject(pi.hProcess, PROCESS_CANCEL_POLL_MS) == WAIT_OBJECT_0 &&
+			    PeekNamedPipe(read_pipe, NULL, 0, NULL, &available, NULL) && !available)
+				break;
+			continue;
+		}
+		DWORD read = 0;
+		if (!ReadFile(read_pipe, buffer, available < sizeof(buffer) ? available : sizeof(buffer), &read, NULL) || !read)
+			break;
+		process_append_error(error, max_error, buffer, read);
+	}
+	CloseHandle(read_pipe);
+	WaitForSingleObject(pi.hProcess, INFINITE);
+	DWORD code = 1;
+	GetExitCodeProcess(pi.hProcess, &code);
+	CloseHandle(pi.hProcess);
+	return (int)code;
+}
+
+#else
+
+int process_run(struct process_args *args, bool low_priority, struct dstr *error, size_t max_error, volatile bool *cancel)
+{
+	int fds[2];
+	if (pipe(fds) != 0)
+		return PROCESS_NOT_EXECUTABLE;
+	/* only the dup2 below may reach the child, not another spawn running at the same time */
+	fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+	posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+	posix_spawn_file_actions_adddup2(&actions, fds[1], STDERR_FILENO);
+
+	char **argv = bmalloc((args->argv.num + 1) * sizeof(char *));
+	memcpy(argv, args->argv.array, args->argv.num * sizeof(char *));
+	argv[args->argv.num] = NULL;
+	pid_t pid;
+	int result = posix_spawnp(&pid, argv[0], &actions, NULL, argv, environ);
+	bfree(argv);
+	posix_spawn_file_actions_destroy(&actions);
+	close(fds[1]);
+	if (result != 0) {
+		close(fds[0]);
+		return result == ENOENT ? PROCESS_NOT_FOUND : PROCESS_NOT_EXECUTABLE;
+	}
+	if (low_priority)
+		setpriority(PRIO_PROCESS, (id_t)pid, 19);
+
+	char buffer[1024];
+	struct pollfd pfd = {fds[0], POLLIN, 0};
+	bool killed = false;
+	for (;;) {
+		if (cancel && !killed && os_atomic_load_bool(cancel)) {
+			kill(pid, SIGTERM);
+			killed = true;
+		}
+		int ready = poll(&pfd, 1, PROCESS_CANCEL_POLL_MS);
+		if (ready < 0 && errno != EINTR)
+			break;
+		if (ready <= 0)
+			continue;
+		ssize_t read_size = read(fds[0], buffer, sizeof(buffer));
+		if (read_size < 0 && errno == EINTR)
+			continue;
+		if (read_size <= 0)
+			break;
+		process_append_error(error, max_error, buffer, (size_t)read_size);
+	}
+	close(fds[0]);
+
+	int status = 0;
+	while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+		;
+	if (WIFEXITED(status))
+		return WEXITSTATUS(status);
+	return -1;
+}
+
+#endif
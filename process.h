@@ -0,0 +1,25 @@
+#pragma once
+#include <obs.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+
+/* exit codes of a program that could not be found or started, like a shell */
+#define PROCESS_NOT_FOUND 127
+#define PROCESS_NOT_EXECUTABLE 126
+
+struct process_args {
+	DARRAY(char *) argv;
+};
+
+void process_args_init(struct process_args *args, const char *program);
+void process_args_add(struct process_args *args, const char *arg);
+void process_args_addf(struct process_args *args, const char *format, ...);
+/* adds every argument up to a NULL */
+void process_args_add_list(struct process_args *args, const char *arg, ...);
+void process_args_free(struct process_args *args);
+
+/* Runs the program with these arguments and no shell in between, so paths
+ * arrive as given. Standard error is kept in error up to max_error bytes and
+ * the program is stopped when cancel becomes true. Returns the exit code, or
+ * -1 when the program was ended by a signal. */
+int process_run(struct process_args *args, bool low_priority, struct dstr *error, size_t max_error, volatile bool *cancel);
@@ -0,0 +1,232 @@
+#include "proxy-cache.h"
+#include "process.h"
+#include <obs-module.h>
+#include <sys/stat.h>
+#include <util/crc32.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+/* a failed transcode is retried after 30 seconds, doubling up to an hour */
+#define PROXY_CACHE_RETRY_MS 30000
+#define PROXY_CACHE_RETRY_MAX_MS 3600000
+
+struct proxy_cache_job {
+	char *path;
+	bool audio_only;
+	int attempts;
+	uint64_t retry_ns;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	pthread_t thread;
+	bool thread_created;
+	os_event_t *event;
+	volatile bool stopping;
+	char *dir;
+	char *ffmpeg_path;
+	int threads;
+	DARRAY(struct proxy_cache_job) jobs;
+} proxy;
+
+/* the name changes with the size and modification time, so a file replaced
+ * in place gets a new proxy */
+static void proxy_cache_file(const char *path, bool audio_only, struct dstr *file)
+{
+	struct stat st;
+	int64_t size = -1;
+	int64_t mtime = 0;
+	if (os_stat(path, &st) == 0) {
+		size = (int64_t)st.st_size;
+		mtime = (int64_t)st.st_mtime;
+	}
+	dstr_printf(file, audio_only ? "%s/%08X_%llX_%llX_audio.mka" : "%s/%08X_%llX_%llX.mov", proxy.dir,
+		    calc_crc32(0, path, strlen(path)), (unsigned long long)size, (unsigned long long)mtime);
+}
+
+static struct proxy_cache_job *proxy_cache_find_job(const char *path, bool audio_only)
+{
+	for (size_t i = 0; i < proxy.jobs.num; i++) {
+		if (proxy.jobs.array[i].audio_only == audio_only && strcmp(proxy.jobs.array[i].path, path) == 0)
+			return &proxy.jobs.array[i];
+	}
+	return NULL;
+}
+
+static bool proxy_cache_transcode(const char *path, bool audio_only, const char *ffmpeg_path, int threads)
+{
+	struct dstr file;
+	dstr_init(&file);
+	proxy_cache_file(path, audio_only, &file);
+	struct dstr part;
+	dstr_init_copy(&part, file.array);
+	dstr_cat(&part, ".part");
+
+	struct process_args args;
+	process_args_init(&args, ffmpeg_path);
+	process_args_add_list(&args, "-nostdin", "-y", "-v", "error", "-threads", NULL);
+	process_args_addf(&args, "%d", threads);
+	process_args_add_list(&args, "-i", path, NULL);
+	if (audio_only)
+		process_args_add_list(&args, "-map", "0:a", "-vn", "-sn", "-dn", "-c:a", "flac", "-f", "matroska", NULL);
+	else
+		process_args_add_list(&args, "-map", "0:v:0?", "-map", "0:a?", "-c:v", "mjpeg", "-q:v", "3", "-pix_fmt",
+				      "yuvj422p", "-c:a", "pcm_s16le", "-f", "mov", NULL);
+	/* the threads before -i only limit decoding, the encoder and filters need their own */
+	process_args_add(&args, "-threads");
+	process_args_addf(&args, "%d", threads);
+	process_args_add(&args, "-filter_threads");
+	process_args_addf(&args, "%d", threads);
+	process_args_add(&args, part.array);
+	blog(LOG_INFO, "[Playout Source] creating %sproxy for '%s'", audio_only ? "audio-only " : "", path);
+
+	struct dstr error;
+	dstr_init(&error);
+	int result = process_run(&args, false, &error, 4096, &proxy.stopping);
+	bool success = result == 0;
+	if (result == PROCESS_NOT_FOUND || result == PROCESS_NOT_EXECUTABLE)
+		blog(LOG_WARNING, "[Playout Source] failed to start '%s'", ffmpeg_path);
+	else if (!success)
+		blog(LOG_WARNING, "[Playout Source] proxy for '%s' failed: %s", path, error.array ? error.array : "");
+	dstr_free(&error);
+	process_args_free(&args);
+
+	if (success && !os_atomic_load_bool(&proxy.stopping)) {
+		os_unlink(file.array);
+		success = os_rename(part.array, file.array) == 0;
+	} else {
+		success = false;
+		os_unlink(part.array);
+	}
+	dstr_free(&part);
+	dstr_free(&file);
+	return success;
+}
+
+static void *proxy_cache_thread(void *param)
+{
+	UNUSED_PARAMETER(param);
+	os_set_thread_name("playout_proxy_cache");
+	while (!os_atomic_load_bool(&proxy.stopping)) {
+		char *path = NULL;
+		bool audio_only = false;
+		char *ffmpeg_path = NULL;
+		int threads = 1;
+		uint64_t now = os_gettime_ns();
+		uint64_t retry_ns = 0;
+		pthread_mutex_lock(&proxy.mutex);
+		for (size_t i = 0; i < proxy.jobs.num; i++) {
+			struct proxy_cache_job *job = &proxy.jobs.array[i];
+			if (job->retry_ns <= now) {
+				path = bstrdup(job->path);
+				audio_only = job->audio_only;
+				break;
+			}
+			if (!retry_ns || job->retry_ns < retry_ns)
+				retry_ns = job->retry_ns;
+		}
+		if (path) {
+			ffmpeg_path = bstrdup(proxy.ffmpeg_path);
+			threads = proxy.threads;
+		}
+		pthread_mutex_unlock(&proxy.mutex);
+		if (!path) {
+			if (retry_ns)
+				os_event_timedwait(proxy.event, (unsigned long)((retry_ns - now) / 1000000) + 1);
+			else
+				os_event_wait(proxy.event);
+			continue;
+		}
+
+		bool success = proxy_cache_transcode(path, audio_only, ffmpeg_path, threads);
+
+		pthread_mutex_lock(&proxy.mutex);
+		struct proxy_cache_job *job = proxy_cache_find_job(path, audio_only);
+		if (job && success) {
+			bfree(job->path);
+			da_erase(proxy.jobs, job - proxy.jobs.array);
+		} else if (job && !os_atomic_load_bool(&proxy.stopping)) {
+			uint64_t delay = (uint64_t)PROXY_CACHE_RETRY_MS << (job->attempts < 7 ? job->attempts : 7);
+			if (delay > PROXY_CACHE_RETRY_MAX_MS)
+				delay = PROXY_CACHE_RETRY_MAX_MS;
+			job->attempts++;
+			job->retry_ns = os_gettime_ns() + delay * 1000000ULL;
+			blog(LOG_INFO, "[Playout Source] retrying the proxy for '%s' in %d seconds", path, (int)(delay / 1000));
+		}
+		pthread_mutex_unlock(&proxy.mutex);
+		bfree(ffmpeg_path);
+		bfree(path);
+	}
+	return NULL;
+}
+
+void proxy_cache_init(void)
+{
+	pthread_mutex_init(&proxy.mutex, NULL);
+	os_event_init(&proxy.event, OS_EVENT_TYPE_AUTO);
+	proxy.dir = obs_module_config_path("proxies");
+	os_mkdirs(proxy.dir);
+	proxy.ffmpeg_path = bstrdup("ffmpeg");
+	proxy.threads = 1;
+	proxy.thread_created = pthread_create(&proxy.thread, NULL, proxy_cache_thread, NULL) == 0;
+}
+
+void proxy_cache_free(void)
+{
+	os_atomic_set_bool(&proxy.stopping, true);
+	if (proxy.thread_created) {
+		os_event_signal(proxy.event);
+		pthread_join(proxy.thread, NULL);
+		proxy.thread_created = false;
+	}
+	for (size_t i = 0; i < proxy.jobs.num; i++)
+		bfree(proxy.jobs.array[i].path);
+	da_free(proxy.jobs);
+	bfree(proxy.ffmpeg_path);
+	proxy.ffmpeg_path = NULL;
+	bfree(proxy.dir);
+	proxy.dir = NULL;
+	os_event_destroy(proxy.event);
+	pthread_mutex_destroy(&proxy.mutex);
+}
+
+void proxy_cache_set_options(const char *ffmpeg_path, int threads)
+{
+	pthread_mutex_lock(&proxy.mutex);
+	if (ffmpeg_path && strlen(ffmpeg_path) && strcmp(proxy.ffmpeg_path, ffmpeg_path) != 0) {
+		bfree(proxy.ffmpeg_path);
+		proxy.ffmpeg_path = bstrdup(ffmpeg_path);
+		for (size_t i = 0; i < proxy.jobs.num; i++) {
+			proxy.jobs.array[i].attempts = 0;
+			proxy.jobs.array[i].retry_ns = 0;
+		}
+	}
+	proxy.threads = threads > 0 ? threads : 1;
+	pthread_mutex_unlock(&proxy.mutex);
+	os_event_signal(proxy.event);
+}
+
+char *proxy_cache_get(const char *path, bool audio_only)
+{
+	struct dstr file;
+	dstr_init(&file);
+	proxy_cache_file(path, audio_only, &file);
+	if (os_file_exists(file.array))
+		return file.array;
+	dstr_free(&file);
+	return NULL;
+}
+
+void proxy_cache_request(const char *path, bool audio_only)
+{
+	pthread_mutex_lock(&proxy.mutex);
+	if (!proxy_cache_find_job(path, audio_only)) {
+		struct proxy_cache_job *job = da_push_back_new(proxy.jobs);
+		job->path = bstrdup(path);
+		job->audio_only = audio_only;
+	}
+	pthread_mutex_unlock(&proxy.mutex);
+	os_event_signal(proxy.event);
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <obs.h>
+
+void proxy_cache_init(void);
+void proxy_cache_free(void);
+void proxy_cache_set_options(const char *ffmpeg_path, int threads);
+
+char *proxy_cache_get(const char *path, bool audio_only);
+void proxy_cache_request(const char *path, bool audio_only);
@@ -0,0 +1,171 @@
+#include "shuffle-bag.h"
+#include "playout-source.h"
+#include <stdlib.h>
+#include <util/platform.h>
+
+struct shuffle_bag_entry {
+	long id;
+	int index;
+	bool found;
+};
+
+static uint64_t shuffle_bag_random(struct shuffle_bag *bag, uint64_t range)
+{
+	if (!bag->seed)
+		bag->seed = os_gettime_ns() | 1;
+	bag->seed ^= bag->seed >> 12;
+	bag->seed ^= bag->seed << 25;
+	bag->seed ^= bag->seed >> 27;
+	return (bag->seed * 2685821657736338717ULL) % range;
+}
+
+static void shuffle_bag_swap(struct shuffle_bag *bag, size_t a, size_t b)
+{
+	da_swap(bag->ids, a, b);
+	da_swap(bag->indices, a, b);
+}
+
+void shuffle_bag_free(struct shuffle_bag *bag)
+{
+	da_free(bag->ids);
+	da_free(bag->indices);
+	bag->position = 0;
+	bag->first = 0;
+	bag->count = 0;
+	bag->cycle_end = false;
+}
+
+void shuffle_bag_fill(struct shuffle_bag *bag, struct playout_source_item *items, int first, int count, int played,
+		      bool no_repeat)
+{
+	da_resize(bag->ids, (size_t)count);
+	da_resize(bag->indices, (size_t)count);
+	for (int i = 0; i < count; i++) {
+		bag->ids.array[i] = items[first + i].id;
+		bag->indices.array[i] = first + i;
+	}
+	for (size_t i = bag->ids.num; i > 1; i--)
+		shuffle_bag_swap(bag, i - 1, (size_t)shuffle_bag_random(bag, i));
+	bag->first = first;
+	bag->count = count;
+	bag->position = 0;
+	bag->cycle_end = false;
+	if (played < first || played >= first + count)
+		return;
+	if (bag->indices.array[0] == played && no_repeat && count > 1)
+		shuffle_bag_swap(bag, 0, 1 + (size_t)shuffle_bag_random(bag, (uint64_t)count - 1));
+}
+
+void shuffle_bag_advance(struct shuffle_bag *bag, struct playout_source_item *items, bool no_repeat)
+{
+	if (bag->position < bag->ids.num)
+		bag->position++;
+	bag->cycle_end = false;
+	if (bag->position < bag->ids.num)
+		return;
+	int played = bag->ids.num ? bag->indices.array[bag->ids.num - 1] : -1;
+	shuffle_bag_fill(bag, items, bag->first, bag->count, played, no_repeat);
+	bag->cycle_end = true;
+}
+
+static int shuffle_bag_compare(const void *a, const void *b)
+{
+	long id_a = ((const struct shuffle_bag_entry *)a)->id;
+	long id_b = ((const struct shuffle_bag_entry *)b)->id;
+	return id_a < id_b ? -1 : id_a > id_b ? 1 : 0;
+}
+
+void shuffle_bag_start(struct shuffle_bag *bag, struct playout_source_item *items, int first, int count, int current,
+		       bool no_repeat)
+{
+	shuffle_bag_fill(bag, items, first, count, -1, false);
+	for (size_t i = 0; i < bag->indices.num; i++) {
+		if (bag->indices.array[i] == current) {
+			shuffle_bag_swap(bag, 0, i);
+			shuffle_bag_advance(bag, items, no_repeat);
+			break;
+		}
+	}
+}
+
+void shuffle_bag_remap(struct shuffle_bag *bag, struct playout_source_item *items, int first, int count, bool no_repeat)
+{
+	struct shuffle_bag_entry *entries = bmalloc(sizeof(struct shuffle_bag_entry) * (count ? count : 1));
+	for (int i = 0; i < count; i++) {
+		entries[i].id = items[first + i].id;
+		entries[i].index = first + i;
+		entries[i].found = false;
+	}
+	qsort(entries, (size_t)count, sizeof(struct shuffle_bag_entry), shuffle_bag_compare);
+
+	da_resize(bag->indices, bag->ids.num);
+	size_t kept = 0;
+	size_t position = 0;
+	for (size_t i = 0; i < bag->ids.num; i++) {
+		struct shuffle_bag_entry key = {.id = bag->ids.array[i]};
+		struct shuffle_bag_entry *entry =
+			bsearch(&key, entries, (size_t)count, sizeof(struct shuffle_bag_entry), shuffle_bag_compare);
+		if (!entry || entry->found)
+			continue;
+		entry->found = true;
+		bag->ids.array[kept] = entry->id;
+		bag->indices.array[kept] = entry->index;
+		kept++;
+		if (i < bag->position)
+			position = kept;
+	}
+	da_resize(bag->ids, kept);
+	da_resize(bag->indices, kept);
+	bag->position = position;
+	for (int i = 0; i < count; i++) {
+		if (entries[i].found)
+			continue;
+		da_push_back(bag->ids, &entries[i].id);
+		da_push_back(bag->indices, &entries[i].index);
+		size_t unplayed = bag->ids.num - bag->position;
+		shuffle_bag_swap(bag, bag->ids.num - 1, bag->position + (size_t)shuffle_bag_random(bag, unplayed));
+	}
+	bfree(entries);
+	bag->first = first;
+	bag->count = count;
+	if (bag->position >= bag->ids.num && bag->ids.num) {
+		bag->position = bag->ids.num - 1;
+		shuffle_bag_advance(bag, items, no_repeat);
+	}
+}
+
+int shuffle_bag_peek_at(struct shuffle_bag *bag, size_t ahead)
+{
+	if (bag->position + ahead >= bag->ids.num)
+		return -1;
+	return bag->indices.array[bag->position + ahead];
+}
+
+bool shuffle_bag_covers(struct shuffle_bag *bag, int index)
+{
+	return bag->ids.num && index >= bag->first && index < bag->first + bag->count;
+}
+
+void shuffle_bag_save(struct shuffle_bag *bag, struct dstr *ids)
+{
+	dstr_copy(ids, "");
+	for (size_t i = 0; i < bag->ids.num; i++)
+		dstr_catf(ids, i ? ",%ld" : "%ld", bag->ids.array[i]);
+}
+
+void shuffle_bag_load(struct shuffle_bag *bag, const char *ids, size_t position)
+{
+	da_resize(bag->ids, 0);
+	da_resize(bag->indices, 0);
+	while (ids && *ids) {
+		char *end;
+		long id = strtol(ids, &end, 10);
+		if (end == ids)
+			break;
+		if (id > 0)
+			da_push_back(bag->ids, &id);
+		ids = *end == ',' ? end + 1 : end;
+	}
+	bag->position = position < bag->ids.num ? position : 0;
+	bag->cycle_end = false;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <obs.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+
+struct playout_source_item;
+
+/* ids and indices hold one cycle in play order, entries before position have played */
+struct shuffle_bag {
+	DARRAY(long) ids;
+	DARRAY(int) indices;
+	size_t position;
+	int first;
+	int count;
+	bool cycle_end;
+	uint64_t seed;
+};
+
+void shuffle_bag_free(struct shuffle_bag *bag);
+void shuffle_bag_fill(struct shuffle_bag *bag, struct playout_source_item *items, int first, int count, int played,
+		      bool no_repeat);
+void shuffle_bag_advance(struct shuffle_bag *bag, struct playout_source_item *items, bool no_repeat);
+void shuffle_bag_start(struct shuffle_bag *bag, struct playout_source_item *items, int first, int count, int current,
+		       bool no_repeat);
+void shuffle_bag_remap(struct shuffle_bag *bag, struct playout_source_item *items, int first, int count, bool no_repeat);
+int shuffle_bag_peek_at(struct shuffle_bag *bag, size_t ahead);
+bool shuffle_bag_covers(struct shuffle_bag *bag, int index);
+
+void shuffle_bag_save(struct shuffle_bag *bag, struct dstr *ids);
+void shuffle_bag_load(struct shuffle_bag *bag, const char *ids, size_t position);
@@ -0,0 +1,163 @@
+#include "source-registry.h"
+#include <util/darray.h>
+#include <util/dstr.h>
+#include <util/threading.h>
+
+struct source_registry_owner {
+	void *owner;
+	long refs;
+};
+
+struct source_registry_entry {
+	char *key;
+	obs_source_t *source;
+	void *claimed_by;
+	DARRAY(struct source_registry_owner) owners;
+};
+
+static pthread_mutex_t registry_mutex = PTHREAD_MUTEX_INITIALIZER;
+static DARRAY(struct source_registry_entry) registry_entries;
+
+static size_t source_registry_find_key(const char *key, bool *found)
+{
+	size_t low = 0;
+	size_t high = registry_entries.num;
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+		int cmp = strcmp(registry_entries.array[mid].key, key);
+		if (cmp == 0) {
+			*found = true;
+			return mid;
+		}
+		if (cmp < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	*found = false;
+	return low;
+}
+
+static struct source_registry_entry *source_registry_find_source(obs_source_t *source)
+{
+	for (size_t i = 0; i < registry_entries.num; i++) {
+		if (registry_entries.array[i].source == source)
+			return &registry_entries.array[i];
+	}
+	return NULL;
+}
+
+obs_source_t *source_registry_acquire(const char *id, const char *key, const char *name, obs_data_t *settings, void *owner,
+				      bool *first)
+{
+	struct dstr full_key;
+	dstr_init_copy(&full_key, id);
+	dstr_cat_ch(&full_key, '|');
+	dstr_cat(&full_key, key);
+
+	pthread_mutex_lock(&registry_mutex);
+	bool found;
+	size_t idx = source_registry_find_key(full_key.array, &found);
+	if (!found) {
+		struct source_registry_entry *entry = da_insert_new(registry_entries, idx);
+		entry->key = full_key.array;
+		entry->source = obs_source_create_private(id, name, settings);
+		dstr_init(&full_key);
+	}
+	dstr_free(&full_key);
+	struct source_registry_entry *entry = &registry_entries.array[idx];
+	struct source_registry_owner *owner_ref = NULL;
+	for (size_t i = 0; i < entry->owners.num; i++) {
+		if (entry->owners.array[i].owner == owner) {
+			owner_ref = &entry->owners.array[i];
+			break;
+		}
+	}
+	if (!owner_ref) {
+		owner_ref = da_push_back_new(entry->owners);
+		owner_ref->owner = owner;
+	}
+	owner_ref->refs++;
+	if (first)
+		*first = owner_ref->refs == 1;
+	obs_source_t *source = obs_source_get_ref(entry->source);
+	pthread_mutex_unlock(&registry_mutex);
+	return source;
+}
+
+bool source_registry_release(obs_source_t *source, void *owner)
+{
+	if (!source)
+		return false;
+	bool last = false;
+	obs_source_t *release = NULL;
+	pthread_mutex_lock(&registry_mutex);
+	struct source_registry_entry *entry = source_registry_find_source(source);
+	if (entry) {
+		for (size_t i = 0; i < entry->owners.num; i++) {
+			if (entry->owners.array[i].owner != owner)
+				continue;
+			if (--entry->owners.array[i].refs <= 0) {
+				da_erase(entry->owners, i);
+				last = true;
+				if (entry->claimed_by == owner)
+					entry->claimed_by = NULL;
+			}
+			break;
+		}
+		if (!entry->owners.num) {
+			release = entry->source;
+			bfree(entry->key);
+			da_free(entry->owners);
+			da_erase(registry_entries, entry - registry_entries.array);
+			if (!registry_entries.num)
+				da_free(registry_entries);
+		}
+	}
+	pthread_mutex_unlock(&registry_mutex);
+	obs_source_release(release);
+	return last;
+}
+
+bool source_registry_claim(obs_source_t *source, void *owner)
+{
+	bool claimed = true;
+	pthread_mutex_lock(&registry_mutex);
+	struct source_registry_entry *entry = source_registry_find_source(source);
+	if (entry) {
+		if (!entry->claimed_by || entry->claimed_by == owner)
+			entry->claimed_by = owner;
+		else
+			claimed = false;
+	}
+	pthread_mutex_unlock(&registry_mutex);
+	return claimed;
+}
+
+void source_registry_unclaim(obs_source_t *source, void *owner)
+{
+	pthread_mutex_lock(&registry_mutex);
+	struct source_registry_entry *entry = source_registry_find_source(source);
+	if (entry && entry->claimed_by == owner)
+		entry->claimed_by = NULL;
+	pthread_mutex_unlock(&registry_mutex);
+}
+
+/* a source another owner has on air must not be seeked, paused or restarted */
+bool source_registry_claimed_by_other(obs_source_t *source, void *owner)
+{
+	pthread_mutex_lock(&registry_mutex);
+	struct source_registry_entry *entry = source_registry_find_source(source);
+	bool other = entry && entry->claimed_by && entry->claimed_by != owner;
+	pthread_mutex_unlock(&registry_mutex);
+	return other;
+}
+
+bool source_registry_claimed_by(obs_source_t *source, void *owner)
+{
+	pthread_mutex_lock(&registry_mutex);
+	struct source_registry_entry *entry = source_registry_find_source(source);
+	bool claimed = entry && entry->claimed_by == owner;
+	pthread_mutex_unlock(&registry_mutex);
+	return claimed;
+}
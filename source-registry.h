@@ -0,0 +1,10 @@
+#pragma once
+#include <obs.h>
+
+obs_source_t *source_registry_acquire(const char *id, const char *key, const char *name, obs_data_t *settings, void *owner,
+				      bool *first);
+bool source_registry_release(obs_source_t *source, void *owner);
+bool source_registry_claim(obs_source_t *source, void *owner);
+void source_registry_unclaim(obs_source_t *source, void *owner);
+bool source_registry_claimed_by_other(obs_source_t *source, void *owner);
+bool source_registry_claimed_by(obs_source_t *source, void *owner);
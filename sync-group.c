@@ -0,0 +1,137 @@
+#include "sync-group.h"
+#include <util/darray.h>
+#include <util/threading.h>
+
+struct sync_group_member {
+	void *member;
+	bool master;
+	bool ready;
+};
+
+/* a switch requested by the master on frame commit_frame is taken by every
+ * member on the first tick of a later frame, so all members cut on the same one */
+struct sync_group {
+	char *name;
+	DARRAY(struct sync_group_member) members;
+	long commit_seq;
+	uint64_t commit_frame;
+};
+
+static pthread_mutex_t groups_mutex = PTHREAD_MUTEX_INITIALIZER;
+static DARRAY(struct sync_group *) groups;
+
+static struct sync_group_member *sync_group_find_member(struct sync_group *group, void *member)
+{
+	for (size_t i = 0; i < group->members.num; i++) {
+		if (group->members.array[i].member == member)
+			return &group->members.array[i];
+	}
+	return NULL;
+}
+
+static struct sync_group_member *sync_group_master(struct sync_group *group)
+{
+	for (size_t i = 0; i < group->members.num; i++) {
+		if (group->members.array[i].master)
+			return &group->members.array[i];
+	}
+	return group->members.num ? &group->members.array[0] : NULL;
+}
+
+struct sync_group *sync_group_join(const char *name, void *member, bool master, long *seq)
+{
+	if (!name || !strlen(name))
+		return NULL;
+	pthread_mutex_lock(&groups_mutex);
+	struct sync_group *group = NULL;
+	for (size_t i = 0; i < groups.num && !group; i++) {
+		if (strcmp(groups.array[i]->name, name) == 0)
+			group = groups.array[i];
+	}
+	if (!group) {
+		group = bzalloc(sizeof(struct sync_group));
+		group->name = bstrdup(name);
+		da_push_back(groups, &group);
+	}
+	struct sync_group_member *m = sync_group_find_member(group, member);
+	if (!m) {
+		m = da_push_back_new(group->members);
+		m->member = member;
+	}
+	m->master = master;
+	*seq = group->commit_seq;
+	pthread_mutex_unlock(&groups_mutex);
+	return group;
+}
+
+void sync_group_leave(struct sync_group *group, void *member)
+{
+	if (!group)
+		return;
+	pthread_mutex_lock(&groups_mutex);
+	struct sync_group_member *m = sync_group_find_member(group, member);
+	if (m)
+		da_erase(group->members, m - group->members.array);
+	if (!group->members.num) {
+		da_erase_item(groups, &group);
+		da_free(group->members);
+		bfree(group->name);
+		bfree(group);
+	}
+	if (!groups.num)
+		da_free(groups);
+	pthread_mutex_unlock(&groups_mutex);
+}
+
+const char *sync_group_name(struct sync_group *group)
+{
+	return group ? group->name : NULL;
+}
+
+bool sync_group_is_master(struct sync_group *group, void *member)
+{
+	pthread_mutex_lock(&groups_mutex);
+	struct sync_group_member *m = sync_group_master(group);
+	bool master = m && m->member == member;
+	pthread_mutex_unlock(&groups_mutex);
+	return master;
+}
+
+void sync_group_set_ready(struct sync_group *group, void *member, bool ready)
+{
+	pthread_mutex_lock(&groups_mutex);
+	struct sync_group_member *m = sync_group_find_member(group, member);
+	if (m)
+		m->ready = ready;
+	pthread_mutex_unlock(&groups_mutex);
+}
+
+bool sync_group_all_ready(struct sync_group *group)
+{
+	pthread_mutex_lock(&groups_mutex);
+	bool ready = true;
+	for (size_t i = 0; i < group->members.num && ready; i++)
+		ready = group->members.array[i].ready;
+	pthread_mutex_unlock(&groups_mutex);
+	return ready;
+}
+
+void sync_group_request_switch(struct sync_group *group, uint64_t frame_time)
+{
+	pthread_mutex_lock(&groups_mutex);
+	if (group->commit_frame != frame_time) {
+		group->commit_seq++;
+		group->commit_frame = frame_time;
+	}
+	pthread_mutex_unlock(&groups_mutex);
+}
+
+bool sync_group_switch_due(struct sync_group *group, long *seq, uint64_t frame_time)
+{
+	pthread_mutex_lock(&groups_mutex);
+	bool due = *seq != group->commit_seq && frame_time > group->commit_frame;
+	if (due)
+		*seq = group->commit_seq;
+	pthread_mutex_unlock(&groups_mutex);
+	return due;
+}
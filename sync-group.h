@@ -0,0 +1,14 @@
+#pragma once
+#include <obs.h>
+
+struct sync_group;
+
+struct sync_group *sync_group_join(const char *name, void *member, bool master, long *seq);
+void sync_group_leave(struct sync_group *group, void *member);
+const char *sync_group_name(struct sync_group *group);
+
+bool sync_group_is_master(struct sync_group *group, void *member);
+void sync_group_set_ready(struct sync_group *group, void *member, bool ready);
+bool sync_group_all_ready(struct sync_group *group);
+void sync_group_request_switch(struct sync_group *group, uint64_t frame_time);
+bool sync_group_switch_due(struct sync_group *group, long *seq, uint64_t frame_time);
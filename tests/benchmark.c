@@ -0,0 +1,245 @@
+/* Benchmarks the hot paths of the playout source against the mock libobs at
+ * 10, 1k and 10k items. Every result is one JSON object per line on stdout,
+ * with --output the same lines are also written to a file. */
+
+#include "../playout-source.c"
+#include <mock-obs.h>
+#include <stdlib.h>
+
+#define BENCH_MEDIA_MS 5000
+
+struct bench_context {
+	obs_source_t *source;
+	obs_scene_t *scene;
+	struct playout_source_context *playout;
+	obs_properties_t *props;
+	int items;
+};
+
+static FILE *bench_output;
+static bool bench_quick;
+
+static uint64_t bench_now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_compare(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+	return x < y ? -1 : x > y;
+}
+
+static void bench_report(const char *name, int items, uint64_t *samples, int count)
+{
+	qsort(samples, (size_t)count, sizeof(uint64_t), bench_compare);
+	uint64_t total = 0;
+	for (int i = 0; i < count; i++)
+		total += samples[i];
+	struct dstr line;
+	dstr_init(&line);
+	dstr_printf(&line,
+		    "{\"benchmark\":\"%s\",\"items\":%d,\"iterations\":%d,\"mean_us\":%.3f,\"min_us\":%.3f,"
+		    "\"p50_us\":%.3f,\"p99_us\":%.3f,\"max_us\":%.3f}",
+		    name, items, count, (double)total / count / 1000.0, samples[0] / 1000.0, samples[count / 2] / 1000.0,
+		    samples[(count * 99) / 100 < count ? (count * 99) / 100 : count - 1] / 1000.0, samples[count - 1] / 1000.0);
+	printf("%s\n", line.array);
+	if (bench_output)
+		fprintf(bench_output, "%s\n", line.array);
+	dstr_free(&line);
+}
+
+static int bench_iterations(int items, int base)
+{
+	int iterations = base * 100 / items;
+	if (bench_quick)
+		iterations /= 20;
+	if (iterations < 3)
+		iterations = 3;
+	if (iterations > base)
+		iterations = base;
+	return iterations;
+}
+
+static void bench_setup(struct bench_context *ctx, int items)
+{
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->items = items;
+	obs_data_t *settings = obs_data_create();
+	obs_data_set_bool(settings, "autoplay", true);
+	obs_data_set_bool(settings, "loop", true);
+	struct dstr name;
+	dstr_init(&name);
+	struct dstr path;
+	dstr_init(&path);
+	for (int i = 0; i < items; i++) {
+		dstr_printf(&path, "/media/bench/clip%05d.mp4", i);
+		dstr_printf(&name, "path%d", i);
+		obs_data_set_string(settings, name.array, path.array);
+		dstr_printf(&name, "section%d", i);
+		obs_data_set_string(settings, name.array, i % 10 < 5 ? "morning" : "evening");
+		mock_media_set_duration(path.array, BENCH_MEDIA_MS);
+	}
+	dstr_free(&path);
+	dstr_free(&name);
+	ctx->source = obs_source_create("playout_source", "Playout benchmark", settings, NULL);
+	obs_data_release(settings);
+	ctx->playout = obs_obj_get_data(ctx->source);
+	ctx->scene = mock_obs_create_scene("Benchmark scene");
+	obs_scene_add(ctx->scene, ctx->source);
+	obs_set_output_source(0, obs_scene_get_source(ctx->scene));
+	ctx->props = obs_source_properties(ctx->source);
+	/* let the deferred item creation finish and the first item start */
+	for (int i = 0; i < 60; i++)
+		mock_obs_video_tick();
+}
+
+static void bench_teardown(struct bench_context *ctx)
+{
+	obs_properties_destroy(ctx->props);
+	obs_set_output_source(0, NULL);
+	obs_scene_release(ctx->scene);
+	obs_source_release(ctx->source);
+}
+
+static void bench_update(struct bench_context *ctx)
+{
+	int count = bench_iterations(ctx->items, 200);
+	uint64_t *samples = bmalloc(sizeof(uint64_t) * (size_t)count);
+	obs_data_t *settings = obs_source_get_settings(ctx->source);
+	for (int i = 0; i < count; i++) {
+		uint64_t start = bench_now_ns();
+		playout_source_update(ctx->playout, settings);
+		samples[i] = bench_now_ns() - start;
+		mock_obs_video_tick();
+	}
+	obs_data_release(settings);
+	bench_report("playout_source_update", ctx->items, samples, count);
+	bfree(samples);
+}
+
+static void bench_switch(struct bench_context *ctx)
+{
+	int count = bench_iterations(ctx->items, 500);
+	uint64_t *samples = bmalloc(sizeof(uint64_t) * (size_t)count);
+	for (int i = 0; i < count; i++) {
+		uint64_t start = bench_now_ns();
+		playout_source_switch_to_next_item(ctx->playout);
+		samples[i] = bench_now_ns() - start;
+		mock_obs_video_tick();
+	}
+	bench_report("switch_to_next_item", ctx->items, samples, count);
+	bfree(samples);
+}
+
+static void bench_last(struct bench_context *ctx)
+{
+	int count = 1000;
+	uint64_t *samples = bmalloc(sizeof(uint64_t) * (size_t)count);
+	bool loop = ctx->playout->loop;
+	int mode = ctx->playout->playback_mode;
+	ctx->playout->loop = false;
+	ctx->playout->playback_mode = PLAYBACK_MODE_SECTION;
+	volatile bool last = false;
+	for (int i = 0; i < count; i++) {
+		uint64_t start = bench_now_ns();
+		for (int r = 0; r < 100; r++)
+			last = playout_source_last(ctx->playout);
+		samples[i] = (bench_now_ns() - start) / 100;
+	}
+	UNUSED_PARAMETER(last);
+	ctx->playout->loop = loop;
+	ctx->playout->playback_mode = mode;
+	bench_report("playout_source_last", ctx->items, samples, count);
+	bfree(samples);
+}
+
+static void bench_action(struct bench_context *ctx, const char *name, long long action)
+{
+	int count = bench_iterations(ctx->items, 200);
+	uint64_t *samples = bmalloc(sizeof(uint64_t) * (size_t)count);
+	obs_data_t *settings = obs_source_get_settings(ctx->source);
+	obs_data_set_string(settings, "action_transition", "fade_transition");
+	obs_data_set_int(settings, "action_transition_duration", 500);
+	obs_data_set_string(settings, "action_section", "night");
+	for (int i = 0; i < count; i++) {
+		obs_data_set_int(settings, "action", action);
+		uint64_t start = bench_now_ns();
+		playout_source_action(ctx->props, NULL, ctx->playout);
+		samples[i] = bench_now_ns() - start;
+	}
+	obs_data_release(settings);
+	bench_report(name, ctx->items, samples, count);
+	bfree(samples);
+}
+
+static void bench_video_tick(struct bench_context *ctx)
+{
+	int count = bench_quick ? 300 : 3000;
+	uint64_t *samples = bmalloc(sizeof(uint64_t) * (size_t)count);
+	mock_obs_measure_tick(ctx->source);
+	for (int i = 0; i < count; i++) {
+		mock_obs_video_tick();
+		samples[i] = mock_obs_measured_tick_ns();
+	}
+	mock_obs_measure_tick(NULL);
+	bench_report("video_tick", ctx->items, samples, count);
+	bfree(samples);
+}
+
+static void bench_run(int items)
+{
+	struct bench_context ctx;
+	bench_setup(&ctx, items);
+	bench_video_tick(&ctx);
+	bench_update(&ctx);
+	bench_switch(&ctx);
+	bench_last(&ctx);
+	bench_action(&ctx, "action_select_all", PLAYOUT_ACTION_SELECT_ALL);
+	bench_action(&ctx, "action_selection_invert", PLAYOUT_ACTION_SELECTION_INVERT);
+	bench_action(&ctx, "action_select_none", PLAYOUT_ACTION_SELECT_NONE);
+	bench_action(&ctx, "action_transition_selected", PLAYOUT_ACTION_TRANSITION_SELECTED);
+	bench_action(&ctx, "action_section_selected", PLAYOUT_ACTION_SECTION_SELECTED);
+	/* every other item selected, moving them swaps pairs back and forth */
+	obs_data_t *settings = obs_source_get_settings(ctx.source);
+	struct dstr name;
+	dstr_init(&name);
+	for (int i = 0; i < items; i++) {
+		dstr_printf(&name, "selected%d", i);
+		obs_data_set_bool(settings, name.array, i % 2 == 1);
+	}
+	dstr_free(&name);
+	obs_data_release(settings);
+	bench_action(&ctx, "action_move_selected_up", PLAYOUT_ACTION_MOVE_SELECTED_UP);
+	bench_action(&ctx, "action_move_selected_down", PLAYOUT_ACTION_MOVE_SELECTED_DOWN);
+	bench_teardown(&ctx);
+}
+
+int main(int argc, char **argv)
+{
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0) {
+			bench_quick = true;
+		} else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+			bench_output = fopen(argv[++i], "w");
+		} else {
+			fprintf(stderr, "usage: %s [--quick] [--output file]\n", argv[0]);
+			return 1;
+		}
+	}
+	/* one result per line even when stdout is a pipe */
+	setvbuf(stdout, NULL, _IOLBF, 0);
+	mock_obs_startup(MOCK_CONFIG_DIR);
+	obs_module_load();
+	static const int sizes[] = {10, 1000, 10000};
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+		bench_run(sizes[i]);
+	obs_module_unload();
+	mock_obs_shutdown();
+	if (bench_output)
+		fclose(bench_output);
+	return 0;
+}
@@ -0,0 +1,159 @@
+/* Tests the media cache against the mock libobs. Files are fetched through
+ * curl from file:// URLs, so the download path runs without a network. Checks
+ * that a URL whose file name is taken by another URL gets a file of its own and
+ * that a download replacing a pinned file waits until it is unpinned. Exits
+ * with 1 when a check fails. */
+
+#include "../media-cache.c"
+#include <mock-obs.h>
+#include <stdlib.h>
+
+static int cache_failed;
+
+static void cache_check(bool ok, const char *what)
+{
+	printf("%s: %s\n", ok ? "ok" : "FAILED", what);
+	if (!ok)
+		cache_failed = 1;
+}
+
+static void cache_write(const char *path, const char *content)
+{
+	os_quick_write_utf8_file(path, content, strlen(content), false);
+}
+
+static bool cache_contains(const char *path, const char *content)
+{
+	char *data = path ? os_quick_read_utf8_file(path) : NULL;
+	bool match = data && strcmp(data, content) == 0;
+	bfree(data);
+	return match;
+}
+
+static void cache_checksum(const char *content, struct dstr *checksum)
+{
+	dstr_printf(checksum, "%08X", calc_crc32(0, content, strlen(content)));
+}
+
+/* the download thread runs on the real clock */
+static char *cache_wait(const char *url, const char *checksum)
+{
+	for (int i = 0; i < 500; i++) {
+		char *file = media_cache_get(url, checksum);
+		if (file)
+			return file;
+		os_sleep_ms(10);
+	}
+	return NULL;
+}
+
+static bool cache_wait_pending(const char *url)
+{
+	for (int i = 0; i < 500; i++) {
+		pthread_mutex_lock(&cache.mutex);
+		struct media_cache_entry *entry = media_cache_find_entry(url);
+		bool pending = entry && entry->pending;
+		pthread_mutex_unlock(&cache.mutex);
+		if (pending)
+			return true;
+		os_sleep_ms(10);
+	}
+	return false;
+}
+
+int main(void)
+{
+	setvbuf(stdout, NULL, _IOLBF, 0);
+	mock_obs_startup(MOCK_CONFIG_DIR);
+	char *dir = obs_module_config_path("cache");
+	os_mkdirs(dir);
+	struct dstr path;
+	dstr_init_copy(&path, dir);
+	dstr_cat(&path, "/cache.json");
+	os_unlink(path.array);
+
+	struct dstr media;
+	dstr_init_copy(&media, MOCK_CONFIG_DIR);
+	dstr_cat(&media, "/media");
+	os_mkdirs(media.array);
+	struct dstr url_a;
+	dstr_init(&url_a);
+	dstr_printf(&url_a, "file://%s/a.bin", media.array);
+	struct dstr url_b;
+	dstr_init(&url_b);
+	dstr_printf(&url_b, "file://%s/b.bin", media.array);
+
+	/* the index claims the file name of b for another URL */
+	struct dstr taken;
+	dstr_init(&taken);
+	dstr_printf(&taken, "%s/%016llX.bin", dir, (unsigned long long)media_cache_hash(url_b.array));
+	cache_write(taken.array, "other");
+	obs_data_t *index = obs_data_create();
+	obs_data_array_t *entries = obs_data_array_create();
+	obs_data_t *e = obs_data_create();
+	obs_data_set_string(e, "url", "file:///elsewhere/other.bin");
+	obs_data_set_string(e, "file", taken.array);
+	obs_data_set_int(e, "size", 5);
+	obs_data_array_push_back(entries, e);
+	obs_data_release(e);
+	obs_data_set_array(index, "entries", entries);
+	obs_data_array_release(entries);
+	obs_data_save_json(index, path.array);
+	obs_data_release(index);
+
+	dstr_printf(&path, "%s/a.bin", media.array);
+	cache_write(path.array, "first");
+	dstr_printf(&path, "%s/b.bin", media.array);
+	cache_write(path.array, "second");
+
+	media_cache_init();
+	struct dstr checksum;
+	dstr_init(&checksum);
+
+#ifdef HAVE_CURL
+	cache_checksum("first", &checksum);
+	media_cache_request(url_a.array, checksum.array, 0);
+	char *file_a = cache_wait(url_a.array, checksum.array);
+	cache_check(cache_contains(file_a, "first"), "download through curl");
+
+	cache_checksum("second", &checksum);
+	media_cache_request(url_b.array, checksum.array, 0);
+	char *file_b = cache_wait(url_b.array, checksum.array);
+	cache_check(file_b && strcmp(file_b, taken.array) != 0 && cache_contains(file_b, "second"),
+		    "a file name taken by another URL is not reused");
+	cache_check(cache_contains(taken.array, "other"), "the file of the other URL is untouched");
+	media_cache_release(url_b.array);
+	bfree(file_b);
+
+	/* file_a is still pinned, the new version waits next to it */
+	dstr_printf(&path, "%s/a.bin", media.array);
+	cache_write(path.array, "changed");
+	cache_checksum("changed", &checksum);
+	media_cache_request(url_a.array, checksum.array, 0);
+	cache_check(cache_wait_pending(url_a.array), "a download replacing a pinned file is held back");
+	cache_check(cache_contains(file_a, "first"), "the pinned file is not overwritten");
+	char *early = media_cache_get(url_a.array, checksum.array);
+	cache_check(!early, "the new version is not handed out while the old one is pinned");
+	bfree(early);
+	media_cache_release(url_a.array);
+	char *swapped = media_cache_get(url_a.array, checksum.array);
+	cache_check(swapped && strcmp(swapped, file_a) == 0 && cache_contains(swapped, "changed"),
+		    "the new version replaces the file once unpinned");
+	media_cache_release(url_a.array);
+	bfree(swapped);
+	bfree(file_a);
+#else
+	printf("skipped: built without curl\n");
+#endif
+
+	media_cache_free();
+	dstr_free(&checksum);
+	dstr_free(&taken);
+	dstr_free(&url_b);
+	dstr_free(&url_a);
+	dstr_free(&media);
+	dstr_free(&path);
+	bfree(dir);
+	mock_obs_shutdown();
+	return cache_failed;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "../util/c99defs.h"
+
+/* Named values kept in a small table instead of the libobs stack encoding,
+ * calldata_init_fixed only skips freeing the table owner. */
+
+#define CALLDATA_MAX_VALUES 16
+
+enum calldata_value_type {
+	CALLDATA_NONE,
+	CALLDATA_INT,
+	CALLDATA_FLOAT,
+	CALLDATA_BOOL,
+	CALLDATA_PTR,
+	CALLDATA_STRING,
+};
+
+struct calldata_value {
+	char name[32];
+	enum calldata_value_type type;
+	long long i;
+	double f;
+	bool b;
+	void *ptr;
+	char *str;
+};
+
+struct calldata {
+	struct calldata_value values[CALLDATA_MAX_VALUES];
+	size_t num;
+	bool fixed;
+};
+
+typedef struct calldata calldata_t;
+
+void calldata_init(calldata_t *data);
+void calldata_init_fixed(calldata_t *data, uint8_t *stack, size_t size);
+void calldata_free(calldata_t *data);
+
+void calldata_set_int(calldata_t *data, const char *name, long long val);
+void calldata_set_float(calldata_t *data, const char *name, double val);
+void calldata_set_bool(calldata_t *data, const char *name, bool val);
+void calldata_set_ptr(calldata_t *data, const char *name, void *ptr);
+void calldata_set_string(calldata_t *data, const char *name, const char *str);
+
+long long calldata_int(const calldata_t *data, const char *name);
+double calldata_float(const calldata_t *data, const char *name);
+bool calldata_bool(const calldata_t *data, const char *name);
+void *calldata_ptr(const calldata_t *data, const char *name);
+const char *calldata_string(const calldata_t *data, const char *name);
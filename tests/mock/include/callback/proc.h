@@ -0,0 +1,10 @@
+#pragma once
+#include "calldata.h"
+
+typedef struct proc_handler proc_handler_t;
+typedef void (*proc_handler_proc_t)(void *data, calldata_t *cd);
+
+proc_handler_t *proc_handler_create(void);
+void proc_handler_destroy(proc_handler_t *handler);
+void proc_handler_add(proc_handler_t *handler, const char *decl_string, proc_handler_proc_t proc, void *data);
+bool proc_handler_call(proc_handler_t *handler, const char *name, calldata_t *params);
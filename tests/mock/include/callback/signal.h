@@ -0,0 +1,24 @@
+#pragma once
+#include "calldata.h"
+
+typedef struct signal_handler signal_handler_t;
+typedef void (*signal_callback_t)(void *data, calldata_t *cd);
+
+signal_handler_t *signal_handler_create(void);
+void signal_handler_destroy(signal_handler_t *handler);
+bool signal_handler_add(signal_handler_t *handler, const char *signal_decl);
+
+static inline bool signal_handler_add_array(signal_handler_t *handler, const char **signal_decls)
+{
+	bool success = true;
+	if (!signal_decls)
+		return false;
+	while (*signal_decls)
+		if (!signal_handler_add(handler, *(signal_decls++)))
+			success = false;
+	return success;
+}
+
+void signal_handler_connect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data);
+void signal_handler_disconnect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data);
+void signal_handler_signal(signal_handler_t *handler, const char *signal, calldata_t *params);
@@ -0,0 +1,65 @@
+#pragma once
+#include "../util/c99defs.h"
+#include "vec4.h"
+
+enum gs_color_format {
+	GS_UNKNOWN,
+	GS_A8,
+	GS_R8,
+	GS_RGBA,
+	GS_BGRX,
+	GS_BGRA,
+};
+
+enum gs_zstencil_format {
+	GS_ZS_NONE,
+	GS_Z16,
+	GS_Z24_S8,
+	GS_Z32F,
+	GS_Z32F_S8X24,
+};
+
+enum gs_blend_type {
+	GS_BLEND_ZERO,
+	GS_BLEND_ONE,
+	GS_BLEND_SRCCOLOR,
+	GS_BLEND_INVSRCCOLOR,
+	GS_BLEND_SRCALPHA,
+	GS_BLEND_INVSRCALPHA,
+	GS_BLEND_DSTCOLOR,
+	GS_BLEND_INVDSTCOLOR,
+	GS_BLEND_DSTALPHA,
+	GS_BLEND_INVDSTALPHA,
+	GS_BLEND_SRCALPHASAT,
+};
+
+#define GS_CLEAR_COLOR (1 << 0)
+#define GS_CLEAR_DEPTH (1 << 1)
+#define GS_CLEAR_STENCIL (1 << 2)
+
+typedef struct gs_texture gs_texture_t;
+typedef struct gs_texture_render gs_texrender_t;
+typedef struct gs_effect gs_effect_t;
+typedef struct gs_effect_param gs_eparam_t;
+
+gs_texrender_t *gs_texrender_create(enum gs_color_format format, enum gs_zstencil_format zsformat);
+void gs_texrender_destroy(gs_texrender_t *texrender);
+bool gs_texrender_begin(gs_texrender_t *texrender, uint32_t cx, uint32_t cy);
+void gs_texrender_end(gs_texrender_t *texrender);
+void gs_texrender_reset(gs_texrender_t *texrender);
+gs_texture_t *gs_texrender_get_texture(const gs_texrender_t *texrender);
+
+void gs_clear(uint32_t clear_flags, const struct vec4 *color, float depth, uint8_t stencil);
+void gs_ortho(float left, float right, float top, float bottom, float znear, float zfar);
+void gs_matrix_push(void);
+void gs_matrix_pop(void);
+void gs_matrix_scale3f(float x, float y, float z);
+void gs_matrix_translate3f(float x, float y, float z);
+void gs_blend_state_push(void);
+void gs_blend_state_pop(void);
+void gs_blend_function(enum gs_blend_type src, enum gs_blend_type dest);
+void gs_draw_sprite(gs_texture_t *tex, uint32_t flip, uint32_t width, uint32_t height);
+
+gs_eparam_t *gs_effect_get_param_by_name(const gs_effect_t *effect, const char *name);
+void gs_effect_set_texture(gs_eparam_t *param, gs_texture_t *val);
+bool gs_effect_loop(gs_effect_t *effect, const char *name);
@@ -0,0 +1,22 @@
+#pragma once
+#include <math.h>
+/* libobs pulls stdlib.h in through the SSE intrinsics headers */
+#include <stdlib.h>
+#include "../util/c99defs.h"
+
+struct vec4 {
+	float x, y, z, w;
+};
+
+static inline void vec4_zero(struct vec4 *v)
+{
+	v->x = v->y = v->z = v->w = 0.0f;
+}
+
+static inline void vec4_set(struct vec4 *dst, float x, float y, float z, float w)
+{
+	dst->x = x;
+	dst->y = y;
+	dst->z = z;
+	dst->w = w;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "obs.h"
+
+/* Control side of the mock libobs used by the benchmark and soak tests. Time
+ * only moves when the test advances it, os_gettime_ns returns the virtual
+ * clock, and the fake ffmpeg_source plays by that clock. */
+
+void mock_obs_startup(const char *config_dir);
+void mock_obs_shutdown(void);
+
+void mock_obs_set_fps(uint32_t fps_num, uint32_t fps_den);
+uint64_t mock_obs_frame_ns(void);
+void mock_obs_set_log_level(int level);
+
+uint64_t mock_obs_time(void);
+void mock_obs_advance(uint64_t ns);
+/* advances the clock by one frame and ticks every live source like obs does */
+void mock_obs_video_tick(void);
+/* wall time spent in the video_tick of one source during the last frame */
+void mock_obs_measure_tick(obs_source_t *source);
+uint64_t mock_obs_measured_tick_ns(void);
+
+obs_scene_t *mock_obs_create_scene(const char *name);
+
+/* fake ffmpeg_source */
+void mock_media_set_duration(const char *path, int64_t ms);
+void mock_media_set_default_duration(int64_t ms);
+void mock_media_set_open_frames(int frames);
+bool mock_media_is_fake(obs_source_t *source);
+const char *mock_media_get_path(obs_source_t *source);
+double mock_media_get_time_exact(obs_source_t *source);
+
+/* called for every playing fake decoder after its time moved on a tick */
+typedef void (*mock_media_tick_cb)(obs_source_t *source, double from_ms, double to_ms, void *param);
+void mock_media_set_tick_callback(mock_media_tick_cb callback, void *param);
@@ -0,0 +1,8 @@
+#pragma once
+#include "obs.h"
+
+obs_source_t *obs_frontend_get_current_scene(void);
+int obs_frontend_get_transition_duration(void);
+void obs_frontend_open_source_properties(obs_source_t *source);
+bool obs_frontend_preview_program_mode_active(void);
+void obs_frontend_preview_program_trigger_transition(void);
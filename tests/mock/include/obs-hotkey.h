@@ -0,0 +1,14 @@
+#pragma once
+#include "util/c99defs.h"
+
+typedef size_t obs_hotkey_id;
+typedef struct obs_hotkey obs_hotkey_t;
+
+#define OBS_INVALID_HOTKEY_ID (~(obs_hotkey_id)0)
+
+typedef void (*obs_hotkey_func)(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
+typedef bool (*obs_hotkey_enum_func)(void *data, obs_hotkey_id id, obs_hotkey_t *key);
+
+const char *obs_hotkey_get_name(const obs_hotkey_t *key);
+void obs_enum_hotkeys(obs_hotkey_enum_func func, void *data);
+void obs_hotkey_trigger_routed_callback(obs_hotkey_id id, bool pressed);
@@ -0,0 +1,18 @@
+#pragma once
+#include "obs.h"
+
+#define MODULE_EXPORT
+#define MODULE_EXTERN extern
+
+#define OBS_DECLARE_MODULE()                          \
+	const char *obs_module_text(const char *lookup); \
+	char *obs_module_config_path(const char *file);  \
+	bool obs_module_load(void);                      \
+	void obs_module_unload(void);                    \
+	void obs_module_post_load(void);
+
+#define OBS_MODULE_AUTHOR(name) extern int obs_module_author_unused
+#define OBS_MODULE_USE_DEFAULT_LOCALE(module_name, default_locale)
+
+const char *obs_module_text(const char *lookup);
+char *obs_module_config_path(const char *file);
@@ -0,0 +1,386 @@
+#pragma once
+#include "util/c99defs.h"
+#include "util/base.h"
+#include "util/bmem.h"
+#include "util/profiler.h"
+#include "callback/calldata.h"
+#include "callback/proc.h"
+#include "callback/signal.h"
+#include "graphics/graphics.h"
+#include "graphics/vec4.h"
+#include "obs-data.h"
+#include "obs-hotkey.h"
+
+/* Only the parts of the libobs API the plugin uses, with the same names and
+ * signatures so the plugin sources compile unchanged against this mock. */
+
+typedef struct obs_source obs_source_t;
+typedef struct obs_weak_source obs_weak_source_t;
+typedef struct obs_scene obs_scene_t;
+typedef struct obs_scene_item obs_sceneitem_t;
+typedef struct obs_properties obs_properties_t;
+typedef struct obs_property obs_property_t;
+typedef struct audio_output audio_t;
+
+#define MAX_AV_PLANES 8
+#define MAX_AUDIO_MIXES 6
+#define MAX_AUDIO_CHANNELS 8
+#define AUDIO_OUTPUT_FRAMES 1024
+
+enum audio_format {
+	AUDIO_FORMAT_UNKNOWN,
+	AUDIO_FORMAT_FLOAT_PLANAR = 8,
+};
+
+enum speaker_layout {
+	SPEAKERS_UNKNOWN,
+	SPEAKERS_MONO,
+	SPEAKERS_STEREO,
+};
+
+struct audio_data {
+	uint8_t *data[MAX_AV_PLANES];
+	uint32_t frames;
+	uint64_t timestamp;
+};
+
+struct audio_output_info {
+	const char *name;
+	uint32_t samples_per_sec;
+	enum audio_format format;
+	enum speaker_layout speakers;
+};
+
+typedef void (*audio_output_callback_t)(void *param, size_t mix_idx, struct audio_data *data);
+
+bool audio_output_connect(audio_t *audio, size_t mix_idx, const void *conversion, audio_output_callback_t callback,
+			  void *param);
+void audio_output_disconnect(audio_t *audio, size_t mix_idx, audio_output_callback_t callback, void *param);
+const struct audio_output_info *audio_output_get_info(const audio_t *audio);
+
+struct obs_source_audio {
+	const uint8_t *data[MAX_AV_PLANES];
+	uint32_t frames;
+	enum speaker_layout speakers;
+	enum audio_format format;
+	uint32_t samples_per_sec;
+	uint64_t timestamp;
+};
+
+struct audio_output_data {
+	float *data[MAX_AUDIO_CHANNELS];
+};
+
+struct obs_source_audio_mix {
+	struct audio_output_data output[MAX_AUDIO_MIXES];
+};
+
+struct obs_video_info {
+	const char *graphics_module;
+	uint32_t fps_num;
+	uint32_t fps_den;
+	uint32_t base_width;
+	uint32_t base_height;
+	uint32_t output_width;
+	uint32_t output_height;
+};
+
+enum obs_source_type {
+	OBS_SOURCE_TYPE_INPUT,
+	OBS_SOURCE_TYPE_FILTER,
+	OBS_SOURCE_TYPE_TRANSITION,
+	OBS_SOURCE_TYPE_SCENE,
+};
+
+enum obs_icon_type {
+	OBS_ICON_TYPE_UNKNOWN,
+	OBS_ICON_TYPE_IMAGE,
+	OBS_ICON_TYPE_COLOR,
+	OBS_ICON_TYPE_SLIDESHOW,
+	OBS_ICON_TYPE_AUDIO_INPUT,
+	OBS_ICON_TYPE_AUDIO_OUTPUT,
+	OBS_ICON_TYPE_DESKTOP_CAPTURE,
+	OBS_ICON_TYPE_WINDOW_CAPTURE,
+	OBS_ICON_TYPE_GAME_CAPTURE,
+	OBS_ICON_TYPE_CAMERA,
+	OBS_ICON_TYPE_TEXT,
+	OBS_ICON_TYPE_MEDIA,
+	OBS_ICON_TYPE_BROWSER,
+	OBS_ICON_TYPE_CUSTOM,
+};
+
+enum obs_media_state {
+	OBS_MEDIA_STATE_NONE,
+	OBS_MEDIA_STATE_PLAYING,
+	OBS_MEDIA_STATE_OPENING,
+	OBS_MEDIA_STATE_BUFFERING,
+	OBS_MEDIA_STATE_PAUSED,
+	OBS_MEDIA_STATE_STOPPED,
+	OBS_MEDIA_STATE_ENDED,
+	OBS_MEDIA_STATE_ERROR,
+};
+
+enum obs_transition_mode {
+	OBS_TRANSITION_MODE_AUTO,
+	OBS_TRANSITION_MODE_MANUAL,
+};
+
+enum obs_transition_scale_type {
+	OBS_TRANSITION_SCALE_MAX_ONLY,
+	OBS_TRANSITION_SCALE_ASPECT,
+	OBS_TRANSITION_SCALE_STRETCH,
+};
+
+enum obs_base_effect {
+	OBS_EFFECT_DEFAULT,
+	OBS_EFFECT_DEFAULT_RECT,
+	OBS_EFFECT_OPAQUE,
+	OBS_EFFECT_SOLID,
+};
+
+#define OBS_SOURCE_VIDEO (1 << 0)
+#define OBS_SOURCE_AUDIO (1 << 1)
+#define OBS_SOURCE_ASYNC (1 << 2)
+#define OBS_SOURCE_ASYNC_VIDEO (OBS_SOURCE_ASYNC | OBS_SOURCE_VIDEO)
+#define OBS_SOURCE_CUSTOM_DRAW (1 << 3)
+#define OBS_SOURCE_INTERACTION (1 << 5)
+#define OBS_SOURCE_COMPOSITE (1 << 6)
+#define OBS_SOURCE_DO_NOT_DUPLICATE (1 << 7)
+#define OBS_SOURCE_DEPRECATED (1 << 8)
+#define OBS_SOURCE_DO_NOT_SELF_MONITOR (1 << 9)
+#define OBS_SOURCE_CAP_DISABLED (1 << 10)
+#define OBS_SOURCE_MONITOR_BY_DEFAULT (1 << 11)
+#define OBS_SOURCE_SUBMIX (1 << 12)
+#define OBS_SOURCE_CONTROLLABLE_MEDIA (1 << 13)
+#define OBS_OUTPUT_VIDEO OBS_SOURCE_VIDEO
+
+typedef void (*obs_source_enum_proc_t)(obs_source_t *parent, obs_source_t *child, void *param);
+
+struct obs_source_info {
+	const char *id;
+	enum obs_source_type type;
+	uint32_t output_flags;
+	const char *(*get_name)(void *type_data);
+	void *(*create)(obs_data_t *settings, obs_source_t *source);
+	void (*destroy)(void *data);
+	uint32_t (*get_width)(void *data);
+	uint32_t (*get_height)(void *data);
+	void (*get_defaults)(obs_data_t *settings);
+	obs_properties_t *(*get_properties)(void *data);
+	void (*update)(void *data, obs_data_t *settings);
+	void (*activate)(void *data);
+	void (*deactivate)(void *data);
+	void (*show)(void *data);
+	void (*hide)(void *data);
+	void (*video_tick)(void *data, float seconds);
+	void (*video_render)(void *data, gs_effect_t *effect);
+	void (*enum_active_sources)(void *data, obs_source_enum_proc_t enum_callback, void *param);
+	void (*enum_all_sources)(void *data, obs_source_enum_proc_t enum_callback, void *param);
+	bool (*audio_render)(void *data, uint64_t *ts_out, struct obs_source_audio_mix *audio_output, uint32_t mixers,
+			     size_t channels, size_t sample_rate);
+	void *type_data;
+	void (*free_type_data)(void *type_data);
+	enum obs_icon_type icon_type;
+	void (*media_play_pause)(void *data, bool pause);
+	void (*media_restart)(void *data);
+	void (*media_stop)(void *data);
+	void (*media_next)(void *data);
+	void (*media_previous)(void *data);
+	int64_t (*media_get_duration)(void *data);
+	int64_t (*media_get_time)(void *data);
+	void (*media_set_time)(void *data, int64_t miliseconds);
+	enum obs_media_state (*media_get_state)(void *data);
+};
+
+void obs_register_source_s(const struct obs_source_info *info, size_t size);
+#define obs_register_source(info) obs_register_source_s(info, sizeof(struct obs_source_info))
+
+/* properties */
+
+enum obs_combo_type {
+	OBS_COMBO_TYPE_INVALID,
+	OBS_COMBO_TYPE_EDITABLE,
+	OBS_COMBO_TYPE_LIST,
+	OBS_COMBO_TYPE_RADIO,
+};
+
+enum obs_combo_format {
+	OBS_COMBO_FORMAT_INVALID,
+	OBS_COMBO_FORMAT_INT,
+	OBS_COMBO_FORMAT_FLOAT,
+	OBS_COMBO_FORMAT_STRING,
+	OBS_COMBO_FORMAT_BOOL,
+};
+
+enum obs_editable_list_type {
+	OBS_EDITABLE_LIST_TYPE_STRINGS,
+	OBS_EDITABLE_LIST_TYPE_FILES,
+	OBS_EDITABLE_LIST_TYPE_FILES_AND_URLS,
+};
+
+enum obs_path_type {
+	OBS_PATH_FILE,
+	OBS_PATH_FILE_SAVE,
+	OBS_PATH_DIRECTORY,
+};
+
+enum obs_text_type {
+	OBS_TEXT_DEFAULT,
+	OBS_TEXT_PASSWORD,
+	OBS_TEXT_MULTILINE,
+	OBS_TEXT_INFO,
+};
+
+enum obs_text_info_type {
+	OBS_TEXT_INFO_NORMAL,
+	OBS_TEXT_INFO_WARNING,
+	OBS_TEXT_INFO_ERROR,
+};
+
+enum obs_group_type {
+	OBS_COMBO_INVALID,
+	OBS_GROUP_NORMAL,
+	OBS_GROUP_CHECKABLE,
+};
+
+typedef bool (*obs_property_clicked_t)(obs_properties_t *props, obs_property_t *property, void *data);
+typedef bool (*obs_property_modified_t)(obs_properties_t *props, obs_property_t *property, obs_data_t *settings);
+
+obs_properties_t *obs_properties_create(void);
+void obs_properties_destroy(obs_properties_t *props);
+obs_property_t *obs_properties_get(obs_properties_t *props, const char *property);
+void obs_properties_remove_by_name(obs_properties_t *props, const char *property);
+obs_property_t *obs_properties_add_bool(obs_properties_t *props, const char *name, const char *description);
+obs_property_t *obs_properties_add_int(obs_properties_t *props, const char *name, const char *description, int min, int max,
+				       int step);
+obs_property_t *obs_properties_add_int_slider(obs_properties_t *props, const char *name, const char *description, int min,
+					      int max, int step);
+obs_property_t *obs_properties_add_float(obs_properties_t *props, const char *name, const char *description, double min,
+					 double max, double step);
+obs_property_t *obs_properties_add_float_slider(obs_properties_t *props, const char *name, const char *description,
+						double min, double max, double step);
+obs_property_t *obs_properties_add_text(obs_properties_t *props, const char *name, const char *description,
+					enum obs_text_type type);
+obs_property_t *obs_properties_add_path(obs_properties_t *props, const char *name, const char *description,
+					enum obs_path_type type, const char *filter, const char *default_path);
+obs_property_t *obs_properties_add_list(obs_properties_t *props, const char *name, const char *description,
+					enum obs_combo_type type, enum obs_combo_format format);
+obs_property_t *obs_properties_add_color_alpha(obs_properties_t *props, const char *name, const char *description);
+obs_property_t *obs_properties_add_button(obs_properties_t *props, const char *name, const char *text,
+					  obs_property_clicked_t callback);
+obs_property_t *obs_properties_add_button2(obs_properties_t *props, const char *name, const char *text,
+					   obs_property_clicked_t callback, void *priv);
+obs_property_t *obs_properties_add_editable_list(obs_properties_t *props, const char *name, const char *description,
+						 enum obs_editable_list_type type, const char *filter, const char *default_path);
+obs_property_t *obs_properties_add_group(obs_properties_t *props, const char *name, const char *description,
+					 enum obs_group_type type, obs_properties_t *group);
+const char *obs_property_name(obs_property_t *p);
+bool obs_property_visible(obs_property_t *p);
+void obs_property_set_visible(obs_property_t *p, bool visible);
+void obs_property_set_long_description(obs_property_t *p, const char *long_description);
+void obs_property_set_modified_callback(obs_property_t *p, obs_property_modified_t modified);
+void obs_property_int_set_suffix(obs_property_t *p, const char *suffix);
+void obs_property_float_set_suffix(obs_property_t *p, const char *suffix);
+void obs_property_text_set_info_type(obs_property_t *p, enum obs_text_info_type type);
+size_t obs_property_list_add_int(obs_property_t *p, const char *name, long long val);
+size_t obs_property_list_add_string(obs_property_t *p, const char *name, const char *val);
+
+/* sources */
+
+obs_source_t *obs_source_create(const char *id, const char *name, obs_data_t *settings, obs_data_t *hotkey_data);
+obs_source_t *obs_source_create_private(const char *id, const char *name, obs_data_t *settings);
+obs_source_t *obs_source_get_ref(obs_source_t *source);
+void obs_source_release(obs_source_t *source);
+obs_weak_source_t *obs_source_get_weak_source(obs_source_t *source);
+obs_source_t *obs_weak_source_get_source(obs_weak_source_t *weak);
+void obs_weak_source_addref(obs_weak_source_t *weak);
+void obs_weak_source_release(obs_weak_source_t *weak);
+bool obs_weak_source_expired(obs_weak_source_t *weak);
+bool obs_weak_source_references_source(obs_weak_source_t *weak, obs_source_t *source);
+void obs_source_remove(obs_source_t *source);
+
+obs_data_t *obs_source_get_settings(const obs_source_t *source);
+void obs_source_update(obs_source_t *source, obs_data_t *settings);
+void obs_source_update_properties(obs_source_t *source);
+obs_properties_t *obs_source_properties(const obs_source_t *source);
+const char *obs_source_get_name(const obs_source_t *source);
+const char *obs_source_get_id(const obs_source_t *source);
+const char *obs_source_get_unversioned_id(const obs_source_t *source);
+const char *obs_source_get_display_name(const char *id);
+uint32_t obs_source_get_width(obs_source_t *source);
+uint32_t obs_source_get_height(obs_source_t *source);
+bool obs_source_active(const obs_source_t *source);
+bool obs_source_showing(const obs_source_t *source);
+void obs_source_inc_showing(obs_source_t *source);
+void obs_source_dec_showing(obs_source_t *source);
+void obs_source_inc_active(obs_source_t *source);
+void obs_source_dec_active(obs_source_t *source);
+bool obs_source_add_active_child(obs_source_t *parent, obs_source_t *child);
+void obs_source_remove_active_child(obs_source_t *parent, obs_source_t *child);
+void obs_source_set_enabled(obs_source_t *source, bool enabled);
+bool obs_source_enabled(const obs_source_t *source);
+void obs_source_video_render(obs_source_t *source);
+void obs_source_video_tick(obs_source_t *source, float seconds);
+void obs_source_enum_active_sources(obs_source_t *source, obs_source_enum_proc_t enum_callback, void *param);
+void obs_source_enum_active_tree(obs_source_t *source, obs_source_enum_proc_t enum_callback, void *param);
+signal_handler_t *obs_source_get_signal_handler(const obs_source_t *source);
+proc_handler_t *obs_source_get_proc_handler(const obs_source_t *source);
+obs_source_t *obs_source_get_filter_by_name(obs_source_t *source, const char *name);
+void *obs_obj_get_data(void *obj);
+
+void obs_source_media_play_pause(obs_source_t *source, bool pause);
+void obs_source_media_restart(obs_source_t *source);
+void obs_source_media_stop(obs_source_t *source);
+void obs_source_media_next(obs_source_t *source);
+void obs_source_media_previous(obs_source_t *source);
+int64_t obs_source_media_get_duration(obs_source_t *source);
+int64_t obs_source_media_get_time(obs_source_t *source);
+void obs_source_media_set_time(obs_source_t *source, int64_t ms);
+enum obs_media_state obs_source_media_get_state(obs_source_t *source);
+void obs_source_media_started(obs_source_t *source);
+void obs_source_media_ended(obs_source_t *source);
+
+bool obs_source_audio_pending(const obs_source_t *source);
+void obs_source_get_audio_mix(const obs_source_t *source, struct obs_source_audio_mix *audio);
+uint64_t obs_source_get_audio_timestamp(const obs_source_t *source);
+void obs_source_output_audio(obs_source_t *source, const struct obs_source_audio *audio);
+
+obs_hotkey_id obs_hotkey_register_source(obs_source_t *source, const char *name, const char *description,
+					 obs_hotkey_func func, void *data);
+
+obs_source_t *obs_get_source_by_name(const char *name);
+void obs_enum_sources(bool (*enum_proc)(void *, obs_source_t *), void *param);
+void obs_enum_scenes(bool (*enum_proc)(void *, obs_source_t *), void *param);
+bool obs_enum_transition_types(size_t idx, const char **id);
+obs_source_t *obs_get_output_source(uint32_t channel);
+void obs_set_output_source(uint32_t channel, obs_source_t *source);
+
+/* transitions */
+
+obs_source_t *obs_transition_get_active_source(obs_source_t *transition);
+void obs_transition_set(obs_source_t *transition, obs_source_t *source);
+void obs_transition_set_size(obs_source_t *transition, uint32_t cx, uint32_t cy);
+void obs_transition_set_scale_type(obs_source_t *transition, enum obs_transition_scale_type type);
+bool obs_transition_start(obs_source_t *transition, enum obs_transition_mode mode, uint32_t duration_ms, obs_source_t *dest);
+void obs_transition_swap_begin(obs_source_t *tr_dest, obs_source_t *tr_source);
+void obs_transition_swap_end(obs_source_t *tr_dest, obs_source_t *tr_source);
+
+/* scenes */
+
+obs_scene_t *obs_scene_create(const char *name);
+void obs_scene_release(obs_scene_t *scene);
+obs_source_t *obs_scene_get_source(const obs_scene_t *scene);
+obs_scene_t *obs_scene_from_source(const obs_source_t *source);
+obs_sceneitem_t *obs_scene_add(obs_scene_t *scene, obs_source_t *source);
+obs_sceneitem_t *obs_scene_find_source_recursive(obs_scene_t *scene, const char *name);
+void obs_sceneitem_set_visible(obs_sceneitem_t *item, bool visible);
+bool obs_sceneitem_visible(const obs_sceneitem_t *item);
+
+/* core */
+
+bool obs_get_video_info(struct obs_video_info *ovi);
+uint64_t obs_get_video_frame_time(void);
+audio_t *obs_get_audio(void);
+void obs_enter_graphics(void);
+void obs_leave_graphics(void);
+gs_effect_t *obs_get_base_effect(enum obs_base_effect effect);
@@ -0,0 +1,12 @@
+#pragma once
+#include <stdarg.h>
+#include "c99defs.h"
+
+enum {
+	LOG_ERROR = 100,
+	LOG_WARNING = 200,
+	LOG_INFO = 300,
+	LOG_DEBUG = 400,
+};
+
+void blog(int log_level, const char *format, ...);
@@ -0,0 +1,8 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define UNUSED_PARAMETER(param) (void)param
+#define EXPORT
@@ -0,0 +1,4 @@
+#pragma once
+#include "c99defs.h"
+
+uint32_t calc_crc32(uint32_t crc, const void *buf, size_t size);
@@ -0,0 +1,39 @@
+#pragma once
+#include <stdarg.h>
+#include "bmem.h"
+
+struct dstr {
+	char *array;
+	size_t len;
+	size_t capacity;
+};
+
+static inline void dstr_init(struct dstr *dst)
+{
+	dst->array = NULL;
+	dst->len = 0;
+	dst->capacity = 0;
+}
+
+static inline bool dstr_is_empty(const struct dstr *str)
+{
+	return !str->array || !str->len || !*str->array;
+}
+
+void dstr_init_copy(struct dstr *dst, const char *src);
+void dstr_free(struct dstr *dst);
+void dstr_copy(struct dstr *dst, const char *array);
+void dstr_ncopy(struct dstr *dst, const char *array, size_t len);
+void dstr_cat(struct dstr *dst, const char *array);
+void dstr_ncat(struct dstr *dst, const char *array, size_t len);
+void dstr_cat_ch(struct dstr *dst, char ch);
+void dstr_printf(struct dstr *dst, const char *format, ...);
+void dstr_catf(struct dstr *dst, const char *format, ...);
+void dstr_vprintf(struct dstr *dst, const char *format, va_list args);
+void dstr_vcatf(struct dstr *dst, const char *format, va_list args);
+void dstr_resize(struct dstr *dst, size_t num);
+void dstr_replace(struct dstr *str, const char *find, const char *replace);
+void dstr_depad(struct dstr *dst);
+
+int astrcmpi(const char *str1, const char *str2);
+int astrcmpi_n(const char *str1, const char *str2, size_t n);
@@ -0,0 +1,10 @@
+#pragma once
+#include "c99defs.h"
+
+typedef struct os_process_pipe os_process_pipe_t;
+
+os_process_pipe_t *os_process_pipe_create(const char *cmd_line, const char *type);
+int os_process_pipe_destroy(os_process_pipe_t *pp);
+size_t os_process_pipe_read(os_process_pipe_t *pp, uint8_t *data, size_t len);
+size_t os_process_pipe_read_err(os_process_pipe_t *pp, uint8_t *data, size_t len);
+size_t os_process_pipe_write(os_process_pipe_t *pp, const uint8_t *data, size_t len);
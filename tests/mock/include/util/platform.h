@@ -0,0 +1,36 @@
+#pragma once
+#include <stdio.h>
+#include <sys/stat.h>
+#include "c99defs.h"
+
+FILE *os_fopen(const char *path, const char *mode);
+int64_t os_fgetsize(FILE *file);
+int64_t os_get_file_size(const char *path);
+bool os_file_exists(const char *path);
+char *os_quick_read_utf8_file(const char *path);
+bool os_quick_write_utf8_file(const char *path, const char *str, size_t len, bool marker);
+bool os_quick_write_utf8_file_safe(const char *path, const char *str, size_t len, bool marker, const char *temp_ext,
+				   const char *backup_ext);
+const char *os_get_path_extension(const char *path);
+char *os_generate_formatted_filename(const char *extension, bool space, const char *format);
+
+uint64_t os_gettime_ns(void);
+void os_sleep_ms(uint32_t duration);
+
+struct os_dirent {
+	char d_name[256];
+	bool directory;
+};
+
+typedef struct os_dir os_dir_t;
+
+os_dir_t *os_opendir(const char *path);
+struct os_dirent *os_readdir(os_dir_t *dir);
+void os_closedir(os_dir_t *dir);
+
+int os_unlink(const char *path);
+int os_rename(const char *old_path, const char *new_path);
+int os_mkdir(const char *path);
+int os_mkdirs(const char *path);
+
+#define os_stat stat
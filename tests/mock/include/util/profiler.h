@@ -0,0 +1,5 @@
+#pragma once
+#include "c99defs.h"
+
+void profile_start(const char *name);
+void profile_end(const char *name);
@@ -0,0 +1,338 @@
+#include <string.h>
+#include <callback/calldata.h>
+#include <callback/proc.h>
+#include <callback/signal.h>
+#include <obs-hotkey.h>
+#include <obs.h>
+#include <util/darray.h>
+#include <util/threading.h>
+#include "mock-internal.h"
+
+/* calldata */
+
+void calldata_init(calldata_t *data)
+{
+	memset(data, 0, sizeof(*data));
+}
+
+void calldata_init_fixed(calldata_t *data, uint8_t *stack, size_t size)
+{
+	UNUSED_PARAMETER(stack);
+	UNUSED_PARAMETER(size);
+	calldata_init(data);
+	data->fixed = true;
+}
+
+void calldata_free(calldata_t *data)
+{
+	for (size_t i = 0; i < data->num; i++)
+		bfree(data->values[i].str);
+	data->num = 0;
+}
+
+static struct calldata_value *calldata_find(const calldata_t *data, const char *name)
+{
+	for (size_t i = 0; i < data->num; i++) {
+		if (strcmp(data->values[i].name, name) == 0)
+			return (struct calldata_value *)&data->values[i];
+	}
+	return NULL;
+}
+
+static struct calldata_value *calldata_set(calldata_t *data, const char *name, enum calldata_value_type type)
+{
+	struct calldata_value *value = calldata_find(data, name);
+	if (!value) {
+		if (data->num == CALLDATA_MAX_VALUES)
+			return NULL;
+		value = &data->values[data->num++];
+		memset(value, 0, sizeof(*value));
+		strncpy(value->name, name, sizeof(value->name) - 1);
+	}
+	bfree(value->str);
+	value->str = NULL;
+	value->type = type;
+	return value;
+}
+
+void calldata_set_int(calldata_t *data, const char *name, long long val)
+{
+	struct calldata_value *value = calldata_set(data, name, CALLDATA_INT);
+	if (value)
+		value->i = val;
+}
+
+void calldata_set_float(calldata_t *data, const char *name, double val)
+{
+	struct calldata_value *value = calldata_set(data, name, CALLDATA_FLOAT);
+	if (value)
+		value->f = val;
+}
+
+void calldata_set_bool(calldata_t *data, const char *name, bool val)
+{
+	struct calldata_value *value = calldata_set(data, name, CALLDATA_BOOL);
+	if (value)
+		value->b = val;
+}
+
+void calldata_set_ptr(calldata_t *data, const char *name, void *ptr)
+{
+	struct calldata_value *value = calldata_set(data, name, CALLDATA_PTR);
+	if (value)
+		value->ptr = ptr;
+}
+
+/* strings set on a fixed calldata are kept until calldata_free like libobs
+ * keeps them on the caller stack */
+void calldata_set_string(calldata_t *data, const char *name, const char *str)
+{
+	struct calldata_value *value = calldata_set(data, name, CALLDATA_STRING);
+	if (value)
+		value->str = bstrdup(str);
+}
+
+long long calldata_int(const calldata_t *data, const char *name)
+{
+	struct calldata_value *value = calldata_find(data, name);
+	return value && value->type == CALLDATA_INT ? value->i : 0;
+}
+
+double calldata_float(const calldata_t *data, const char *name)
+{
+	struct calldata_value *value = calldata_find(data, name);
+	return value && value->type == CALLDATA_FLOAT ? value->f : 0.0;
+}
+
+bool calldata_bool(const calldata_t *data, const char *name)
+{
+	struct calldata_value *value = calldata_find(data, name);
+	return value && value->type == CALLDATA_BOOL ? value->b : false;
+}
+
+void *calldata_ptr(const calldata_t *data, const char *name)
+{
+	struct calldata_value *value = calldata_find(data, name);
+	return value && value->type == CALLDATA_PTR ? value->ptr : NULL;
+}
+
+const char *calldata_string(const calldata_t *data, const char *name)
+{
+	struct calldata_value *value = calldata_find(data, name);
+	return value && value->type == CALLDATA_STRING ? value->str : NULL;
+}
+
+/* signals */
+
+struct signal_callback {
+	char *signal;
+	signal_callback_t callback;
+	void *data;
+	bool removed;
+};
+
+struct signal_handler {
+	pthread_mutex_t mutex;
+	DARRAY(struct signal_callback) callbacks;
+	long signalling;
+};
+
+signal_handler_t *signal_handler_create(void)
+{
+	signal_handler_t *handler = bzalloc(sizeof(signal_handler_t));
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&handler->mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+	return handler;
+}
+
+void signal_handler_destroy(signal_handler_t *handler)
+{
+	if (!handler)
+		return;
+	for (size_t i = 0; i < handler->callbacks.num; i++)
+		bfree(handler->callbacks.array[i].signal);
+	da_free(handler->callbacks);
+	pthread_mutex_destroy(&handler->mutex);
+	bfree(handler);
+}
+
+bool signal_handler_add(signal_handler_t *handler, const char *signal_decl)
+{
+	UNUSED_PARAMETER(handler);
+	return signal_decl != NULL;
+}
+
+void signal_handler_connect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data)
+{
+	if (!handler)
+		return;
+	pthread_mutex_lock(&handler->mutex);
+	struct signal_callback *cb = da_push_back_new(handler->callbacks);
+	cb->signal = bstrdup(signal);
+	cb->callback = callback;
+	cb->data = data;
+	pthread_mutex_unlock(&handler->mutex);
+}
+
+static void signal_handler_compact(signal_handler_t *handler)
+{
+	for (size_t i = handler->callbacks.num; i > 0; i--) {
+		if (handler->callbacks.array[i - 1].removed) {
+			bfree(handler->callbacks.array[i - 1].signal);
+			da_erase(handler->callbacks, i - 1);
+		}
+	}
+}
+
+void signal_handler_disconnect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data)
+{
+	if (!handler)
+		return;
+	pthread_mutex_lock(&handler->mutex);
+	for (size_t i = 0; i < handler->callbacks.num; i++) {
+		struct signal_callback *cb = &handler->callbacks.array[i];
+		if (!cb->removed && cb->callback == callback && cb->data == data && strcmp(cb->signal, signal) == 0) {
+			cb->removed = true;
+			break;
+		}
+	}
+	if (!handler->signalling)
+		signal_handler_compact(handler);
+	pthread_mutex_unlock(&handler->mutex);
+}
+
+void signal_handler_signal(signal_handler_t *handler, const char *signal, calldata_t *params)
+{
+	if (!handler)
+		return;
+	pthread_mutex_lock(&handler->mutex);
+	handler->signalling++;
+	for (size_t i = 0; i < handler->callbacks.num; i++) {
+		struct signal_callback cb = handler->callbacks.array[i];
+		if (!cb.removed && strcmp(cb.signal, signal) == 0)
+			cb.callback(cb.data, params);
+	}
+	if (!--handler->signalling)
+		signal_handler_compact(handler);
+	pthread_mutex_unlock(&handler->mutex);
+}
+
+/* procs */
+
+struct proc_info {
+	char *name;
+	proc_handler_proc_t proc;
+	void *data;
+};
+
+struct proc_handler {
+	DARRAY(struct proc_info) procs;
+};
+
+proc_handler_t *proc_handler_create(void)
+{
+	return bzalloc(sizeof(proc_handler_t));
+}
+
+void proc_handler_destroy(proc_handler_t *handler)
+{
+	if (!handler)
+		return;
+	for (size_t i = 0; i < handler->procs.num; i++)
+		bfree(handler->procs.array[i].name);
+	da_free(handler->procs);
+	bfree(handler);
+}
+
+/* "void name(in int id)" is stored by name only */
+void proc_handler_add(proc_handler_t *handler, const char *decl_string, proc_handler_proc_t proc, void *data)
+{
+	const char *start = strchr(decl_string, ' ');
+	start = start ? start + 1 : decl_string;
+	const char *end = strchr(start, '(');
+	struct proc_info *info = da_push_back_new(handler->procs);
+	info->name = end ? bstrdup_n(start, (size_t)(end - start)) : bstrdup(start);
+	info->proc = proc;
+	info->data = data;
+}
+
+bool proc_handler_call(proc_handler_t *handler, const char *name, calldata_t *params)
+{
+	for (size_t i = 0; handler && i < handler->procs.num; i++) {
+		if (strcmp(handler->procs.array[i].name, name) == 0) {
+			handler->procs.array[i].proc(handler->procs.array[i].data, params);
+			return true;
+		}
+	}
+	return false;
+}
+
+/* hotkeys */
+
+struct obs_hotkey {
+	obs_hotkey_id id;
+	char *name;
+	obs_hotkey_func func;
+	void *data;
+	obs_source_t *source;
+};
+
+static DARRAY(struct obs_hotkey) hotkeys;
+static obs_hotkey_id next_hotkey_id;
+
+obs_hotkey_id obs_hotkey_register_source(obs_source_t *source, const char *name, const char *description,
+					 obs_hotkey_func func, void *data)
+{
+	UNUSED_PARAMETER(description);
+	struct obs_hotkey *hotkey = da_push_back_new(hotkeys);
+	hotkey->id = next_hotkey_id++;
+	hotkey->name = bstrdup(name);
+	hotkey->func = func;
+	hotkey->data = data;
+	hotkey->source = source;
+	return hotkey->id;
+}
+
+void mock_hotkeys_unregister_source(obs_source_t *source)
+{
+	for (size_t i = hotkeys.num; i > 0; i--) {
+		if (hotkeys.array[i - 1].source == source) {
+			bfree(hotkeys.array[i - 1].name);
+			da_erase(hotkeys, i - 1);
+		}
+	}
+}
+
+const char *obs_hotkey_get_name(const obs_hotkey_t *key)
+{
+	return key->name;
+}
+
+void obs_enum_hotkeys(obs_hotkey_enum_func func, void *data)
+{
+	for (size_t i = 0; i < hotkeys.num; i++) {
+		if (!func(data, hotkeys.array[i].id, &hotkeys.array[i]))
+			break;
+	}
+}
+
+void obs_hotkey_trigger_routed_callback(obs_hotkey_id id, bool pressed)
+{
+	for (size_t i = 0; i < hotkeys.num; i++) {
+		if (hotkeys.array[i].id == id) {
+			hotkeys.array[i].func(hotkeys.array[i].data, id, &hotkeys.array[i], pressed);
+			return;
+		}
+	}
+}
+
+void mock_callback_reset(void)
+{
+	for (size_t i = 0; i < hotkeys.num; i++)
+		bfree(hotkeys.array[i].name);
+	da_free(hotkeys);
+	next_hotkey_id = 0;
+}
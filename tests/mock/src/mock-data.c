@@ -0,0 +1,924 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <obs-data.h>
+#include <util/bmem.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+/* obs_data keeps items in insertion order like libobs, with a hash index on
+ * top so settings with thousands of items do not make the mock the bottleneck
+ * of a benchmark. Values are kept as user and default pairs. */
+
+struct mock_value {
+	enum obs_data_type type;
+	enum obs_data_number_type numtype;
+	long long i;
+	double d;
+	bool b;
+	char *s;
+	obs_data_t *obj;
+	obs_data_array_t *arr;
+};
+
+struct obs_data_item {
+	obs_data_t *parent;
+	char *name;
+	uint32_t hash;
+	size_t position;
+	bool has_user;
+	bool has_default;
+	struct mock_value user;
+	struct mock_value def;
+	struct obs_data_item *next_hash;
+};
+
+struct obs_data {
+	volatile long refs;
+	DARRAY(struct obs_data_item *) items;
+	struct obs_data_item **buckets;
+	size_t bucket_count;
+	char *json;
+};
+
+struct obs_data_array {
+	volatile long refs;
+	DARRAY(obs_data_t *) objects;
+};
+
+static uint32_t data_hash(const char *name)
+{
+	uint32_t hash = 2166136261u;
+	while (*name) {
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static void value_clear(struct mock_value *value)
+{
+	bfree(value->s);
+	obs_data_release(value->obj);
+	obs_data_array_release(value->arr);
+	memset(value, 0, sizeof(*value));
+}
+
+obs_data_t *obs_data_create(void)
+{
+	obs_data_t *data = bzalloc(sizeof(obs_data_t));
+	data->refs = 1;
+	return data;
+}
+
+void obs_data_addref(obs_data_t *data)
+{
+	if (data)
+		os_atomic_inc_long(&data->refs);
+}
+
+static void data_rehash(obs_data_t *data, size_t bucket_count)
+{
+	bfree(data->buckets);
+	data->bucket_count = bucket_count;
+	data->buckets = bzalloc(bucket_count * sizeof(struct obs_data_item *));
+	for (size_t i = 0; i < data->items.num; i++) {
+		struct obs_data_item *item = data->items.array[i];
+		size_t b = item->hash & (bucket_count - 1);
+		item->next_hash = data->buckets[b];
+		data->buckets[b] = item;
+	}
+}
+
+static struct obs_data_item *data_find(obs_data_t *data, const char *name)
+{
+	if (!data || !name || !data->bucket_count)
+		return NULL;
+	uint32_t hash = data_hash(name);
+	for (struct obs_data_item *item = data->buckets[hash & (data->bucket_count - 1)]; item; item = item->next_hash) {
+		if (item->hash == hash && strcmp(item->name, name) == 0)
+			return item;
+	}
+	return NULL;
+}
+
+static struct obs_data_item *data_get_or_add(obs_data_t *data, const char *name)
+{
+	struct obs_data_item *item = data_find(data, name);
+	if (item)
+		return item;
+	item = bzalloc(sizeof(struct obs_data_item));
+	item->parent = data;
+	item->name = bstrdup(name);
+	item->hash = data_hash(name);
+	item->position = data->items.num;
+	da_push_back(data->items, &item);
+	if (data->items.num > data->bucket_count) {
+		data_rehash(data, data->bucket_count ? data->bucket_count * 4 : 16);
+	} else {
+		size_t b = item->hash & (data->bucket_count - 1);
+		item->next_hash = data->buckets[b];
+		data->buckets[b] = item;
+	}
+	return item;
+}
+
+static void data_remove(obs_data_t *data, struct obs_data_item *item)
+{
+	struct obs_data_item **link = &data->buckets[item->hash & (data->bucket_count - 1)];
+	while (*link != item)
+		link = &(*link)->next_hash;
+	*link = item->next_hash;
+	da_erase(data->items, item->position);
+	for (size_t i = item->position; i < data->items.num; i++)
+		data->items.array[i]->position = i;
+	value_clear(&item->user);
+	value_clear(&item->def);
+	bfree(item->name);
+	bfree(item);
+}
+
+void obs_data_clear(obs_data_t *data)
+{
+	if (!data)
+		return;
+	for (size_t i = 0; i < data->items.num; i++) {
+		struct obs_data_item *item = data->items.array[i];
+		value_clear(&item->user);
+		value_clear(&item->def);
+		bfree(item->name);
+		bfree(item);
+	}
+	da_free(data->items);
+	bfree(data->buckets);
+	data->buckets = NULL;
+	data->bucket_count = 0;
+}
+
+void obs_data_release(obs_data_t *data)
+{
+	if (!data || os_atomic_dec_long(&data->refs) != 0)
+		return;
+	obs_data_clear(data);
+	bfree(data->json);
+	bfree(data);
+}
+
+void obs_data_erase(obs_data_t *data, const char *name)
+{
+	struct obs_data_item *item = data_find(data, name);
+	if (item)
+		data_remove(data, item);
+}
+
+static struct mock_value *data_set(obs_data_t *data, const char *name, enum obs_data_type type, bool def)
+{
+	if (!data || !name)
+		return NULL;
+	struct obs_data_item *item = data_get_or_add(data, name);
+	struct mock_value *value = def ? &item->def : &item->user;
+	value_clear(value);
+	value->type = type;
+	if (def)
+		item->has_default = true;
+	else
+		item->has_user = true;
+	return value;
+}
+
+static const struct mock_value *item_value(const struct obs_data_item *item)
+{
+	if (!item)
+		return NULL;
+	if (item->has_user)
+		return &item->user;
+	if (item->has_default)
+		return &item->def;
+	return NULL;
+}
+
+static void set_string(obs_data_t *data, const char *name, const char *val, bool def)
+{
+	struct mock_value *value = data_set(data, name, OBS_DATA_STRING, def);
+	if (value)
+		value->s = bstrdup(val ? val : "");
+}
+
+static void set_int(obs_data_t *data, const char *name, long long val, bool def)
+{
+	struct mock_value *value = data_set(data, name, OBS_DATA_NUMBER, def);
+	if (value) {
+		value->numtype = OBS_DATA_NUM_INT;
+		value->i = val;
+	}
+}
+
+static void set_double(obs_data_t *data, const char *name, double val, bool def)
+{
+	struct mock_value *value = data_set(data, name, OBS_DATA_NUMBER, def);
+	if (value) {
+		value->numtype = OBS_DATA_NUM_DOUBLE;
+		value->d = val;
+	}
+}
+
+static void set_bool(obs_data_t *data, const char *name, bool val, bool def)
+{
+	struct mock_value *value = data_set(data, name, OBS_DATA_BOOLEAN, def);
+	if (value)
+		value->b = val;
+}
+
+static void set_obj(obs_data_t *data, const char *name, obs_data_t *obj, bool def)
+{
+	obs_data_addref(obj);
+	struct mock_value *value = data_set(data, name, OBS_DATA_OBJECT, def);
+	if (value)
+		value->obj = obj;
+	else
+		obs_data_release(obj);
+}
+
+void obs_data_set_string(obs_data_t *data, const char *name, const char *val)
+{
+	set_string(data, name, val, false);
+}
+
+void obs_data_set_int(obs_data_t *data, const char *name, long long val)
+{
+	set_int(data, name, val, false);
+}
+
+void obs_data_set_double(obs_data_t *data, const char *name, double val)
+{
+	set_double(data, name, val, false);
+}
+
+void obs_data_set_bool(obs_data_t *data, const char *name, bool val)
+{
+	set_bool(data, name, val, false);
+}
+
+void obs_data_set_obj(obs_data_t *data, const char *name, obs_data_t *obj)
+{
+	set_obj(data, name, obj, false);
+}
+
+void obs_data_set_array(obs_data_t *data, const char *name, obs_data_array_t *array)
+{
+	obs_data_array_addref(array);
+	struct mock_value *value = data_set(data, name, OBS_DATA_ARRAY, false);
+	if (value)
+		value->arr = array;
+	else
+		obs_data_array_release(array);
+}
+
+void obs_data_set_default_string(obs_data_t *data, const char *name, const char *val)
+{
+	set_string(data, name, val, true);
+}
+
+void obs_data_set_default_int(obs_data_t *data, const char *name, long long val)
+{
+	set_int(data, name, val, true);
+}
+
+void obs_data_set_default_double(obs_data_t *data, const char *name, double val)
+{
+	set_double(data, name, val, true);
+}
+
+void obs_data_set_default_bool(obs_data_t *data, const char *name, bool val)
+{
+	set_bool(data, name, val, true);
+}
+
+void obs_data_set_default_obj(obs_data_t *data, const char *name, obs_data_t *obj)
+{
+	set_obj(data, name, obj, true);
+}
+
+static const char *value_string(const struct mock_value *value)
+{
+	return value && value->type == OBS_DATA_STRING && value->s ? value->s : "";
+}
+
+static long long value_int(const struct mock_value *value)
+{
+	if (!value || value->type != OBS_DATA_NUMBER)
+		return 0;
+	return value->numtype == OBS_DATA_NUM_INT ? value->i : (long long)value->d;
+}
+
+static double value_double(const struct mock_value *value)
+{
+	if (!value || value->type != OBS_DATA_NUMBER)
+		return 0.0;
+	return value->numtype == OBS_DATA_NUM_INT ? (double)value->i : value->d;
+}
+
+static bool value_bool(const struct mock_value *value)
+{
+	return value && value->type == OBS_DATA_BOOLEAN ? value->b : false;
+}
+
+static obs_data_t *value_obj(const struct mock_value *value)
+{
+	if (!value || value->type != OBS_DATA_OBJECT || !value->obj)
+		return NULL;
+	obs_data_addref(value->obj);
+	return value->obj;
+}
+
+static obs_data_array_t *value_array(const struct mock_value *value)
+{
+	if (!value || value->type != OBS_DATA_ARRAY || !value->arr)
+		return NULL;
+	obs_data_array_addref(value->arr);
+	return value->arr;
+}
+
+const char *obs_data_get_string(obs_data_t *data, const char *name)
+{
+	return value_string(item_value(data_find(data, name)));
+}
+
+long long obs_data_get_int(obs_data_t *data, const char *name)
+{
+	return value_int(item_value(data_find(data, name)));
+}
+
+double obs_data_get_double(obs_data_t *data, const char *name)
+{
+	return value_double(item_value(data_find(data, name)));
+}
+
+bool obs_data_get_bool(obs_data_t *data, const char *name)
+{
+	return value_bool(item_value(data_find(data, name)));
+}
+
+obs_data_t *obs_data_get_obj(obs_data_t *data, const char *name)
+{
+	return value_obj(item_value(data_find(data, name)));
+}
+
+obs_data_array_t *obs_data_get_array(obs_data_t *data, const char *name)
+{
+	return value_array(item_value(data_find(data, name)));
+}
+
+bool obs_data_has_user_value(obs_data_t *data, const char *name)
+{
+	struct obs_data_item *item = data_find(data, name);
+	return item && item->has_user;
+}
+
+bool obs_data_has_default_value(obs_data_t *data, const char *name)
+{
+	struct obs_data_item *item = data_find(data, name);
+	return item && item->has_default;
+}
+
+void obs_data_unset_user_value(obs_data_t *data, const char *name)
+{
+	struct obs_data_item *item = data_find(data, name);
+	if (!item)
+		return;
+	value_clear(&item->user);
+	item->has_user = false;
+	if (!item->has_default)
+		data_remove(data, item);
+}
+
+static void value_copy(struct mock_value *dst, const struct mock_value *src)
+{
+	*dst = *src;
+	dst->s = bstrdup(src->s);
+	obs_data_addref(dst->obj);
+	obs_data_array_addref(dst->arr);
+}
+
+void obs_data_apply(obs_data_t *target, obs_data_t *apply_data)
+{
+	if (!target || !apply_data || target == apply_data)
+		return;
+	for (size_t i = 0; i < apply_data->items.num; i++) {
+		struct obs_data_item *src = apply_data->items.array[i];
+		if (!src->has_user)
+			continue;
+		struct mock_value *value = data_set(target, src->name, src->user.type, false);
+		value_copy(value, &src->user);
+	}
+}
+
+/* arrays */
+
+obs_data_array_t *obs_data_array_create(void)
+{
+	obs_data_array_t *array = bzalloc(sizeof(obs_data_array_t));
+	array->refs = 1;
+	return array;
+}
+
+void obs_data_array_addref(obs_data_array_t *array)
+{
+	if (array)
+		os_atomic_inc_long(&array->refs);
+}
+
+void obs_data_array_release(obs_data_array_t *array)
+{
+	if (!array || os_atomic_dec_long(&array->refs) != 0)
+		return;
+	for (size_t i = 0; i < array->objects.num; i++)
+		obs_data_release(array->objects.array[i]);
+	da_free(array->objects);
+	bfree(array);
+}
+
+size_t obs_data_array_count(obs_data_array_t *array)
+{
+	return array ? array->objects.num : 0;
+}
+
+obs_data_t *obs_data_array_item(obs_data_array_t *array, size_t idx)
+{
+	if (!array || idx >= array->objects.num)
+		return NULL;
+	obs_data_addref(array->objects.array[idx]);
+	return array->objects.array[idx];
+}
+
+size_t obs_data_array_push_back(obs_data_array_t *array, obs_data_t *obj)
+{
+	if (!array || !obj)
+		return 0;
+	obs_data_addref(obj);
+	return da_push_back(array->objects, &obj);
+}
+
+void obs_data_array_erase(obs_data_array_t *array, size_t idx)
+{
+	if (!array || idx >= array->objects.num)
+		return;
+	obs_data_release(array->objects.array[idx]);
+	da_erase(array->objects, idx);
+}
+
+/* item iteration */
+
+obs_data_item_t *obs_data_first(obs_data_t *data)
+{
+	return data && data->items.num ? data->items.array[0] : NULL;
+}
+
+obs_data_item_t *obs_data_item_byname(obs_data_t *data, const char *name)
+{
+	return data_find(data, name);
+}
+
+bool obs_data_item_next(obs_data_item_t **item)
+{
+	if (!item || !*item)
+		return false;
+	obs_data_t *data = (*item)->parent;
+	size_t next = (*item)->position + 1;
+	*item = next < data->items.num ? data->items.array[next] : NULL;
+	return *item != NULL;
+}
+
+void obs_data_item_release(obs_data_item_t **item)
+{
+	if (item)
+		*item = NULL;
+}
+
+const char *obs_data_item_get_name(obs_data_item_t *item)
+{
+	return item ? item->name : NULL;
+}
+
+enum obs_data_type obs_data_item_gettype(obs_data_item_t *item)
+{
+	const struct mock_value *value = item_value(item);
+	return value ? value->type : OBS_DATA_NULL;
+}
+
+enum obs_data_number_type obs_data_item_numtype(obs_data_item_t *item)
+{
+	const struct mock_value *value = item_value(item);
+	return value && value->type == OBS_DATA_NUMBER ? value->numtype : OBS_DATA_NUM_INVALID;
+}
+
+const char *obs_data_item_get_string(obs_data_item_t *item)
+{
+	return value_string(item_value(item));
+}
+
+long long obs_data_item_get_int(obs_data_item_t *item)
+{
+	return value_int(item_value(item));
+}
+
+double obs_data_item_get_double(obs_data_item_t *item)
+{
+	return value_double(item_value(item));
+}
+
+bool obs_data_item_get_bool(obs_data_item_t *item)
+{
+	return value_bool(item_value(item));
+}
+
+obs_data_t *obs_data_item_get_obj(obs_data_item_t *item)
+{
+	return value_obj(item_value(item));
+}
+
+obs_data_array_t *obs_data_item_get_array(obs_data_item_t *item)
+{
+	return value_array(item_value(item));
+}
+
+/* json */
+
+struct json_parser {
+	const char *p;
+	bool error;
+};
+
+static void json_skip(struct json_parser *parser)
+{
+	while (*parser->p == ' ' || *parser->p == '\t' || *parser->p == '\r' || *parser->p == '\n')
+		parser->p++;
+}
+
+static void json_utf8(struct dstr *out, uint32_t cp)
+{
+	if (cp < 0x80) {
+		dstr_cat_ch(out, (char)cp);
+	} else if (cp < 0x800) {
+		dstr_cat_ch(out, (char)(0xC0 | (cp >> 6)));
+		dstr_cat_ch(out, (char)(0x80 | (cp & 0x3F)));
+	} else if (cp < 0x10000) {
+		dstr_cat_ch(out, (char)(0xE0 | (cp >> 12)));
+		dstr_cat_ch(out, (char)(0x80 | ((cp >> 6) & 0x3F)));
+		dstr_cat_ch(out, (char)(0x80 | (cp & 0x3F)));
+	} else {
+		dstr_cat_ch(out, (char)(0xF0 | (cp >> 18)));
+		dstr_cat_ch(out, (char)(0x80 | ((cp >> 12) & 0x3F)));
+		dstr_cat_ch(out, (char)(0x80 | ((cp >> 6) & 0x3F)));
+		dstr_cat_ch(out, (char)(0x80 | (cp & 0x3F)));
+	}
+}
+
+static uint32_t json_hex4(struct json_parser *parser)
+{
+	uint32_t cp = 0;
+	for (int i = 0; i < 4; i++) {
+		char c = *parser->p;
+		cp <<= 4;
+		if (c >= '0' && c <= '9')
+			cp |= (uint32_t)(c - '0');
+		else if (c >= 'a' && c <= 'f')
+			cp |= (uint32_t)(c - 'a' + 10);
+		else if (c >= 'A' && c <= 'F')
+			cp |= (uint32_t)(c - 'A' + 10);
+		else {
+			parser->error = true;
+			return 0;
+		}
+		parser->p++;
+	}
+	return cp;
+}
+
+static char *json_string(struct json_parser *parser)
+{
+	if (*parser->p != '"') {
+		parser->error = true;
+		return NULL;
+	}
+	parser->p++;
+	struct dstr out;
+	dstr_init(&out);
+	while (*parser->p && *parser->p != '"') {
+		if (*parser->p != '\\') {
+			dstr_cat_ch(&out, *parser->p++);
+			continue;
+		}
+		parser->p++;
+		char c = *parser->p++;
+		switch (c) {
+		case 'n':
+			dstr_cat_ch(&out, '\n');
+			break;
+		case 't':
+			dstr_cat_ch(&out, '\t');
+			break;
+		case 'r':
+			dstr_cat_ch(&out, '\r');
+			break;
+		case 'b':
+			dstr_cat_ch(&out, '\b');
+			break;
+		case 'f':
+			dstr_cat_ch(&out, '\f');
+			break;
+		case 'u': {
+			uint32_t cp = json_hex4(parser);
+			if (cp >= 0xD800 && cp < 0xDC00 && parser->p[0] == '\\' && parser->p[1] == 'u') {
+				parser->p += 2;
+				uint32_t low = json_hex4(parser);
+				cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+			}
+			json_utf8(&out, cp);
+			break;
+		}
+		case 0:
+			parser->error = true;
+			parser->p--;
+			break;
+		default:
+			dstr_cat_ch(&out, c);
+		}
+	}
+	if (*parser->p != '"') {
+		parser->error = true;
+		dstr_free(&out);
+		return NULL;
+	}
+	parser->p++;
+	return out.array ? out.array : bstrdup("");
+}
+
+static obs_data_t *json_object(struct json_parser *parser);
+
+static obs_data_array_t *json_array(struct json_parser *parser)
+{
+	parser->p++;
+	obs_data_array_t *array = obs_data_array_create();
+	json_skip(parser);
+	if (*parser->p == ']') {
+		parser->p++;
+		return array;
+	}
+	while (!parser->error) {
+		json_skip(parser);
+		if (*parser->p == '{') {
+			obs_data_t *obj = json_object(parser);
+			obs_data_array_push_back(array, obj);
+			obs_data_release(obj);
+		} else {
+			/* obs_data arrays only hold objects, other values are skipped */
+			while (*parser->p && *parser->p != ',' && *parser->p != ']')
+				parser->p++;
+		}
+		json_skip(parser);
+		if (*parser->p == ',') {
+			parser->p++;
+			continue;
+		}
+		if (*parser->p == ']') {
+			parser->p++;
+			break;
+		}
+		parser->error = true;
+	}
+	return array;
+}
+
+static void json_value(struct json_parser *parser, obs_data_t *data, const char *name)
+{
+	json_skip(parser);
+	char c = *parser->p;
+	if (c == '"') {
+		char *str = json_string(parser);
+		if (str)
+			obs_data_set_string(data, name, str);
+		bfree(str);
+	} else if (c == '{') {
+		obs_data_t *obj = json_object(parser);
+		obs_data_set_obj(data, name, obj);
+		obs_data_release(obj);
+	} else if (c == '[') {
+		obs_data_array_t *array = json_array(parser);
+		obs_data_set_array(data, name, array);
+		obs_data_array_release(array);
+	} else if (strncmp(parser->p, "true", 4) == 0) {
+		parser->p += 4;
+		obs_data_set_bool(data, name, true);
+	} else if (strncmp(parser->p, "false", 5) == 0) {
+		parser->p += 5;
+		obs_data_set_bool(data, name, false);
+	} else if (strncmp(parser->p, "null", 4) == 0) {
+		parser->p += 4;
+	} else if (c == '-' || (c >= '0' && c <= '9')) {
+		const char *start = parser->p;
+		bool is_double = false;
+		parser->p++;
+		while ((*parser->p >= '0' && *parser->p <= '9') || *parser->p == '.' || *parser->p == 'e' || *parser->p == 'E' ||
+		       *parser->p == '+' || *parser->p == '-') {
+			if (*parser->p == '.' || *parser->p == 'e' || *parser->p == 'E')
+				is_double = true;
+			parser->p++;
+		}
+		if (is_double)
+			obs_data_set_double(data, name, strtod(start, NULL));
+		else
+			obs_data_set_int(data, name, strtoll(start, NULL, 10));
+	} else {
+		parser->error = true;
+	}
+}
+
+static obs_data_t *json_object(struct json_parser *parser)
+{
+	obs_data_t *data = obs_data_create();
+	json_skip(parser);
+	if (*parser->p != '{') {
+		parser->error = true;
+		return data;
+	}
+	parser->p++;
+	json_skip(parser);
+	if (*parser->p == '}') {
+		parser->p++;
+		return data;
+	}
+	while (!parser->error) {
+		json_skip(parser);
+		char *name = json_string(parser);
+		if (!name)
+			break;
+		json_skip(parser);
+		if (*parser->p != ':') {
+			parser->error = true;
+			bfree(name);
+			break;
+		}
+		parser->p++;
+		json_value(parser, data, name);
+		bfree(name);
+		json_skip(parser);
+		if (*parser->p == ',') {
+			parser->p++;
+			continue;
+		}
+		if (*parser->p == '}') {
+			parser->p++;
+			break;
+		}
+		parser->error = true;
+	}
+	return data;
+}
+
+obs_data_t *obs_data_create_from_json(const char *json_string)
+{
+	if (!json_string)
+		return NULL;
+	struct json_parser parser = {json_string, false};
+	obs_data_t *data = json_object(&parser);
+	if (parser.error) {
+		obs_data_release(data);
+		return NULL;
+	}
+	return data;
+}
+
+obs_data_t *obs_data_create_from_json_file(const char *json_file)
+{
+	char *file_data = os_quick_read_utf8_file(json_file);
+	obs_data_t *data = file_data ? obs_data_create_from_json(file_data) : NULL;
+	bfree(file_data);
+	return data;
+}
+
+obs_data_t *obs_data_create_from_json_file_safe(const char *json_file, const char *backup_ext)
+{
+	obs_data_t *data = obs_data_create_from_json_file(json_file);
+	if (!data && backup_ext && *backup_ext) {
+		struct dstr backup;
+		dstr_init_copy(&backup, json_file);
+		if (*backup_ext != '.')
+			dstr_cat_ch(&backup, '.');
+		dstr_cat(&backup, backup_ext);
+		data = obs_data_create_from_json_file(backup.array);
+		dstr_free(&backup);
+	}
+	return data;
+}
+
+static void json_write_string(struct dstr *out, const char *str)
+{
+	dstr_cat_ch(out, '"');
+	for (const char *p = str ? str : ""; *p; p++) {
+		switch (*p) {
+		case '"':
+			dstr_cat(out, "\\\"");
+			break;
+		case '\\':
+			dstr_cat(out, "\\\\");
+			break;
+		case '\n':
+			dstr_cat(out, "\\n");
+			break;
+		case '\r':
+			dstr_cat(out, "\\r");
+			break;
+		case '\t':
+			dstr_cat(out, "\\t");
+			break;
+		default:
+			if ((uint8_t)*p < 0x20)
+				dstr_catf(out, "\\u%04x", (uint8_t)*p);
+			else
+				dstr_cat_ch(out, *p);
+		}
+	}
+	dstr_cat_ch(out, '"');
+}
+
+static void json_write_object(struct dstr *out, obs_data_t *data);
+
+static void json_write_value(struct dstr *out, const struct mock_value *value)
+{
+	switch (value->type) {
+	case OBS_DATA_STRING:
+		json_write_string(out, value->s);
+		break;
+	case OBS_DATA_NUMBER:
+		if (value->numtype == OBS_DATA_NUM_INT)
+			dstr_catf(out, "%lld", value->i);
+		else
+			dstr_catf(out, "%.17g", value->d);
+		break;
+	case OBS_DATA_BOOLEAN:
+		dstr_cat(out, value->b ? "true" : "false");
+		break;
+	case OBS_DATA_OBJECT:
+		if (value->obj)
+			json_write_object(out, value->obj);
+		else
+			dstr_cat(out, "null");
+		break;
+	case OBS_DATA_ARRAY:
+		dstr_cat_ch(out, '[');
+		for (size_t i = 0; value->arr && i < value->arr->objects.num; i++) {
+			if (i)
+				dstr_cat_ch(out, ',');
+			json_write_object(out, value->arr->objects.array[i]);
+		}
+		dstr_cat_ch(out, ']');
+		break;
+	default:
+		dstr_cat(out, "null");
+	}
+}
+
+static void json_write_object(struct dstr *out, obs_data_t *data)
+{
+	dstr_cat_ch(out, '{');
+	bool first = true;
+	for (size_t i = 0; i < data->items.num; i++) {
+		struct obs_data_item *item = data->items.array[i];
+		if (!item->has_user)
+			continue;
+		if (!first)
+			dstr_cat_ch(out, ',');
+		first = false;
+		json_write_string(out, item->name);
+		dstr_cat_ch(out, ':');
+		json_write_value(out, &item->user);
+	}
+	dstr_cat_ch(out, '}');
+}
+
+const char *obs_data_get_json(obs_data_t *data)
+{
+	if (!data)
+		return NULL;
+	struct dstr out;
+	dstr_init(&out);
+	json_write_object(&out, data);
+	bfree(data->json);
+	data->json = out.array;
+	return data->json;
+}
+
+bool obs_data_save_json(obs_data_t *data, const char *file)
+{
+	const char *json = obs_data_get_json(data);
+	return json && os_quick_write_utf8_file(file, json, strlen(json), false);
+}
+
+bool obs_data_save_json_safe(obs_data_t *data, const char *file, const char *temp_ext, const char *backup_ext)
+{
+	const char *json = obs_data_get_json(data);
+	return json && os_quick_write_utf8_file_safe(file, json, strlen(json), false, temp_ext, backup_ext);
+}
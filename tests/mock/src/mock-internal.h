@@ -0,0 +1,7 @@
+#pragma once
+#include <mock-obs.h>
+
+void mock_callback_reset(void);
+void mock_hotkeys_unregister_source(obs_source_t *source);
+void mock_fake_types_register(void);
+void mock_media_reset(void);
@@ -0,0 +1,338 @@
+#include <string.h>
+#include <obs-module.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+#include "mock-internal.h"
+
+/* A decoder that plays by the virtual clock. Opening takes a few frames, the
+ * size stays 0 until the first frame like ffmpeg_source, and the end of the
+ * file signals media_ended. Durations come from mock_media_set_duration. */
+
+struct media_duration {
+	char *path;
+	int64_t ms;
+};
+
+static DARRAY(struct media_duration) durations;
+static int64_t default_duration = 10000;
+static int open_frames = 2;
+static mock_media_tick_cb tick_callback;
+static void *tick_param;
+
+struct fake_media {
+	obs_source_t *source;
+	char *path;
+	int64_t duration;
+	double time;
+	double speed;
+	enum obs_media_state state;
+	int opening;
+	bool has_frame;
+};
+
+void mock_media_set_duration(const char *path, int64_t ms)
+{
+	for (size_t i = 0; i < durations.num; i++) {
+		if (strcmp(durations.array[i].path, path) == 0) {
+			durations.array[i].ms = ms;
+			return;
+		}
+	}
+	struct media_duration *d = da_push_back_new(durations);
+	d->path = bstrdup(path);
+	d->ms = ms;
+}
+
+void mock_media_set_default_duration(int64_t ms)
+{
+	default_duration = ms;
+}
+
+void mock_media_set_open_frames(int frames)
+{
+	open_frames = frames;
+}
+
+void mock_media_set_tick_callback(mock_media_tick_cb callback, void *param)
+{
+	tick_callback = callback;
+	tick_param = param;
+}
+
+static int64_t media_duration(const char *path)
+{
+	for (size_t i = 0; path && i < durations.num; i++) {
+		if (strcmp(durations.array[i].path, path) == 0)
+			return durations.array[i].ms;
+	}
+	return default_duration;
+}
+
+static const char *fake_ffmpeg_get_name(void *type_data)
+{
+	UNUSED_PARAMETER(type_data);
+	return "Media Source";
+}
+
+static void fake_ffmpeg_open(struct fake_media *media)
+{
+	media->time = 0.0;
+	media->has_frame = false;
+	media->state = media->path && *media->path ? OBS_MEDIA_STATE_OPENING : OBS_MEDIA_STATE_NONE;
+	media->opening = open_frames;
+}
+
+static void fake_ffmpeg_update(void *data, obs_data_t *settings)
+{
+	struct fake_media *media = data;
+	const char *path = obs_data_get_string(settings, "local_file");
+	long long speed = obs_data_get_int(settings, "speed_percent");
+	media->speed = speed > 0 ? (double)speed / 100.0 : 1.0;
+	if (media->path && strcmp(media->path, path) == 0)
+		return;
+	bfree(media->path);
+	media->path = bstrdup(path);
+	media->duration = media_duration(path);
+	fake_ffmpeg_open(media);
+}
+
+static void *fake_ffmpeg_create(obs_data_t *settings, obs_source_t *source)
+{
+	struct fake_media *media = bzalloc(sizeof(struct fake_media));
+	media->source = source;
+	fake_ffmpeg_update(media, settings);
+	return media;
+}
+
+static void fake_ffmpeg_destroy(void *data)
+{
+	struct fake_media *media = data;
+	bfree(media->path);
+	bfree(media);
+}
+
+static uint32_t fake_ffmpeg_get_width(void *data)
+{
+	struct fake_media *media = data;
+	return media->has_frame ? 1920 : 0;
+}
+
+static uint32_t fake_ffmpeg_get_height(void *data)
+{
+	struct fake_media *media = data;
+	return media->has_frame ? 1080 : 0;
+}
+
+static void fake_ffmpeg_video_tick(void *data, float seconds)
+{
+	struct fake_media *media = data;
+	if (media->state == OBS_MEDIA_STATE_OPENING) {
+		if (--media->opening > 0)
+			return;
+		media->state = OBS_MEDIA_STATE_PLAYING;
+		media->has_frame = true;
+		obs_source_media_started(media->source);
+		return;
+	}
+	if (media->state != OBS_MEDIA_STATE_PLAYING)
+		return;
+	double from = media->time;
+	media->time += (double)seconds * 1000.0 * media->speed;
+	bool ended = media->time >= (double)media->duration;
+	if (ended)
+		media->time = (double)media->duration;
+	if (tick_callback)
+		tick_callback(media->source, from, media->time, tick_param);
+	if (ended && media->state == OBS_MEDIA_STATE_PLAYING) {
+		media->state = OBS_MEDIA_STATE_ENDED;
+		obs_source_media_ended(media->source);
+	}
+}
+
+static void fake_ffmpeg_play_pause(void *data, bool pause)
+{
+	struct fake_media *media = data;
+	if (pause) {
+		if (media->state == OBS_MEDIA_STATE_PLAYING)
+			media->state = OBS_MEDIA_STATE_PAUSED;
+		return;
+	}
+	if (media->state == OBS_MEDIA_STATE_PAUSED) {
+		media->state = OBS_MEDIA_STATE_PLAYING;
+	} else if (media->state == OBS_MEDIA_STATE_ENDED || media->state == OBS_MEDIA_STATE_STOPPED) {
+		double time = media->time < (double)media->duration ? media->time : 0.0;
+		fake_ffmpeg_open(media);
+		media->time = time;
+	}
+}
+
+static void fake_ffmpeg_restart(void *data)
+{
+	fake_ffmpeg_open(data);
+}
+
+static void fake_ffmpeg_stop(void *data)
+{
+	struct fake_media *media = data;
+	media->state = OBS_MEDIA_STATE_STOPPED;
+	media->has_frame = false;
+	media->time = 0.0;
+}
+
+static int64_t fake_ffmpeg_get_duration(void *data)
+{
+	struct fake_media *media = data;
+	return media->state == OBS_MEDIA_STATE_NONE ? 0 : media->duration;
+}
+
+static int64_t fake_ffmpeg_get_time(void *data)
+{
+	struct fake_media *media = data;
+	return (int64_t)media->time;
+}
+
+static void fake_ffmpeg_set_time(void *data, int64_t ms)
+{
+	struct fake_media *media = data;
+	if (ms < 0)
+		ms = 0;
+	if (ms > media->duration)
+		ms = media->duration;
+	media->time = (double)ms;
+}
+
+static enum obs_media_state fake_ffmpeg_get_state(void *data)
+{
+	struct fake_media *media = data;
+	return media->state;
+}
+
+static struct obs_source_info fake_ffmpeg_info = {
+	.id = "ffmpeg_source",
+	.type = OBS_SOURCE_TYPE_INPUT,
+	.output_flags = OBS_SOURCE_ASYNC_VIDEO | OBS_SOURCE_AUDIO | OBS_SOURCE_CONTROLLABLE_MEDIA,
+	.get_name = fake_ffmpeg_get_name,
+	.create = fake_ffmpeg_create,
+	.destroy = fake_ffmpeg_destroy,
+	.update = fake_ffmpeg_update,
+	.get_width = fake_ffmpeg_get_width,
+	.get_height = fake_ffmpeg_get_height,
+	.video_tick = fake_ffmpeg_video_tick,
+	.media_play_pause = fake_ffmpeg_play_pause,
+	.media_restart = fake_ffmpeg_restart,
+	.media_stop = fake_ffmpeg_stop,
+	.media_get_duration = fake_ffmpeg_get_duration,
+	.media_get_time = fake_ffmpeg_get_time,
+	.media_set_time = fake_ffmpeg_set_time,
+	.media_get_state = fake_ffmpeg_get_state,
+};
+
+bool mock_media_is_fake(obs_source_t *source)
+{
+	return source && strcmp(obs_source_get_id(source), fake_ffmpeg_info.id) == 0;
+}
+
+const char *mock_media_get_path(obs_source_t *source)
+{
+	struct fake_media *media = mock_media_is_fake(source) ? obs_obj_get_data(source) : NULL;
+	return media ? media->path : NULL;
+}
+
+double mock_media_get_time_exact(obs_source_t *source)
+{
+	struct fake_media *media = mock_media_is_fake(source) ? obs_obj_get_data(source) : NULL;
+	return media ? media->time : 0.0;
+}
+
+/* stills and colors show right away */
+
+struct fake_still {
+	uint32_t cx;
+	uint32_t cy;
+};
+
+static const char *fake_image_get_name(void *type_data)
+{
+	UNUSED_PARAMETER(type_data);
+	return "Image";
+}
+
+static const char *fake_color_get_name(void *type_data)
+{
+	UNUSED_PARAMETER(type_data);
+	return "Color Source";
+}
+
+static void fake_still_update(void *data, obs_data_t *settings)
+{
+	struct fake_still *still = data;
+	still->cx = (uint32_t)obs_data_get_int(settings, "width");
+	still->cy = (uint32_t)obs_data_get_int(settings, "height");
+	if (!still->cx || !still->cy) {
+		still->cx = 1920;
+		still->cy = 1080;
+	}
+}
+
+static void *fake_still_create(obs_data_t *settings, obs_source_t *source)
+{
+	UNUSED_PARAMETER(source);
+	struct fake_still *still = bzalloc(sizeof(struct fake_still));
+	fake_still_update(still, settings);
+	return still;
+}
+
+static void fake_still_destroy(void *data)
+{
+	bfree(data);
+}
+
+static uint32_t fake_still_get_width(void *data)
+{
+	return ((struct fake_still *)data)->cx;
+}
+
+static uint32_t fake_still_get_height(void *data)
+{
+	return ((struct fake_still *)data)->cy;
+}
+
+static struct obs_source_info fake_image_info = {
+	.id = "image_source",
+	.type = OBS_SOURCE_TYPE_INPUT,
+	.output_flags = OBS_SOURCE_VIDEO,
+	.get_name = fake_image_get_name,
+	.create = fake_still_create,
+	.destroy = fake_still_destroy,
+	.update = fake_still_update,
+	.get_width = fake_still_get_width,
+	.get_height = fake_still_get_height,
+};
+
+static struct obs_source_info fake_color_info = {
+	.id = "color_source_v3",
+	.type = OBS_SOURCE_TYPE_INPUT,
+	.output_flags = OBS_SOURCE_VIDEO,
+	.get_name = fake_color_get_name,
+	.create = fake_still_create,
+	.destroy = fake_still_destroy,
+	.update = fake_still_update,
+	.get_width = fake_still_get_width,
+	.get_height = fake_still_get_height,
+};
+
+void mock_fake_types_register(void)
+{
+	obs_register_source(&fake_ffmpeg_info);
+	obs_register_source(&fake_image_info);
+	obs_register_source(&fake_color_info);
+}
+
+void mock_media_reset(void)
+{
+	for (size_t i = 0; i < durations.num; i++)
+		bfree(durations.array[i].path);
+	da_free(durations);
+	tick_callback = NULL;
+	tick_param = NULL;
+}
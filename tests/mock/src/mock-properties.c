@@ -0,0 +1,241 @@
+#include <string.h>
+#include <obs.h>
+#include <util/darray.h>
+
+/* Properties only keep what the plugin reads back: names, visibility and
+ * groups, so get_properties can run in the tests. */
+
+struct obs_property {
+	char *name;
+	bool visible;
+	obs_properties_t *group;
+};
+
+struct obs_properties {
+	DARRAY(obs_property_t *) props;
+};
+
+obs_properties_t *obs_properties_create(void)
+{
+	return bzalloc(sizeof(obs_properties_t));
+}
+
+static void property_free(obs_property_t *p)
+{
+	obs_properties_destroy(p->group);
+	bfree(p->name);
+	bfree(p);
+}
+
+void obs_properties_destroy(obs_properties_t *props)
+{
+	if (!props)
+		return;
+	for (size_t i = 0; i < props->props.num; i++)
+		property_free(props->props.array[i]);
+	da_free(props->props);
+	bfree(props);
+}
+
+obs_property_t *obs_properties_get(obs_properties_t *props, const char *property)
+{
+	for (size_t i = 0; props && i < props->props.num; i++) {
+		obs_property_t *p = props->props.array[i];
+		if (strcmp(p->name, property) == 0)
+			return p;
+		obs_property_t *found = obs_properties_get(p->group, property);
+		if (found)
+			return found;
+	}
+	return NULL;
+}
+
+void obs_properties_remove_by_name(obs_properties_t *props, const char *property)
+{
+	for (size_t i = 0; props && i < props->props.num; i++) {
+		obs_property_t *p = props->props.array[i];
+		if (strcmp(p->name, property) == 0) {
+			da_erase(props->props, i);
+			property_free(p);
+			return;
+		}
+		obs_properties_remove_by_name(p->group, property);
+	}
+}
+
+static obs_property_t *property_add(obs_properties_t *props, const char *name)
+{
+	obs_property_t *p = bzalloc(sizeof(obs_property_t));
+	p->name = bstrdup(name);
+	p->visible = true;
+	da_push_back(props->props, &p);
+	return p;
+}
+
+obs_property_t *obs_properties_add_bool(obs_properties_t *props, const char *name, const char *description)
+{
+	UNUSED_PARAMETER(description);
+	return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_int(obs_properties_t *props, const char *name, const char *description, int min, int max,
+				       int step)
+{
+	UNUSED_PARAMETER(description);
+	UNUSED_PARAMETER(min);
+	UNUSED_PARAMETER(max);
+	UNUSED_PARAMETER(step);
+	return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_int_slider(obs_properties_t *props, const char *name, const char *description, int min,
+					      int max, int step)
+{
+	return obs_properties_add_int(props, name, description, min, max, step);
+}
+
+obs_property_t *obs_properties_add_float(obs_properties_t *props, const char *name, const char *description, double min,
+					 double max, double step)
+{
+	UNUSED_PARAMETER(description);
+	UNUSED_PARAMETER(min);
+	UNUSED_PARAMETER(max);
+	UNUSED_PARAMETER(step);
+	return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_float_slider(obs_properties_t *props, const char *name, const char *description,
+						double min, double max, double step)
+{
+	return obs_properties_add_float(props, name, description, min, max, step);
+}
+
+obs_property_t *obs_properties_add_text(obs_properties_t *props, const char *name, const char *description,
+					enum obs_text_type type)
+{
+	UNUSED_PARAMETER(description);
+	UNUSED_PARAMETER(type);
+	return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_path(obs_properties_t *props, const char *name, const char *description,
+					enum obs_path_type type, const char *filter, const char *default_path)
+{
+	UNUSED_PARAMETER(description);
+	UNUSED_PARAMETER(type);
+	UNUSED_PARAMETER(filter);
+	UNUSED_PARAMETER(default_path);
+	return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_list(obs_properties_t *props, const char *name, const char *description,
+					enum obs_combo_type type, enum obs_combo_format format)
+{
+	UNUSED_PARAMETER(description);
+	UNUSED_PARAMETER(type);
+	UNUSED_PARAMETER(format);
+	return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_color_alpha(obs_properties_t *props, const char *name, const char *description)
+{
+	UNUSED_PARAMETER(description);
+	return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_button(obs_properties_t *props, const char *name, const char *text,
+					  obs_property_clicked_t callback)
+{
+	UNUSED_PARAMETER(text);
+	UNUSED_PARAMETER(callback);
+	return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_button2(obs_properties_t *props, const char *name, const char *text,
+					   obs_property_clicked_t callback, void *priv)
+{
+	UNUSED_PARAMETER(priv);
+	return obs_properties_add_button(props, name, text, callback);
+}
+
+obs_property_t *obs_properties_add_editable_list(obs_properties_t *props, const char *name, const char *description,
+						 enum obs_editable_list_type type, const char *filter, const char *default_path)
+{
+	UNUSED_PARAMETER(description);
+	UNUSED_PARAMETER(type);
+	UNUSED_PARAMETER(filter);
+	UNUSED_PARAMETER(default_path);
+	return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_group(obs_properties_t *props, const char *name, const char *description,
+					 enum obs_group_type type, obs_properties_t *group)
+{
+	UNUSED_PARAMETER(description);
+	UNUSED_PARAMETER(type);
+	obs_property_t *p = property_add(props, name);
+	p->group = group;
+	return p;
+}
+
+const char *obs_property_name(obs_property_t *p)
+{
+	return p ? p->name : NULL;
+}
+
+bool obs_property_visible(obs_property_t *p)
+{
+	return p && p->visible;
+}
+
+void obs_property_set_visible(obs_property_t *p, bool visible)
+{
+	if (p)
+		p->visible = visible;
+}
+
+void obs_property_set_long_description(obs_property_t *p, const char *long_description)
+{
+	UNUSED_PARAMETER(p);
+	UNUSED_PARAMETER(long_description);
+}
+
+void obs_property_set_modified_callback(obs_property_t *p, obs_property_modified_t modified)
+{
+	UNUSED_PARAMETER(p);
+	UNUSED_PARAMETER(modified);
+}
+
+void obs_property_int_set_suffix(obs_property_t *p, const char *suffix)
+{
+	UNUSED_PARAMETER(p);
+	UNUSED_PARAMETER(suffix);
+}
+
+void obs_property_float_set_suffix(obs_property_t *p, const char *suffix)
+{
+	UNUSED_PARAMETER(p);
+	UNUSED_PARAMETER(suffix);
+}
+
+void obs_property_text_set_info_type(obs_property_t *p, enum obs_text_info_type type)
+{
+	UNUSED_PARAMETER(p);
+	UNUSED_PARAMETER(type);
+}
+
+size_t obs_property_list_add_int(obs_property_t *p, const char *name, long long val)
+{
+	UNUSED_PARAMETER(p);
+	UNUSED_PARAMETER(name);
+	UNUSED_PARAMETER(val);
+	return 0;
+}
+
+size_t obs_property_list_add_string(obs_property_t *p, const char *name, const char *val)
+{
+	UNUSED_PARAMETER(p);
+	UNUSED_PARAMETER(name);
+	UNUSED_PARAMETER(val);
+	return 0;
+}
@@ -0,0 +1,1141 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <obs-frontend-api.h>
+#include <obs-module.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include "mock-internal.h"
+
+struct obs_weak_source {
+	volatile long refs;
+	obs_source_t *source;
+};
+
+struct obs_source {
+	volatile long refs;
+	obs_weak_source_t *control;
+	const struct obs_source_info *info;
+	void *context_data;
+	char *name;
+	bool is_private;
+	bool removed;
+	bool enabled;
+	long showing;
+	long active;
+	volatile bool defer_update;
+	obs_data_t *settings;
+	signal_handler_t *signals;
+	proc_handler_t *procs;
+	DARRAY(obs_source_t *) active_children;
+};
+
+struct mock_source_type {
+	struct obs_source_info info;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	DARRAY(struct mock_source_type *) types;
+	DARRAY(obs_source_t *) sources;
+	obs_source_t *output;
+	uint64_t time_ns;
+	uint64_t frame_time_ns;
+	uint32_t fps_num;
+	uint32_t fps_den;
+	char *config_dir;
+	obs_source_t *measure;
+	uint64_t measured_ns;
+} mock;
+
+/* clock */
+
+uint64_t mock_obs_time(void)
+{
+	return __atomic_load_n(&mock.time_ns, __ATOMIC_SEQ_CST);
+}
+
+void mock_obs_advance(uint64_t ns)
+{
+	__atomic_add_fetch(&mock.time_ns, ns, __ATOMIC_SEQ_CST);
+}
+
+void mock_obs_set_fps(uint32_t fps_num, uint32_t fps_den)
+{
+	mock.fps_num = fps_num;
+	mock.fps_den = fps_den;
+}
+
+uint64_t mock_obs_frame_ns(void)
+{
+	return (uint64_t)1000000000 * mock.fps_den / mock.fps_num;
+}
+
+/* types */
+
+void obs_register_source_s(const struct obs_source_info *info, size_t size)
+{
+	struct mock_source_type *type = bzalloc(sizeof(struct mock_source_type));
+	memcpy(&type->info, info, size < sizeof(type->info) ? size : sizeof(type->info));
+	da_push_back(mock.types, &type);
+}
+
+static const struct obs_source_info *find_type(const char *id)
+{
+	for (size_t i = 0; id && i < mock.types.num; i++) {
+		if (strcmp(mock.types.array[i]->info.id, id) == 0)
+			return &mock.types.array[i]->info;
+	}
+	return NULL;
+}
+
+const char *obs_source_get_display_name(const char *id)
+{
+	const struct obs_source_info *info = find_type(id);
+	return info && info->get_name ? info->get_name(info->type_data) : id;
+}
+
+bool obs_enum_transition_types(size_t idx, const char **id)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < mock.types.num; i++) {
+		if (mock.types.array[i]->info.type != OBS_SOURCE_TYPE_TRANSITION)
+			continue;
+		if (count++ == idx) {
+			*id = mock.types.array[i]->info.id;
+			return true;
+		}
+	}
+	return false;
+}
+
+/* sources */
+
+static obs_source_t *source_create(const char *id, const char *name, obs_data_t *settings, bool is_private)
+{
+	const struct obs_source_info *info = find_type(id);
+	if (!info) {
+		blog(LOG_WARNING, "[mock] source type '%s' not found", id);
+		return NULL;
+	}
+	obs_source_t *source = bzalloc(sizeof(obs_source_t));
+	source->refs = 1;
+	source->control = bzalloc(sizeof(obs_weak_source_t));
+	source->control->refs = 1;
+	source->control->source = source;
+	source->info = info;
+	source->name = bstrdup(name ? name : "");
+	source->is_private = is_private;
+	source->enabled = true;
+	source->signals = signal_handler_create();
+	source->procs = proc_handler_create();
+	source->settings = obs_data_create();
+	if (info->get_defaults)
+		info->get_defaults(source->settings);
+	obs_data_apply(source->settings, settings);
+	pthread_mutex_lock(&mock.mutex);
+	da_push_back(mock.sources, &source);
+	pthread_mutex_unlock(&mock.mutex);
+	if (info->create)
+		source->context_data = info->create(source->settings, source);
+	return source;
+}
+
+obs_source_t *obs_source_create(const char *id, const char *name, obs_data_t *settings, obs_data_t *hotkey_data)
+{
+	UNUSED_PARAMETER(hotkey_data);
+	return source_create(id, name, settings, false);
+}
+
+obs_source_t *obs_source_create_private(const char *id, const char *name, obs_data_t *settings)
+{
+	return source_create(id, name, settings, true);
+}
+
+static void source_destroy(obs_source_t *source)
+{
+	pthread_mutex_lock(&mock.mutex);
+	da_erase_item(mock.sources, &source);
+	pthread_mutex_unlock(&mock.mutex);
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "source", source);
+	signal_handler_signal(source->signals, "destroy", &cd);
+	calldata_free(&cd);
+	if (source->info->destroy && source->context_data)
+		source->info->destroy(source->context_data);
+	mock_hotkeys_unregister_source(source);
+	for (size_t i = 0; i < source->active_children.num; i++)
+		obs_source_release(source->active_children.array[i]);
+	da_free(source->active_children);
+	obs_data_release(source->settings);
+	signal_handler_destroy(source->signals);
+	proc_handler_destroy(source->procs);
+	bfree(source->name);
+	bfree(source);
+}
+
+obs_source_t *obs_source_get_ref(obs_source_t *source)
+{
+	if (!source)
+		return NULL;
+	return obs_weak_source_get_source(source->control);
+}
+
+void obs_source_release(obs_source_t *source)
+{
+	if (!source)
+		return;
+	if (os_atomic_dec_long(&source->refs) != 0)
+		return;
+	obs_weak_source_t *control = source->control;
+	control->source = NULL;
+	source_destroy(source);
+	obs_weak_source_release(control);
+}
+
+obs_weak_source_t *obs_source_get_weak_source(obs_source_t *source)
+{
+	if (!source)
+		return NULL;
+	obs_weak_source_addref(source->control);
+	return source->control;
+}
+
+void obs_weak_source_addref(obs_weak_source_t *weak)
+{
+	if (weak)
+		os_atomic_inc_long(&weak->refs);
+}
+
+void obs_weak_source_release(obs_weak_source_t *weak)
+{
+	if (weak && os_atomic_dec_long(&weak->refs) == 0)
+		bfree(weak);
+}
+
+bool obs_weak_source_expired(obs_weak_source_t *weak)
+{
+	return !weak || !weak->source || os_atomic_load_long(&weak->source->refs) == 0;
+}
+
+bool obs_weak_source_references_source(obs_weak_source_t *weak, obs_source_t *source)
+{
+	return weak && source && weak->source == source;
+}
+
+obs_source_t *obs_weak_source_get_source(obs_weak_source_t *weak)
+{
+	if (!weak || !weak->source)
+		return NULL;
+	long owners = os_atomic_load_long(&weak->source->refs);
+	while (owners > 0) {
+		if (os_atomic_compare_exchange_long(&weak->source->refs, &owners, owners + 1))
+			return weak->source;
+	}
+	return NULL;
+}
+
+void obs_source_remove(obs_source_t *source)
+{
+	if (!source || source->removed)
+		return;
+	source->removed = true;
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "source", source);
+	signal_handler_signal(source->signals, "remove", &cd);
+	calldata_free(&cd);
+}
+
+obs_data_t *obs_source_get_settings(const obs_source_t *source)
+{
+	if (!source)
+		return NULL;
+	obs_data_addref(source->settings);
+	return source->settings;
+}
+
+void obs_source_update(obs_source_t *source, obs_data_t *settings)
+{
+	if (!source)
+		return;
+	if (settings)
+		obs_data_apply(source->settings, settings);
+	/* like libobs, video sources apply updates on their next tick */
+	if (source->info->output_flags & OBS_SOURCE_VIDEO)
+		os_atomic_set_bool(&source->defer_update, true);
+	else if (source->context_data && source->info->update)
+		source->info->update(source->context_data, source->settings);
+}
+
+void obs_source_update_properties(obs_source_t *source)
+{
+	UNUSED_PARAMETER(source);
+}
+
+obs_properties_t *obs_source_properties(const obs_source_t *source)
+{
+	if (!source || !source->info->get_properties)
+		return NULL;
+	return source->info->get_properties(source->context_data);
+}
+
+const char *obs_source_get_name(const obs_source_t *source)
+{
+	return source ? source->name : NULL;
+}
+
+const char *obs_source_get_id(const obs_source_t *source)
+{
+	return source ? source->info->id : NULL;
+}
+
+const char *obs_source_get_unversioned_id(const obs_source_t *source)
+{
+	return obs_source_get_id(source);
+}
+
+uint32_t obs_source_get_width(obs_source_t *source)
+{
+	if (!source || !source->info->get_width)
+		return 0;
+	return source->info->get_width(source->context_data);
+}
+
+uint32_t obs_source_get_height(obs_source_t *source)
+{
+	if (!source || !source->info->get_height)
+		return 0;
+	return source->info->get_height(source->context_data);
+}
+
+bool obs_source_active(const obs_source_t *source)
+{
+	return source && source->active > 0;
+}
+
+bool obs_source_showing(const obs_source_t *source)
+{
+	return source && source->showing > 0;
+}
+
+static void enum_tree(obs_source_t *source, void (*action)(obs_source_t *source));
+
+static void source_show(obs_source_t *source)
+{
+	if (++source->showing == 1 && source->info->show)
+		source->info->show(source->context_data);
+}
+
+static void source_hide(obs_source_t *source)
+{
+	if (source->showing > 0 && --source->showing == 0 && source->info->hide)
+		source->info->hide(source->context_data);
+}
+
+static void source_activate(obs_source_t *source)
+{
+	if (++source->active == 1 && source->info->activate)
+		source->info->activate(source->context_data);
+}
+
+static void source_deactivate(obs_source_t *source)
+{
+	if (source->active > 0 && --source->active == 0 && source->info->deactivate)
+		source->info->deactivate(source->context_data);
+}
+
+static void enum_tree_callback(obs_source_t *parent, obs_source_t *child, void *param)
+{
+	UNUSED_PARAMETER(parent);
+	enum_tree(child, (void (*)(obs_source_t *))param);
+}
+
+static void enum_tree(obs_source_t *source, void (*action)(obs_source_t *source))
+{
+	action(source);
+	if (source->info->enum_active_sources)
+		source->info->enum_active_sources(source->context_data, enum_tree_callback, (void *)action);
+	for (size_t i = 0; i < source->active_children.num; i++)
+		enum_tree(source->active_children.array[i], action);
+}
+
+void obs_source_inc_showing(obs_source_t *source)
+{
+	if (source)
+		enum_tree(source, source_show);
+}
+
+void obs_source_dec_showing(obs_source_t *source)
+{
+	if (source)
+		enum_tree(source, source_hide);
+}
+
+void obs_source_inc_active(obs_source_t *source)
+{
+	if (source)
+		enum_tree(source, source_activate);
+}
+
+void obs_source_dec_active(obs_source_t *source)
+{
+	if (source)
+		enum_tree(source, source_deactivate);
+}
+
+bool obs_source_add_active_child(obs_source_t *parent, obs_source_t *child)
+{
+	if (!parent || !child || parent == child)
+		return false;
+	obs_source_get_ref(child);
+	da_push_back(parent->active_children, &child);
+	if (parent->active)
+		obs_source_inc_active(child);
+	return true;
+}
+
+void obs_source_remove_active_child(obs_source_t *parent, obs_source_t *child)
+{
+	if (!parent || !child)
+		return;
+	size_t idx = da_find(parent->active_children, &child, 0);
+	if (idx == DARRAY_INVALID)
+		return;
+	da_erase(parent->active_children, idx);
+	if (parent->active)
+		obs_source_dec_active(child);
+	obs_source_release(child);
+}
+
+void obs_source_set_enabled(obs_source_t *source, bool enabled)
+{
+	if (source)
+		source->enabled = enabled;
+}
+
+bool obs_source_enabled(const obs_source_t *source)
+{
+	return source && source->enabled;
+}
+
+void obs_source_video_render(obs_source_t *source)
+{
+	if (source && source->enabled && source->info->video_render)
+		source->info->video_render(source->context_data, NULL);
+}
+
+void obs_source_video_tick(obs_source_t *source, float seconds)
+{
+	if (!source)
+		return;
+	if (os_atomic_set_bool(&source->defer_update, false) && source->info->update)
+		source->info->update(source->context_data, source->settings);
+	if (source->info->video_tick)
+		source->info->video_tick(source->context_data, seconds);
+}
+
+void obs_source_enum_active_sources(obs_source_t *source, obs_source_enum_proc_t enum_callback, void *param)
+{
+	if (source && source->info->enum_active_sources)
+		source->info->enum_active_sources(source->context_data, enum_callback, param);
+}
+
+struct active_tree_param {
+	obs_source_enum_proc_t callback;
+	void *param;
+};
+
+static void active_tree_callback(obs_source_t *parent, obs_source_t *child, void *data)
+{
+	struct active_tree_param *tree = data;
+	tree->callback(parent, child, tree->param);
+	obs_source_enum_active_sources(child, active_tree_callback, data);
+}
+
+void obs_source_enum_active_tree(obs_source_t *source, obs_source_enum_proc_t enum_callback, void *param)
+{
+	struct active_tree_param tree = {enum_callback, param};
+	obs_source_enum_active_sources(source, active_tree_callback, &tree);
+}
+
+signal_handler_t *obs_source_get_signal_handler(const obs_source_t *source)
+{
+	return source ? source->signals : NULL;
+}
+
+proc_handler_t *obs_source_get_proc_handler(const obs_source_t *source)
+{
+	return source ? source->procs : NULL;
+}
+
+obs_source_t *obs_source_get_filter_by_name(obs_source_t *source, const char *name)
+{
+	UNUSED_PARAMETER(source);
+	UNUSED_PARAMETER(name);
+	return NULL;
+}
+
+void *obs_obj_get_data(void *obj)
+{
+	return obj ? ((obs_source_t *)obj)->context_data : NULL;
+}
+
+/* media controls go through the type callbacks like in libobs */
+
+void obs_source_media_play_pause(obs_source_t *source, bool pause)
+{
+	if (source && source->info->media_play_pause)
+		source->info->media_play_pause(source->context_data, pause);
+}
+
+void obs_source_media_restart(obs_source_t *source)
+{
+	if (source && source->info->media_restart)
+		source->info->media_restart(source->context_data);
+}
+
+void obs_source_media_stop(obs_source_t *source)
+{
+	if (source && source->info->media_stop)
+		source->info->media_stop(source->context_data);
+}
+
+void obs_source_media_next(obs_source_t *source)
+{
+	if (source && source->info->media_next)
+		source->info->media_next(source->context_data);
+}
+
+void obs_source_media_previous(obs_source_t *source)
+{
+	if (source && source->info->media_previous)
+		source->info->media_previous(source->context_data);
+}
+
+int64_t obs_source_media_get_duration(obs_source_t *source)
+{
+	if (source && source->info->media_get_duration)
+		return source->info->media_get_duration(source->context_data);
+	return 0;
+}
+
+int64_t obs_source_media_get_time(obs_source_t *source)
+{
+	if (source && source->info->media_get_time)
+		return source->info->media_get_time(source->context_data);
+	return 0;
+}
+
+void obs_source_media_set_time(obs_source_t *source, int64_t ms)
+{
+	if (source && source->info->media_set_time)
+		source->info->media_set_time(source->context_data, ms);
+}
+
+enum obs_media_state obs_source_media_get_state(obs_source_t *source)
+{
+	if (source && source->info->media_get_state)
+		return source->info->media_get_state(source->context_data);
+	return OBS_MEDIA_STATE_NONE;
+}
+
+static void media_signal(obs_source_t *source, const char *signal)
+{
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "source", source);
+	signal_handler_signal(source->signals, signal, &cd);
+	calldata_free(&cd);
+}
+
+void obs_source_media_started(obs_source_t *source)
+{
+	media_signal(source, "media_started");
+}
+
+void obs_source_media_ended(obs_source_t *source)
+{
+	media_signal(source, "media_ended");
+}
+
+/* audio, the mock has no audio thread */
+
+static struct audio_output_info audio_info = {"mock", 48000, AUDIO_FORMAT_FLOAT_PLANAR, SPEAKERS_STEREO};
+static int audio_dummy;
+
+bool obs_source_audio_pending(const obs_source_t *source)
+{
+	UNUSED_PARAMETER(source);
+	return true;
+}
+
+void obs_source_get_audio_mix(const obs_source_t *source, struct obs_source_audio_mix *audio)
+{
+	UNUSED_PARAMETER(source);
+	memset(audio, 0, sizeof(*audio));
+}
+
+uint64_t obs_source_get_audio_timestamp(const obs_source_t *source)
+{
+	UNUSED_PARAMETER(source);
+	return 0;
+}
+
+void obs_source_output_audio(obs_source_t *source, const struct obs_source_audio *audio)
+{
+	UNUSED_PARAMETER(source);
+	UNUSED_PARAMETER(audio);
+}
+
+audio_t *obs_get_audio(void)
+{
+	return (audio_t *)&audio_dummy;
+}
+
+bool audio_output_connect(audio_t *audio, size_t mix_idx, const void *conversion, audio_output_callback_t callback,
+			  void *param)
+{
+	UNUSED_PARAMETER(audio);
+	UNUSED_PARAMETER(mix_idx);
+	UNUSED_PARAMETER(conversion);
+	UNUSED_PARAMETER(callback);
+	UNUSED_PARAMETER(param);
+	return true;
+}
+
+void audio_output_disconnect(audio_t *audio, size_t mix_idx, audio_output_callback_t callback, void *param)
+{
+	UNUSED_PARAMETER(audio);
+	UNUSED_PARAMETER(mix_idx);
+	UNUSED_PARAMETER(callback);
+	UNUSED_PARAMETER(param);
+}
+
+const struct audio_output_info *audio_output_get_info(const audio_t *audio)
+{
+	UNUSED_PARAMETER(audio);
+	return &audio_info;
+}
+
+/* source lists */
+
+static bool is_scene(const obs_source_t *source)
+{
+	return source->info->type == OBS_SOURCE_TYPE_SCENE && strcmp(source->info->id, "scene") == 0;
+}
+
+obs_source_t *obs_get_source_by_name(const char *name)
+{
+	obs_source_t *found = NULL;
+	pthread_mutex_lock(&mock.mutex);
+	for (size_t i = 0; name && i < mock.sources.num; i++) {
+		obs_source_t *source = mock.sources.array[i];
+		if (!source->is_private && !source->removed && strcmp(source->name, name) == 0) {
+			found = obs_source_get_ref(source);
+			if (found)
+				break;
+		}
+	}
+	pthread_mutex_unlock(&mock.mutex);
+	return found;
+}
+
+static void enum_public(bool (*enum_proc)(void *, obs_source_t *), void *param, bool scenes)
+{
+	pthread_mutex_lock(&mock.mutex);
+	DARRAY(obs_source_t *) list;
+	da_init(list);
+	for (size_t i = 0; i < mock.sources.num; i++) {
+		obs_source_t *source = mock.sources.array[i];
+		if (source->is_private || source->removed || is_scene(source) != scenes)
+			continue;
+		if (source->info->type != OBS_SOURCE_TYPE_INPUT && !scenes)
+			continue;
+		if (obs_source_get_ref(source))
+			da_push_back(list, &source);
+	}
+	pthread_mutex_unlock(&mock.mutex);
+	size_t i = 0;
+	for (; i < list.num; i++) {
+		if (!enum_proc(param, list.array[i]))
+			break;
+	}
+	for (i = 0; i < list.num; i++)
+		obs_source_release(list.array[i]);
+	da_free(list);
+}
+
+void obs_enum_sources(bool (*enum_proc)(void *, obs_source_t *), void *param)
+{
+	enum_public(enum_proc, param, false);
+}
+
+void obs_enum_scenes(bool (*enum_proc)(void *, obs_source_t *), void *param)
+{
+	enum_public(enum_proc, param, true);
+}
+
+obs_source_t *obs_get_output_source(uint32_t channel)
+{
+	return channel == 0 ? obs_source_get_ref(mock.output) : NULL;
+}
+
+void obs_set_output_source(uint32_t channel, obs_source_t *source)
+{
+	if (channel != 0)
+		return;
+	obs_source_t *old = mock.output;
+	mock.output = obs_source_get_ref(source);
+	if (mock.output) {
+		obs_source_inc_active(mock.output);
+		obs_source_inc_showing(mock.output);
+	}
+	if (old) {
+		obs_source_dec_showing(old);
+		obs_source_dec_active(old);
+		obs_source_release(old);
+	}
+}
+
+/* scenes */
+
+struct obs_scene_item {
+	obs_scene_t *parent;
+	obs_source_t *source;
+	bool visible;
+};
+
+struct obs_scene {
+	obs_source_t *source;
+	DARRAY(struct obs_scene_item *) items;
+};
+
+static const char *scene_get_name(void *type_data)
+{
+	UNUSED_PARAMETER(type_data);
+	return "Scene";
+}
+
+static void *scene_create(obs_data_t *settings, obs_source_t *source)
+{
+	UNUSED_PARAMETER(settings);
+	obs_scene_t *scene = bzalloc(sizeof(obs_scene_t));
+	scene->source = source;
+	return scene;
+}
+
+static void scene_destroy(void *data)
+{
+	obs_scene_t *scene = data;
+	for (size_t i = 0; i < scene->items.num; i++) {
+		obs_source_release(scene->items.array[i]->source);
+		bfree(scene->items.array[i]);
+	}
+	da_free(scene->items);
+	bfree(scene);
+}
+
+static void scene_enum_active_sources(void *data, obs_source_enum_proc_t enum_callback, void *param)
+{
+	obs_scene_t *scene = data;
+	for (size_t i = 0; i < scene->items.num; i++) {
+		if (scene->items.array[i]->visible)
+			enum_callback(scene->source, scene->items.array[i]->source, param);
+	}
+}
+
+static void scene_video_tick(void *data, float seconds)
+{
+	UNUSED_PARAMETER(data);
+	UNUSED_PARAMETER(seconds);
+}
+
+obs_scene_t *obs_scene_create(const char *name)
+{
+	obs_source_t *source = obs_source_create("scene", name, NULL, NULL);
+	return source ? source->context_data : NULL;
+}
+
+obs_scene_t *mock_obs_create_scene(const char *name)
+{
+	return obs_scene_create(name);
+}
+
+void obs_scene_release(obs_scene_t *scene)
+{
+	if (scene)
+		obs_source_release(scene->source);
+}
+
+obs_source_t *obs_scene_get_source(const obs_scene_t *scene)
+{
+	return scene ? scene->source : NULL;
+}
+
+obs_scene_t *obs_scene_from_source(const obs_source_t *source)
+{
+	return source && is_scene(source) ? source->context_data : NULL;
+}
+
+obs_sceneitem_t *obs_scene_add(obs_scene_t *scene, obs_source_t *source)
+{
+	if (!scene || !source)
+		return NULL;
+	obs_sceneitem_t *item = bzalloc(sizeof(obs_sceneitem_t));
+	item->parent = scene;
+	item->source = obs_source_get_ref(source);
+	item->visible = true;
+	da_push_back(scene->items, &item);
+	if (scene->source->active)
+		obs_source_inc_active(source);
+	if (scene->source->showing)
+		obs_source_inc_showing(source);
+	return item;
+}
+
+obs_sceneitem_t *obs_scene_find_source_recursive(obs_scene_t *scene, const char *name)
+{
+	for (size_t i = 0; scene && i < scene->items.num; i++) {
+		obs_sceneitem_t *item = scene->items.array[i];
+		if (strcmp(item->source->name, name) == 0)
+			return item;
+		obs_sceneitem_t *found = obs_scene_find_source_recursive(obs_scene_from_source(item->source), name);
+		if (found)
+			return found;
+	}
+	return NULL;
+}
+
+void obs_sceneitem_set_visible(obs_sceneitem_t *item, bool visible)
+{
+	if (!item || item->visible == visible)
+		return;
+	item->visible = visible;
+	if (item->parent->source->active) {
+		if (visible)
+			obs_source_inc_active(item->source);
+		else
+			obs_source_dec_active(item->source);
+	}
+}
+
+bool obs_sceneitem_visible(const obs_sceneitem_t *item)
+{
+	return item && item->visible;
+}
+
+/* transitions switch instantly but report their duration */
+
+struct mock_transition {
+	obs_source_t *source;
+	obs_source_t *active;
+	uint32_t cx;
+	uint32_t cy;
+	enum obs_transition_scale_type scale_type;
+};
+
+static const char *fade_get_name(void *type_data)
+{
+	UNUSED_PARAMETER(type_data);
+	return "Fade";
+}
+
+static const char *cut_get_name(void *type_data)
+{
+	UNUSED_PARAMETER(type_data);
+	return "Cut";
+}
+
+static void *transition_create(obs_data_t *settings, obs_source_t *source)
+{
+	UNUSED_PARAMETER(settings);
+	struct mock_transition *transition = bzalloc(sizeof(struct mock_transition));
+	transition->source = source;
+	return transition;
+}
+
+static void transition_destroy(void *data)
+{
+	struct mock_transition *transition = data;
+	obs_source_release(transition->active);
+	bfree(transition);
+}
+
+static uint32_t transition_get_width(void *data)
+{
+	struct mock_transition *transition = data;
+	return transition->cx ? transition->cx : obs_source_get_width(transition->active);
+}
+
+static uint32_t transition_get_height(void *data)
+{
+	struct mock_transition *transition = data;
+	return transition->cy ? transition->cy : obs_source_get_height(transition->active);
+}
+
+static void transition_enum_active_sources(void *data, obs_source_enum_proc_t enum_callback, void *param)
+{
+	struct mock_transition *transition = data;
+	if (transition->active)
+		enum_callback(transition->source, transition->active, param);
+}
+
+static struct mock_transition *get_transition(obs_source_t *source)
+{
+	if (!source || source->info->type != OBS_SOURCE_TYPE_TRANSITION)
+		return NULL;
+	return source->context_data;
+}
+
+static void transition_set_active(struct mock_transition *transition, obs_source_t *source)
+{
+	obs_source_t *old = transition->active;
+	transition->active = obs_source_get_ref(source);
+	if (transition->source->active && transition->active)
+		obs_source_inc_active(transition->active);
+	if (transition->source->active && old)
+		obs_source_dec_active(old);
+	obs_source_release(old);
+}
+
+obs_source_t *obs_transition_get_active_source(obs_source_t *source)
+{
+	struct mock_transition *transition = get_transition(source);
+	return transition ? obs_source_get_ref(transition->active) : NULL;
+}
+
+void obs_transition_set(obs_source_t *source, obs_source_t *dest)
+{
+	struct mock_transition *transition = get_transition(source);
+	if (transition)
+		transition_set_active(transition, dest);
+}
+
+void obs_transition_set_size(obs_source_t *source, uint32_t cx, uint32_t cy)
+{
+	struct mock_transition *transition = get_transition(source);
+	if (transition) {
+		transition->cx = cx;
+		transition->cy = cy;
+	}
+}
+
+void obs_transition_set_scale_type(obs_source_t *source, enum obs_transition_scale_type type)
+{
+	struct mock_transition *transition = get_transition(source);
+	if (transition)
+		transition->scale_type = type;
+}
+
+bool obs_transition_start(obs_source_t *source, enum obs_transition_mode mode, uint32_t duration_ms, obs_source_t *dest)
+{
+	UNUSED_PARAMETER(mode);
+	UNUSED_PARAMETER(duration_ms);
+	struct mock_transition *transition = get_transition(source);
+	if (!transition)
+		return false;
+	transition_set_active(transition, dest);
+	return true;
+}
+
+void obs_transition_swap_begin(obs_source_t *tr_dest, obs_source_t *tr_source)
+{
+	UNUSED_PARAMETER(tr_dest);
+	UNUSED_PARAMETER(tr_source);
+}
+
+void obs_transition_swap_end(obs_source_t *tr_dest, obs_source_t *tr_source)
+{
+	struct mock_transition *dest = get_transition(tr_dest);
+	struct mock_transition *src = get_transition(tr_source);
+	if (dest && src)
+		transition_set_active(dest, src->active);
+}
+
+/* core */
+
+bool obs_get_video_info(struct obs_video_info *ovi)
+{
+	memset(ovi, 0, sizeof(*ovi));
+	ovi->graphics_module = "mock";
+	ovi->fps_num = mock.fps_num;
+	ovi->fps_den = mock.fps_den;
+	ovi->base_width = ovi->output_width = 1920;
+	ovi->base_height = ovi->output_height = 1080;
+	return true;
+}
+
+uint64_t obs_get_video_frame_time(void)
+{
+	return mock.frame_time_ns;
+}
+
+void obs_enter_graphics(void) {}
+
+void obs_leave_graphics(void) {}
+
+static int base_effect;
+
+gs_effect_t *obs_get_base_effect(enum obs_base_effect effect)
+{
+	UNUSED_PARAMETER(effect);
+	return (gs_effect_t *)&base_effect;
+}
+
+void mock_obs_video_tick(void)
+{
+	uint64_t frame_ns = mock_obs_frame_ns();
+	mock_obs_advance(frame_ns);
+	mock.frame_time_ns = mock_obs_time();
+	pthread_mutex_lock(&mock.mutex);
+	DARRAY(obs_source_t *) list;
+	da_init(list);
+	for (size_t i = 0; i < mock.sources.num; i++) {
+		obs_source_t *source = mock.sources.array[i];
+		if (obs_source_get_ref(source))
+			da_push_back(list, &source);
+	}
+	pthread_mutex_unlock(&mock.mutex);
+	float seconds = (float)((double)frame_ns / 1000000000.0);
+	for (size_t i = 0; i < list.num; i++) {
+		if (list.array[i] != mock.measure) {
+			obs_source_video_tick(list.array[i], seconds);
+			continue;
+		}
+		struct timespec start, end;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		obs_source_video_tick(list.array[i], seconds);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		mock.measured_ns = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000ULL + (uint64_t)end.tv_nsec -
+				   (uint64_t)start.tv_nsec;
+	}
+	for (size_t i = 0; i < list.num; i++)
+		obs_source_release(list.array[i]);
+	da_free(list);
+}
+
+void mock_obs_measure_tick(obs_source_t *source)
+{
+	mock.measure = source;
+	mock.measured_ns = 0;
+}
+
+uint64_t mock_obs_measured_tick_ns(void)
+{
+	return mock.measured_ns;
+}
+
+/* module */
+
+const char *obs_module_text(const char *lookup)
+{
+	return lookup;
+}
+
+char *obs_module_config_path(const char *file)
+{
+	struct dstr path;
+	dstr_init_copy(&path, mock.config_dir);
+	if (file && *file) {
+		dstr_cat_ch(&path, '/');
+		dstr_cat(&path, file);
+	}
+	return path.array;
+}
+
+/* frontend, no studio mode and no current scene */
+
+obs_source_t *obs_frontend_get_current_scene(void)
+{
+	return NULL;
+}
+
+int obs_frontend_get_transition_duration(void)
+{
+	return 300;
+}
+
+void obs_frontend_open_source_properties(obs_source_t *source)
+{
+	UNUSED_PARAMETER(source);
+}
+
+bool obs_frontend_preview_program_mode_active(void)
+{
+	return false;
+}
+
+void obs_frontend_preview_program_trigger_transition(void) {}
+
+/* startup */
+
+static struct obs_source_info scene_info = {
+	.id = "scene",
+	.type = OBS_SOURCE_TYPE_SCENE,
+	.output_flags = OBS_SOURCE_VIDEO | OBS_SOURCE_COMPOSITE,
+	.get_name = scene_get_name,
+	.create = scene_create,
+	.destroy = scene_destroy,
+	.video_tick = scene_video_tick,
+	.enum_active_sources = scene_enum_active_sources,
+};
+
+static struct obs_source_info fade_info = {
+	.id = "fade_transition",
+	.type = OBS_SOURCE_TYPE_TRANSITION,
+	.output_flags = OBS_SOURCE_VIDEO,
+	.get_name = fade_get_name,
+	.create = transition_create,
+	.destroy = transition_destroy,
+	.get_width = transition_get_width,
+	.get_height = transition_get_height,
+	.enum_active_sources = transition_enum_active_sources,
+};
+
+static struct obs_source_info cut_info = {
+	.id = "cut_transition",
+	.type = OBS_SOURCE_TYPE_TRANSITION,
+	.output_flags = OBS_SOURCE_VIDEO,
+	.get_name = cut_get_name,
+	.create = transition_create,
+	.destroy = transition_destroy,
+	.get_width = transition_get_width,
+	.get_height = transition_get_height,
+	.enum_active_sources = transition_enum_active_sources,
+};
+
+void mock_obs_startup(const char *config_dir)
+{
+	pthread_mutex_init(&mock.mutex, NULL);
+	mock.fps_num = 30;
+	mock.fps_den = 1;
+	/* start well away from zero, the plugin treats 0 as unset */
+	mock.time_ns = 1000000000000ULL;
+	mock.frame_time_ns = mock.time_ns;
+	mock.config_dir = bstrdup(config_dir);
+	os_mkdirs(config_dir);
+	obs_register_source(&scene_info);
+	obs_register_source(&fade_info);
+	obs_register_source(&cut_info);
+	mock_fake_types_register();
+}
+
+void mock_obs_shutdown(void)
+{
+	obs_set_output_source(0, NULL);
+	if (mock.sources.num)
+		blog(LOG_WARNING, "[mock] %zu sources leaked", mock.sources.num);
+	da_free(mock.sources);
+	for (size_t i = 0; i < mock.types.num; i++)
+		bfree(mock.types.array[i]);
+	da_free(mock.types);
+	mock_callback_reset();
+	mock_media_reset();
+	bfree(mock.config_dir);
+	mock.config_dir = NULL;
+	pthread_mutex_destroy(&mock.mutex);
+}
@@ -0,0 +1,610 @@
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <util/base.h>
+#include <util/bmem.h>
+#include <util/crc32.h>
+#include <util/dstr.h>
+#include <util/pipe.h>
+#include <util/platform.h>
+#include <util/profiler.h>
+#include <util/threading.h>
+#include "mock-internal.h"
+
+/* bmem */
+
+static volatile long num_allocs;
+
+void *bmalloc(size_t size)
+{
+	void *ptr = malloc(size ? size : 1);
+	if (!ptr) {
+		fprintf(stderr, "out of memory allocating %zu bytes\n", size);
+		abort();
+	}
+	os_atomic_inc_long(&num_allocs);
+	return ptr;
+}
+
+void *brealloc(void *ptr, size_t size)
+{
+	if (!ptr)
+		return bmalloc(size);
+	ptr = realloc(ptr, size ? size : 1);
+	if (!ptr)
+		abort();
+	return ptr;
+}
+
+void bfree(void *ptr)
+{
+	if (ptr) {
+		os_atomic_dec_long(&num_allocs);
+		free(ptr);
+	}
+}
+
+long bnum_allocs(void)
+{
+	return os_atomic_load_long(&num_allocs);
+}
+
+/* base */
+
+static int log_level = LOG_WARNING;
+
+void mock_obs_set_log_level(int level)
+{
+	log_level = level;
+}
+
+void blog(int level, const char *format, ...)
+{
+	if (level > log_level)
+		return;
+	va_list args;
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	fputc('\n', stderr);
+	va_end(args);
+}
+
+/* profiler, the plugin only marks sections */
+
+void profile_start(const char *name)
+{
+	UNUSED_PARAMETER(name);
+}
+
+void profile_end(const char *name)
+{
+	UNUSED_PARAMETER(name);
+}
+
+/* crc32 */
+
+uint32_t calc_crc32(uint32_t crc, const void *buf, size_t size)
+{
+	const uint8_t *p = buf;
+	crc = ~crc;
+	while (size--) {
+		crc ^= *p++;
+		for (int k = 0; k < 8; k++)
+			crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+	}
+	return ~crc;
+}
+
+/* dstr */
+
+static void dstr_ensure_capacity(struct dstr *dst, size_t new_size)
+{
+	if (new_size <= dst->capacity)
+		return;
+	size_t new_cap = !dst->capacity ? new_size : dst->capacity * 2;
+	if (new_size > new_cap)
+		new_cap = new_size;
+	dst->array = brealloc(dst->array, new_cap);
+	dst->capacity = new_cap;
+}
+
+void dstr_init_copy(struct dstr *dst, const char *src)
+{
+	dstr_init(dst);
+	dstr_copy(dst, src);
+}
+
+void dstr_free(struct dstr *dst)
+{
+	bfree(dst->array);
+	dstr_init(dst);
+}
+
+void dstr_ncopy(struct dstr *dst, const char *array, size_t len)
+{
+	if (dst->array == array)
+		return;
+	if (!array || !*array || !len) {
+		dstr_free(dst);
+		return;
+	}
+	dstr_ensure_capacity(dst, len + 1);
+	memcpy(dst->array, array, len);
+	dst->array[len] = 0;
+	dst->len = len;
+}
+
+void dstr_copy(struct dstr *dst, const char *array)
+{
+	dstr_ncopy(dst, array, array ? strlen(array) : 0);
+}
+
+void dstr_ncat(struct dstr *dst, const char *array, size_t len)
+{
+	if (!array || !*array || !len)
+		return;
+	dstr_ensure_capacity(dst, dst->len + len + 1);
+	memcpy(dst->array + dst->len, array, len);
+	dst->len += len;
+	dst->array[dst->len] = 0;
+}
+
+void dstr_cat(struct dstr *dst, const char *array)
+{
+	if (array)
+		dstr_ncat(dst, array, strlen(array));
+}
+
+void dstr_cat_ch(struct dstr *dst, char ch)
+{
+	dstr_ensure_capacity(dst, dst->len + 2);
+	dst->array[dst->len++] = ch;
+	dst->array[dst->len] = 0;
+}
+
+void dstr_vcatf(struct dstr *dst, const char *format, va_list args)
+{
+	va_list copy;
+	va_copy(copy, args);
+	int len = vsnprintf(NULL, 0, format, copy);
+	va_end(copy);
+	if (len <= 0)
+		return;
+	dstr_ensure_capacity(dst, dst->len + (size_t)len + 1);
+	vsnprintf(dst->array + dst->len, (size_t)len + 1, format, args);
+	dst->len += (size_t)len;
+}
+
+void dstr_vprintf(struct dstr *dst, const char *format, va_list args)
+{
+	if (dst->array)
+		dst->array[0] = 0;
+	dst->len = 0;
+	dstr_vcatf(dst, format, args);
+	if (!dst->len)
+		dstr_free(dst);
+}
+
+void dstr_printf(struct dstr *dst, const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	dstr_vprintf(dst, format, args);
+	va_end(args);
+}
+
+void dstr_catf(struct dstr *dst, const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	dstr_vcatf(dst, format, args);
+	va_end(args);
+}
+
+void dstr_resize(struct dstr *dst, size_t num)
+{
+	if (!num) {
+		dstr_free(dst);
+		return;
+	}
+	dstr_ensure_capacity(dst, num + 1);
+	dst->array[num] = 0;
+	dst->len = num;
+}
+
+void dstr_replace(struct dstr *str, const char *find, const char *replace)
+{
+	if (dstr_is_empty(str) || !find || !*find)
+		return;
+	if (!replace)
+		replace = "";
+	size_t find_len = strlen(find);
+	struct dstr out;
+	dstr_init(&out);
+	const char *pos = str->array;
+	const char *found;
+	while ((found = strstr(pos, find)) != NULL) {
+		dstr_ncat(&out, pos, (size_t)(found - pos));
+		dstr_cat(&out, replace);
+		pos = found + find_len;
+	}
+	dstr_cat(&out, pos);
+	dstr_free(str);
+	*str = out;
+}
+
+void dstr_depad(struct dstr *dst)
+{
+	if (dstr_is_empty(dst))
+		return;
+	size_t start = 0;
+	while (start < dst->len && (dst->array[start] == ' ' || dst->array[start] == '\t' || dst->array[start] == '\r' ||
+				    dst->array[start] == '\n'))
+		start++;
+	size_t end = dst->len;
+	while (end > start && (dst->array[end - 1] == ' ' || dst->array[end - 1] == '\t' || dst->array[end - 1] == '\r' ||
+			       dst->array[end - 1] == '\n'))
+		end--;
+	if (end == start) {
+		dstr_free(dst);
+		return;
+	}
+	memmove(dst->array, dst->array + start, end - start);
+	dst->len = end - start;
+	dst->array[dst->len] = 0;
+}
+
+int astrcmpi(const char *str1, const char *str2)
+{
+	return strcasecmp(str1 ? str1 : "", str2 ? str2 : "");
+}
+
+int astrcmpi_n(const char *str1, const char *str2, size_t n)
+{
+	return strncasecmp(str1 ? str1 : "", str2 ? str2 : "", n);
+}
+
+/* platform, real files but the virtual clock */
+
+FILE *os_fopen(const char *path, const char *mode)
+{
+	return path ? fopen(path, mode) : NULL;
+}
+
+int64_t os_fgetsize(FILE *file)
+{
+	long cur = ftell(file);
+	if (fseek(file, 0, SEEK_END) != 0)
+		return -1;
+	long size = ftell(file);
+	fseek(file, cur, SEEK_SET);
+	return size;
+}
+
+int64_t os_get_file_size(const char *path)
+{
+	struct stat st;
+	if (!path || stat(path, &st) != 0)
+		return -1;
+	return (int64_t)st.st_size;
+}
+
+bool os_file_exists(const char *path)
+{
+	return path && access(path, F_OK) == 0;
+}
+
+char *os_quick_read_utf8_file(const char *path)
+{
+	FILE *f = os_fopen(path, "rb");
+	if (!f)
+		return NULL;
+	int64_t size = os_fgetsize(f);
+	if (size < 0) {
+		fclose(f);
+		return NULL;
+	}
+	char *str = bmalloc((size_t)size + 1);
+	size_t read = fread(str, 1, (size_t)size, f);
+	str[read] = 0;
+	fclose(f);
+	if (read >= 3 && (uint8_t)str[0] == 0xEF && (uint8_t)str[1] == 0xBB && (uint8_t)str[2] == 0xBF)
+		memmove(str, str + 3, read - 2);
+	return str;
+}
+
+bool os_quick_write_utf8_file(const char *path, const char *str, size_t len, bool marker)
+{
+	FILE *f = os_fopen(path, "wb");
+	if (!f)
+		return false;
+	if (marker)
+		fwrite("\xEF\xBB\xBF", 1, 3, f);
+	if (len)
+		fwrite(str, 1, len, f);
+	fclose(f);
+	return true;
+}
+
+bool os_quick_write_utf8_file_safe(const char *path, const char *str, size_t len, bool marker, const char *temp_ext,
+				   const char *backup_ext)
+{
+	struct dstr temp;
+	dstr_init_copy(&temp, path);
+	if (*temp_ext != '.')
+		dstr_cat_ch(&temp, '.');
+	dstr_cat(&temp, temp_ext);
+	bool success = os_quick_write_utf8_file(temp.array, str, len, marker);
+	if (success && backup_ext && *backup_ext && os_file_exists(path)) {
+		struct dstr backup;
+		dstr_init_copy(&backup, path);
+		if (*backup_ext != '.')
+			dstr_cat_ch(&backup, '.');
+		dstr_cat(&backup, backup_ext);
+		unlink(backup.array);
+		rename(path, backup.array);
+		dstr_free(&backup);
+	}
+	if (success)
+		success = rename(temp.array, path) == 0;
+	dstr_free(&temp);
+	return success;
+}
+
+const char *os_get_path_extension(const char *path)
+{
+	if (!path)
+		return NULL;
+	const char *slash = strrchr(path, '/');
+	const char *period = strrchr(path, '.');
+	if (!period || (slash && period < slash))
+		return NULL;
+	return period;
+}
+
+char *os_generate_formatted_filename(const char *extension, bool space, const char *format)
+{
+	time_t now = time(NULL);
+	struct tm *cur_time = localtime(&now);
+	char buffer[256];
+	strftime(buffer, sizeof(buffer), format && *format ? format : "%Y-%m-%d %H-%M-%S", cur_time);
+	struct dstr name;
+	dstr_init_copy(&name, buffer);
+	if (!space)
+		dstr_replace(&name, " ", "_");
+	dstr_cat_ch(&name, '.');
+	dstr_cat(&name, extension);
+	return name.array;
+}
+
+uint64_t os_gettime_ns(void)
+{
+	return mock_obs_time();
+}
+
+void os_sleep_ms(uint32_t duration)
+{
+	struct timespec ts = {(time_t)(duration / 1000), (long)(duration % 1000) * 1000000};
+	nanosleep(&ts, NULL);
+}
+
+struct os_dir {
+	DIR *dir;
+	char *path;
+	struct os_dirent out;
+};
+
+os_dir_t *os_opendir(const char *path)
+{
+	DIR *dir = path ? opendir(path) : NULL;
+	if (!dir)
+		return NULL;
+	struct os_dir *d = bzalloc(sizeof(struct os_dir));
+	d->dir = dir;
+	d->path = bstrdup(path);
+	return d;
+}
+
+struct os_dirent *os_readdir(os_dir_t *dir)
+{
+	if (!dir)
+		return NULL;
+	struct dirent *ent = readdir(dir->dir);
+	if (!ent)
+		return NULL;
+	snprintf(dir->out.d_name, sizeof(dir->out.d_name), "%s", ent->d_name);
+	struct dstr full;
+	dstr_init(&full);
+	dstr_printf(&full, "%s/%s", dir->path, ent->d_name);
+	struct stat st;
+	dir->out.directory = stat(full.array, &st) == 0 && S_ISDIR(st.st_mode);
+	dstr_free(&full);
+	return &dir->out;
+}
+
+void os_closedir(os_dir_t *dir)
+{
+	if (!dir)
+		return;
+	closedir(dir->dir);
+	bfree(dir->path);
+	bfree(dir);
+}
+
+int os_unlink(const char *path)
+{
+	return unlink(path);
+}
+
+int os_rename(const char *old_path, const char *new_path)
+{
+	return rename(old_path, new_path);
+}
+
+int os_mkdir(const char *path)
+{
+	if (mkdir(path, 0755) == 0)
+		return 0;
+	return errno == EEXIST ? 1 : -1;
+}
+
+int os_mkdirs(const char *dir)
+{
+	struct dstr path;
+	dstr_init_copy(&path, dir);
+	int result = 0;
+	for (size_t i = 1; i <= path.len; i++) {
+		if (path.array[i] != '/' && path.array[i] != 0)
+			continue;
+		char ch = path.array[i];
+		path.array[i] = 0;
+		result = os_mkdir(path.array);
+		path.array[i] = ch;
+		if (result < 0)
+			break;
+	}
+	dstr_free(&path);
+	return result < 0 ? -1 : 0;
+}
+
+/* the tests never start external tools */
+
+os_process_pipe_t *os_process_pipe_create(const char *cmd_line, const char *type)
+{
+	UNUSED_PARAMETER(cmd_line);
+	UNUSED_PARAMETER(type);
+	return NULL;
+}
+
+int os_process_pipe_destroy(os_process_pipe_t *pp)
+{
+	UNUSED_PARAMETER(pp);
+	return -1;
+}
+
+size_t os_process_pipe_read(os_process_pipe_t *pp, uint8_t *data, size_t len)
+{
+	UNUSED_PARAMETER(pp);
+	UNUSED_PARAMETER(data);
+	UNUSED_PARAMETER(len);
+	return 0;
+}
+
+size_t os_process_pipe_read_err(os_process_pipe_t *pp, uint8_t *data, size_t len)
+{
+	return os_process_pipe_read(pp, data, len);
+}
+
+size_t os_process_pipe_write(os_process_pipe_t *pp, const uint8_t *data, size_t len)
+{
+	UNUSED_PARAMETER(pp);
+	UNUSED_PARAMETER(data);
+	UNUSED_PARAMETER(len);
+	return 0;
+}
+
+/* threading */
+
+struct os_event_data {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	volatile bool signalled;
+	bool manual;
+};
+
+int os_event_init(os_event_t **event, enum os_event_type type)
+{
+	struct os_event_data *data = bzalloc(sizeof(struct os_event_data));
+	pthread_mutex_init(&data->mutex, NULL);
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&data->cond, &attr);
+	pthread_condattr_destroy(&attr);
+	data->manual = type == OS_EVENT_TYPE_MANUAL;
+	*event = data;
+	return 0;
+}
+
+void os_event_destroy(os_event_t *event)
+{
+	if (!event)
+		return;
+	pthread_mutex_destroy(&event->mutex);
+	pthread_cond_destroy(&event->cond);
+	bfree(event);
+}
+
+int os_event_wait(os_event_t *event)
+{
+	pthread_mutex_lock(&event->mutex);
+	while (!event->signalled)
+		pthread_cond_wait(&event->cond, &event->mutex);
+	if (!event->manual)
+		event->signalled = false;
+	pthread_mutex_unlock(&event->mutex);
+	return 0;
+}
+
+int os_event_timedwait(os_event_t *event, unsigned long milliseconds)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	ts.tv_sec += (time_t)(milliseconds / 1000);
+	ts.tv_nsec += (long)(milliseconds % 1000) * 1000000;
+	if (ts.tv_nsec >= 1000000000) {
+		ts.tv_sec++;
+		ts.tv_nsec -= 1000000000;
+	}
+	int code = 0;
+	pthread_mutex_lock(&event->mutex);
+	while (!event->signalled && code == 0)
+		code = pthread_cond_timedwait(&event->cond, &event->mutex, &ts);
+	if (event->signalled) {
+		code = 0;
+		if (!event->manual)
+			event->signalled = false;
+	}
+	pthread_mutex_unlock(&event->mutex);
+	return code;
+}
+
+int os_event_try(os_event_t *event)
+{
+	int code = EAGAIN;
+	pthread_mutex_lock(&event->mutex);
+	if (event->signalled) {
+		if (!event->manual)
+			event->signalled = false;
+		code = 0;
+	}
+	pthread_mutex_unlock(&event->mutex);
+	return code;
+}
+
+int os_event_signal(os_event_t *event)
+{
+	pthread_mutex_lock(&event->mutex);
+	event->signalled = true;
+	pthread_cond_broadcast(&event->cond);
+	pthread_mutex_unlock(&event->mutex);
+	return 0;
+}
+
+void os_event_reset(os_event_t *event)
+{
+	pthread_mutex_lock(&event->mutex);
+	event->signalled = false;
+	pthread_mutex_unlock(&event->mutex);
+}
+
+void os_set_thread_name(const char *name)
+{
+	UNUSED_PARAMETER(name);
+}
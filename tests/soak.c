@@ -0,0 +1,293 @@
+/* Soak test of the playout source against the mock libobs. A playlist of fake
+ * media is played frame by frame on the virtual clock, a day in a few seconds,
+ * for every playback mode, loop and autoplay combination. Every combination is
+ * one JSON line on stdout with the switch latency distribution, missed
+ * out-points, drift and skipped or doubled items as the harness measured them,
+ * next to the counts the source keeps itself.
+ *
+ * Latency is the wall clock time from the last frame at the out-point of the
+ * outgoing item to the last frame it was on air, drift the sum of those. That
+ * is what the source adds up in late_total_ms, the two differ only where a
+ * file ends between frames: the source learns of that with media_ended and
+ * counts the whole frame, the harness the part of it after the end. The
+ * harness expects the next item from the playlist order, so it does not
+ * depend on the plugin being right about its own plan.
+ *
+ * Exits with 1 when an item was skipped or doubled, an out-point was missed
+ * or the drift per switch is more than a frame. */
+
+#include "../playout-source.c"
+#include <mock-obs.h>
+#include <stdlib.h>
+
+struct soak_item {
+	const char *section;
+	int64_t duration_ms;
+	double start;
+	double end;
+	const char *transition;
+	int transition_ms;
+};
+
+/* durations that do not fall on frames, trims, and transitions with and without a lead */
+static const struct soak_item soak_items[] = {
+	{"morning", 12040, 0.0, 0.0, NULL, 0},
+	{"morning", 7513, 1.0, 0.0, "fade_transition", 500},
+	{"morning", 30000, 0.0, -2.0, NULL, 0},
+	{"morning", 4987, 0.0, 0.0, "cut_transition", 0},
+	{"evening", 9001, 0.5, -0.5, "fade_transition", 300},
+	{"evening", 15033, 0.0, 0.0, NULL, 0},
+	{"evening", 2000, 0.0, 0.0, NULL, 0},
+	{"evening", 60000, 0.0, 0.0, "fade_transition", 1000},
+};
+
+#define SOAK_ITEMS ((int)(sizeof(soak_items) / sizeof(soak_items[0])))
+
+static const struct {
+	int mode;
+	const char *name;
+} soak_modes[] = {
+	{PLAYBACK_MODE_LIST, "list"},
+	{PLAYBACK_MODE_SECTION, "section"},
+	{PLAYBACK_MODE_SINGLE, "single"},
+	{PLAYBACK_MODE_SHUFFLE, "shuffle"},
+};
+
+struct soak_result {
+	DARRAY(int64_t) latency_us;
+	struct playout_switch_stats stats;
+	uint64_t switches;
+	uint64_t missed;
+	uint64_t skipped;
+	uint64_t doubled;
+	int64_t drift_us;
+};
+
+static FILE *soak_output;
+
+/* furthest media time the on air decoder played to */
+static obs_source_t *soak_tracked;
+static double soak_played_ms;
+/* out-point of the on air decoder and the wall clock time it got there, 0 before */
+static double soak_out_ms;
+static uint64_t soak_out_ns;
+
+static void soak_media_tick(obs_source_t *source, double from_ms, double to_ms, void *param)
+{
+	UNUSED_PARAMETER(param);
+	if (source != soak_tracked)
+		return;
+	if (to_ms > soak_played_ms)
+		soak_played_ms = to_ms;
+	/* the tick plays the frame before now, the end of the file clamps to_ms */
+	if (!soak_out_ns && to_ms >= soak_out_ms)
+		soak_out_ns = mock_obs_time() - mock_obs_frame_ns() + (uint64_t)((soak_out_ms - from_ms) * 1000000.0);
+}
+
+static void soak_path(struct dstr *path, int i)
+{
+	dstr_printf(path, "/media/soak/item%d.mp4", i);
+}
+
+static obs_source_t *soak_create(int mode, bool loop, bool autoplay)
+{
+	obs_data_t *settings = obs_data_create();
+	obs_data_set_int(settings, "playback_mode", mode);
+	obs_data_set_bool(settings, "loop", loop);
+	obs_data_set_bool(settings, "autoplay", autoplay);
+	struct dstr name;
+	dstr_init(&name);
+	struct dstr path;
+	dstr_init(&path);
+	for (int i = 0; i < SOAK_ITEMS; i++) {
+		const struct soak_item *item = &soak_items[i];
+		soak_path(&path, i);
+		mock_media_set_duration(path.array, item->duration_ms);
+		dstr_printf(&name, "path%d", i);
+		obs_data_set_string(settings, name.array, path.array);
+		dstr_printf(&name, "section%d", i);
+		obs_data_set_string(settings, name.array, item->section);
+		dstr_printf(&name, "start%d", i);
+		obs_data_set_double(settings, name.array, item->start);
+		dstr_printf(&name, "end%d", i);
+		obs_data_set_double(settings, name.array, item->end);
+		if (item->transition) {
+			dstr_printf(&name, "transition%d", i);
+			obs_data_set_string(settings, name.array, item->transition);
+			dstr_printf(&name, "transition_duration%d", i);
+			obs_data_set_int(settings, name.array, item->transition_ms);
+		}
+	}
+	dstr_free(&path);
+	dstr_free(&name);
+	obs_source_t *source = obs_source_create("playout_source", "Playout soak", settings, NULL);
+	obs_data_release(settings);
+	return source;
+}
+
+/* the item the playlist order puts after index, -1 when the harness can not know */
+static int soak_expected_next(int mode, bool loop, int index)
+{
+	if (mode == PLAYBACK_MODE_LIST)
+		return index < SOAK_ITEMS - 1 ? index + 1 : (loop ? 0 : -1);
+	if (mode == PLAYBACK_MODE_SECTION) {
+		if (index < SOAK_ITEMS - 1 && strcmp(soak_items[index].section, soak_items[index + 1].section) == 0)
+			return index + 1;
+		if (!loop)
+			return -1;
+		while (index > 0 && strcmp(soak_items[index].section, soak_items[index - 1].section) == 0)
+			index--;
+		return index;
+	}
+	if (mode == PLAYBACK_MODE_SINGLE)
+		return loop ? index : -1;
+	return -1;
+}
+
+/* media time of the out-point, the transition lead and the end trim before the end of the file */
+static double soak_out_point(int index)
+{
+	const struct soak_item *item = &soak_items[index];
+	return (double)item->duration_ms + item->end * 1000.0 - (item->transition ? item->transition_ms : 0);
+}
+
+static int soak_compare(const void *a, const void *b)
+{
+	int64_t x = *(const int64_t *)a;
+	int64_t y = *(const int64_t *)b;
+	return x < y ? -1 : x > y;
+}
+
+static void soak_run(int mode, const char *mode_name, bool loop, bool autoplay, double hours, struct soak_result *result)
+{
+	memset(result, 0, sizeof(*result));
+	obs_source_t *source = soak_create(mode, loop, autoplay);
+	struct playout_source_context *playout = obs_obj_get_data(source);
+	obs_scene_t *scene = mock_obs_create_scene("Soak scene");
+	obs_scene_add(scene, source);
+	obs_set_output_source(0, obs_scene_get_source(scene));
+	/* without autoplay the operator starts the playout */
+	if (!autoplay)
+		obs_source_media_play_pause(source, false);
+
+	uint64_t frame_ns = mock_obs_frame_ns();
+	uint64_t frames = (uint64_t)(hours * 3600.0 * 1000000000.0 / (double)frame_ns);
+	int on_air = -1;
+	obs_source_t *on_air_source = NULL;
+	double last_time = 0.0;
+	soak_tracked = NULL;
+	for (uint64_t f = 0; f < frames; f++) {
+		mock_obs_video_tick();
+		int index = playout->current_source_index;
+		obs_source_t *current = playout->current_source;
+		if (index < 0 || !current || !mock_media_is_fake(current))
+			continue;
+		double time = mock_media_get_time_exact(current);
+		/* a loop in single mode only shows as the media time going back */
+		bool restarted = index == on_air && current == on_air_source && time + 1.0 < last_time;
+		last_time = time;
+		if (index == on_air && current == on_air_source && !restarted)
+			continue;
+		uint64_t now = mock_obs_time();
+		if (on_air >= 0) {
+			/* the outgoing item was on air up to the frame before this one */
+			int64_t latency = soak_out_ns ? (int64_t)(now - frame_ns - soak_out_ns) / 1000
+						      : (int64_t)((soak_played_ms - soak_out_ms) * 1000.0);
+			da_push_back(result->latency_us, &latency);
+			result->switches++;
+			if (latency > (int64_t)(frame_ns / 1000))
+				result->missed++;
+			result->drift_us += latency;
+			int expected = soak_expected_next(mode, loop, on_air);
+			if (expected >= 0 && index != expected) {
+				if (index == on_air)
+					result->doubled++;
+				else
+					result->skipped++;
+				blog(LOG_WARNING, "[Playout Soak] %s loop=%d autoplay=%d: item %d after item %d, expected item %d",
+				     mode_name, loop, autoplay, index + 1, on_air + 1, expected + 1);
+			} else if (expected < 0 && mode != PLAYBACK_MODE_SHUFFLE) {
+				result->skipped++;
+				blog(LOG_WARNING, "[Playout Soak] %s loop=%d autoplay=%d: item %d after the last item %d",
+				     mode_name, loop, autoplay, index + 1, on_air + 1);
+			}
+		}
+		on_air = index;
+		on_air_source = current;
+		soak_tracked = current;
+		soak_played_ms = time;
+		soak_out_ms = soak_out_point(index);
+		soak_out_ns = 0;
+	}
+	soak_tracked = NULL;
+
+	result->stats = playout->stats;
+	obs_set_output_source(0, NULL);
+	obs_scene_release(scene);
+	obs_source_release(source);
+}
+
+static void soak_report(const char *mode_name, bool loop, bool autoplay, double hours, struct soak_result *result)
+{
+	struct playout_switch_stats *stats = &result->stats;
+	int64_t *l = result->latency_us.array;
+	size_t n = result->latency_us.num;
+	if (n)
+		qsort(l, n, sizeof(int64_t), soak_compare);
+	struct dstr line;
+	dstr_init(&line);
+	dstr_printf(&line,
+		    "{\"mode\":\"%s\",\"loop\":%s,\"autoplay\":%s,\"hours\":%.2f,\"switches\":%llu,"
+		    "\"latency_ms\":{\"min\":%.3f,\"p50\":%.3f,\"p99\":%.3f,\"max\":%.3f},"
+		    "\"missed\":%llu,\"drift_ms\":%.3f,\"skipped\":%llu,\"doubled\":%llu,"
+		    "\"source\":{\"switches\":%llu,\"missed\":%llu,\"cut_short\":%llu,\"skipped\":%llu,\"doubled\":%llu,"
+		    "\"drift_ms\":%lld}}",
+		    mode_name, loop ? "true" : "false", autoplay ? "true" : "false", hours, (unsigned long long)result->switches,
+		    n ? l[0] / 1000.0 : 0.0, n ? l[n / 2] / 1000.0 : 0.0, n ? l[(n * 99) / 100] / 1000.0 : 0.0,
+		    n ? l[n - 1] / 1000.0 : 0.0, (unsigned long long)result->missed, result->drift_us / 1000.0,
+		    (unsigned long long)result->skipped, (unsigned long long)result->doubled, (unsigned long long)stats->switches,
+		    (unsigned long long)stats->missed, (unsigned long long)stats->early, (unsigned long long)stats->skipped,
+		    (unsigned long long)stats->doubled, (long long)stats->late_total_ms);
+	printf("%s\n", line.array);
+	if (soak_output)
+		fprintf(soak_output, "%s\n", line.array);
+	dstr_free(&line);
+}
+
+int main(int argc, char **argv)
+{
+	double hours = 24.0;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--hours") == 0 && i + 1 < argc) {
+			hours = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+			soak_output = fopen(argv[++i], "w");
+		} else {
+			fprintf(stderr, "usage: %s [--hours h] [--output file]\n", argv[0]);
+			return 1;
+		}
+	}
+	setvbuf(stdout, NULL, _IOLBF, 0);
+	mock_obs_startup(MOCK_CONFIG_DIR);
+	obs_module_load();
+	mock_media_set_tick_callback(soak_media_tick, NULL);
+	int failed = 0;
+	for (size_t m = 0; m < sizeof(soak_modes) / sizeof(soak_modes[0]); m++) {
+		for (int loop = 1; loop >= 0; loop--) {
+			for (int autoplay = 1; autoplay >= 0; autoplay--) {
+				struct soak_result result;
+				soak_run(soak_modes[m].mode, soak_modes[m].name, loop, autoplay, hours, &result);
+				soak_report(soak_modes[m].name, loop, autoplay, hours, &result);
+				if (result.skipped || result.doubled || result.missed ||
+				    (result.switches && llabs(result.drift_us) / (int64_t)result.switches > (int64_t)(mock_obs_frame_ns() / 1000)))
+					failed = 1;
+				da_free(result.latency_us);
+			}
+		}
+	}
+	obs_module_unload();
+	mock_obs_shutdown();
+	if (soak_output)
+		fclose(soak_output);
+	return failed;
+}
@@ -0,0 +1,106 @@
+#include "timer-wheel.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_RANGE (1ULL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+
+static void timer_wheel_insert(struct timer_wheel *wheel, struct timer_wheel_entry *entry, uint64_t earliest)
+{
+	uint64_t expires = entry->expires > earliest ? entry->expires : earliest;
+	if (expires - wheel->now >= TIMER_WHEEL_RANGE)
+		expires = wheel->now + TIMER_WHEEL_RANGE - 1;
+	uint64_t delta = expires - wheel->now;
+	int level = 0;
+	while (level < TIMER_WHEEL_LEVELS - 1 && delta >= 1ULL << (TIMER_WHEEL_BITS * (level + 1)))
+		level++;
+	size_t slot = (size_t)(expires >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+	entry->next = wheel->slots[level][slot];
+	wheel->slots[level][slot] = entry;
+	if (!level)
+		wheel->occupied |= 1ULL << slot;
+}
+
+static int timer_wheel_lowest_bit(uint64_t bits)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, bits);
+	return (int)index;
+#else
+	return __builtin_ctzll(bits);
+#endif
+}
+
+void timer_wheel_reset(struct timer_wheel *wheel, uint64_t now)
+{
+	memset(wheel->slots, 0, sizeof(wheel->slots));
+	wheel->count = 0;
+	wheel->occupied = 0;
+	wheel->now = now;
+}
+
+void timer_wheel_add(struct timer_wheel *wheel, struct timer_wheel_entry *entry, uint64_t expires, void *data)
+{
+	entry->expires = expires;
+	entry->data = data;
+	wheel->count++;
+	timer_wheel_insert(wheel, entry, wheel->now + 1);
+}
+
+static void timer_wheel_cascade(struct timer_wheel *wheel)
+{
+	for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+		int shift = TIMER_WHEEL_BITS * level;
+		if (wheel->now & ((1ULL << shift) - 1))
+			break;
+		size_t slot = (size_t)(wheel->now >> shift) & TIMER_WHEEL_MASK;
+		struct timer_wheel_entry *entry = wheel->slots[level][slot];
+		wheel->slots[level][slot] = NULL;
+		while (entry) {
+			struct timer_wheel_entry *next = entry->next;
+			timer_wheel_insert(wheel, entry, wheel->now);
+			entry = next;
+		}
+	}
+}
+
+/* Jumps to the next occupied level 0 slot or the next cascade, whichever
+ * comes first, and straight to now once the wheel is empty. The cost per call
+ * depends on the cascades passed and the entries that fire, not on how many
+ * entries are waiting or how many milliseconds passed between them. */
+void timer_wheel_advance(struct timer_wheel *wheel, uint64_t now, timer_wheel_fire_t fire, void *param)
+{
+	while (wheel->now < now) {
+		if (!wheel->count) {
+			wheel->now = now;
+			break;
+		}
+		uint64_t next = wheel->now + 1;
+		if (next & TIMER_WHEEL_MASK) {
+			uint64_t bits = wheel->occupied >> (next & TIMER_WHEEL_MASK);
+			next = bits ? next + (uint64_t)timer_wheel_lowest_bit(bits) : (wheel->now | TIMER_WHEEL_MASK) + 1;
+			if (next > now) {
+				wheel->now = now;
+				break;
+			}
+		}
+		wheel->now = next;
+		timer_wheel_cascade(wheel);
+		size_t slot = (size_t)wheel->now & TIMER_WHEEL_MASK;
+		struct timer_wheel_entry *entry = wheel->slots[0][slot];
+		wheel->slots[0][slot] = NULL;
+		wheel->occupied &= ~(1ULL << slot);
+		while (entry) {
+			struct timer_wheel_entry *next_entry = entry->next;
+			if (entry->expires <= wheel->now) {
+				wheel->count--;
+				fire(param, entry->data);
+			} else {
+				timer_wheel_insert(wheel, entry, wheel->now);
+			}
+			entry = next_entry;
+		}
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <obs.h>
+
+/* five levels of 64 slots at 1 ms resolution cover about 12 days,
+ * entries further out wait in the last level and are placed again */
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 5
+
+struct timer_wheel_entry {
+	struct timer_wheel_entry *next;
+	uint64_t expires;
+	void *data;
+};
+
+struct timer_wheel {
+	uint64_t now;
+	size_t count;
+	/* one bit per level 0 slot that holds entries */
+	uint64_t occupied;
+	struct timer_wheel_entry *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+};
+
+typedef void (*timer_wheel_fire_t)(void *param, void *data);
+
+void timer_wheel_reset(struct timer_wheel *wheel, uint64_t now);
+void timer_wheel_add(struct timer_wheel *wheel, struct timer_wheel_entry *entry, uint64_t expires, void *data);
+void timer_wheel_advance(struct timer_wheel *wheel, uint64_t now, timer_wheel_fire_t fire, void *param);
@@ -0,0 +1,128 @@
+#include "trace.h"
+#include <obs-module.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+#ifdef _MSC_VER
+#define TRACE_THREAD_LOCAL __declspec(thread)
+#else
+#define TRACE_THREAD_LOCAL __thread
+#endif
+
+#define TRACE_RING_SIZE 4096
+
+/* seq is the count the event was written at plus one, 0 while it is written,
+ * so a dump only keeps copies that were not overwritten while copying */
+struct trace_event {
+	volatile long seq;
+	const char *name;
+	uint64_t start;
+	uint64_t end;
+};
+
+struct trace_ring {
+	long tid;
+	volatile long count;
+	struct trace_event events[TRACE_RING_SIZE];
+};
+
+volatile bool trace_enabled = false;
+
+static struct {
+	pthread_mutex_t mutex;
+	DARRAY(struct trace_ring *) rings;
+	long next_tid;
+	volatile long generation;
+} trace;
+
+/* the ring of a thread is only used while it belongs to the current
+ * generation, trace_free frees all rings and starts a new one */
+static TRACE_THREAD_LOCAL struct trace_ring *thread_ring = NULL;
+static TRACE_THREAD_LOCAL long thread_generation = 0;
+
+void trace_init(void)
+{
+	pthread_mutex_init(&trace.mutex, NULL);
+}
+
+void trace_free(void)
+{
+	os_atomic_set_bool(&trace_enabled, false);
+	pthread_mutex_lock(&trace.mutex);
+	os_atomic_inc_long(&trace.generation);
+	for (size_t i = 0; i < trace.rings.num; i++)
+		bfree(trace.rings.array[i]);
+	da_free(trace.rings);
+	pthread_mutex_unlock(&trace.mutex);
+	pthread_mutex_destroy(&trace.mutex);
+}
+
+void trace_record(const char *name, uint64_t start, uint64_t end)
+{
+	long generation = os_atomic_load_long(&trace.generation);
+	struct trace_ring *ring = thread_generation == generation ? thread_ring : NULL;
+	if (!ring) {
+		ring = bzalloc(sizeof(struct trace_ring));
+		pthread_mutex_lock(&trace.mutex);
+		ring->tid = ++trace.next_tid;
+		da_push_back(trace.rings, &ring);
+		pthread_mutex_unlock(&trace.mutex);
+		thread_ring = ring;
+		thread_generation = generation;
+	}
+	long count = os_atomic_load_long(&ring->count);
+	struct trace_event *event = &ring->events[count % TRACE_RING_SIZE];
+	os_atomic_set_long(&event->seq, 0);
+	event->name = name;
+	event->start = start;
+	event->end = end;
+	os_atomic_set_long(&event->seq, count + 1);
+	os_atomic_set_long(&ring->count, count + 1);
+}
+
+char *trace_dump(void)
+{
+	char *file = os_generate_formatted_filename("json", false, "playout-trace-%CCYY-%MM-%DD %hh-%mm-%ss");
+	char *dir = obs_module_config_path("traces");
+	os_mkdirs(dir);
+	struct dstr path;
+	dstr_init(&path);
+	dstr_printf(&path, "%s/%s", dir, file);
+	bfree(file);
+	bfree(dir);
+
+	struct dstr json;
+	dstr_init_copy(&json, "{\"traceEvents\":[");
+	bool first = true;
+	pthread_mutex_lock(&trace.mutex);
+	for (size_t i = 0; i < trace.rings.num; i++) {
+		struct trace_ring *ring = trace.rings.array[i];
+		long count = os_atomic_load_long(&ring->count);
+		long begin = count > TRACE_RING_SIZE ? count - TRACE_RING_SIZE : 0;
+		for (long n = begin; n < count; n++) {
+			struct trace_event *slot = &ring->events[n % TRACE_RING_SIZE];
+			long seq = os_atomic_load_long(&slot->seq);
+			struct trace_event event = *slot;
+			if (seq != n + 1 || os_atomic_load_long(&slot->seq) != seq)
+				continue;
+			dstr_catf(&json, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%ld,\"ts\":%.3f,\"dur\":%.3f}",
+				  first ? "" : ",", event.name, ring->tid, (double)event.start / 1000.0,
+				  (double)(event.end - event.start) / 1000.0);
+			first = false;
+		}
+	}
+	pthread_mutex_unlock(&trace.mutex);
+	dstr_cat(&json, "]}");
+
+	bool success = os_quick_write_utf8_file(path.array, json.array, json.len, false);
+	dstr_free(&json);
+	if (!success) {
+		blog(LOG_WARNING, "[Playout Source] failed to write trace '%s'", path.array);
+		dstr_free(&path);
+		return NULL;
+	}
+	blog(LOG_INFO, "[Playout Source] trace written to '%s'", path.array);
+	return path.array;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <obs.h>
+#include <util/platform.h>
+
+extern volatile bool trace_enabled;
+
+void trace_init(void);
+void trace_free(void);
+void trace_record(const char *name, uint64_t start, uint64_t end);
+char *trace_dump(void);
+
+static inline uint64_t trace_begin(void)
+{
+	return trace_enabled ? os_gettime_ns() : 0;
+}
+
+static inline void trace_end(const char *name, uint64_t start)
+{
+	if (start)
+		trace_record(name, start, os_gettime_ns());
+}